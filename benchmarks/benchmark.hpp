@@ -0,0 +1,37 @@
+/**
+ * @file benchmark.hpp
+ * @brief Minimal timing helpers shared by the benchmark executables.
+ */
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace wseml::bench {
+
+    /**
+     * @brief Prevents the compiler from optimizing away a computed value.
+     */
+    template <typename T>
+    inline void doNotOptimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * @brief Runs @p fn @p iterations times and prints the average time per iteration.
+     * @return Average time per iteration in nanoseconds.
+     */
+    template <typename Fn>
+    double measure(const std::string& name, std::size_t iterations, Fn&& fn) {
+        fn();
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; i++) {
+            fn();
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        double perIteration = elapsed / static_cast<double>(iterations);
+        std::printf("%-48s %14.1f ns/iter\n", name.c_str(), perIteration);
+        return perIteration;
+    }
+
+} // namespace wseml::bench
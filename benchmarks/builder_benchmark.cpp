@@ -0,0 +1,65 @@
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/builder.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    using Source = std::vector<std::pair<WSEML, WSEML>>;
+
+    Source makeSource(std::size_t entries) {
+        Source source;
+        source.reserve(entries);
+        for (std::size_t i = 0; i < entries; i++) {
+            source.emplace_back(WSEML("key" + std::to_string(i)), WSEML("value" + std::to_string(i)));
+        }
+        return source;
+    }
+
+    /* a load moves the pairs out of a fresh source; the sources and results are prepared and destroyed unmeasured */
+    template <class Load>
+    double measureLoad(const char* name, std::size_t entries, Load&& load) {
+        std::vector<Source> sources;
+        sources.push_back(makeSource(entries));
+        sources.push_back(makeSource(entries));
+        std::vector<WSEML> results;
+        results.reserve(sources.size());
+        return bench::measure(name, 1, [&]() { results.push_back(load(sources[results.size()])); });
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t entries = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    std::printf("AA of %zu entries\n", entries);
+
+    double single = measureLoad("  addKeyValueAssociationToAA", entries, [](Source& source) {
+        WSEML aa = createAssociativeArray();
+        for (auto& [key, value] : source) {
+            addKeyValueAssociationToAA(aa, std::move(key), std::move(value));
+        }
+        return aa;
+    });
+    double unsorted = measureLoad("  AABuilder, unsorted", entries, [](Source& source) {
+        AABuilder builder;
+        builder.add(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+        return builder.finish();
+    });
+    double sorted = measureLoad("  AABuilder, sorted", entries, [](Source& source) {
+        AABuilder builder(KeyOrder::Sorted);
+        builder.add(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+        return builder.finish();
+    });
+    double block = measureLoad("  BlockBuilder", entries, [](Source& source) {
+        BlockBuilder builder;
+        builder.add(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+        return builder.finish();
+    });
+    std::printf("  speedup %.1fx unsorted, %.1fx sorted, %.1fx block\n", single / unsorted, single / sorted, single / block);
+    return 0;
+}
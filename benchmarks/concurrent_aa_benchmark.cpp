@@ -0,0 +1,97 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/concurrentAA.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    constexpr std::size_t BLOCKS = 16;
+    constexpr std::size_t KEYS_PER_BLOCK = 256;
+    constexpr std::size_t LOOKUPS = 50000;
+
+    WSEML makeKey(std::size_t i) {
+        return WSEML("key" + std::to_string(i));
+    }
+
+    /* readers share LOOKUPS lookups while one writer opens and closes a scope every 50 microseconds */
+    template <typename Read, typename Write>
+    double run(std::size_t threads, const std::vector<WSEML>& keys, Read read, Write write) {
+        std::atomic<bool> stop = false;
+        std::thread writer([&]() {
+            for (std::size_t round = 0; not stop; round++) {
+                write(keys[round % keys.size()]);
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        });
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> readers;
+        for (std::size_t t = 0; t < threads; t++) {
+            readers.emplace_back([&, t]() {
+                for (std::size_t i = t; i < LOOKUPS; i += threads) {
+                    WSEML value = read(keys[(i * 7919) % keys.size()]);
+                    bench::doNotOptimize(value);
+                }
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stop = true;
+        writer.join();
+        return static_cast<double>(LOOKUPS) / seconds / 1e3;
+    }
+} // namespace
+
+int main() {
+    std::vector<WSEML> keys;
+    WSEML aa = createAssociativeArray();
+    for (std::size_t block = 0; block < BLOCKS; block++) {
+        WSEML newBlock = createBlock();
+        for (std::size_t i = 0; i < KEYS_PER_BLOCK; i++) {
+            keys.push_back(makeKey(block * KEYS_PER_BLOCK + i));
+            addKeyValueAssociationToBlock(newBlock, keys.back(), WSEML("value" + std::to_string(i)));
+        }
+        /* give the single-lock baseline its best single-threaded lookup */
+        enableKeyFilter(newBlock, KEYS_PER_BLOCK);
+        appendBlock(aa, newBlock);
+    }
+    ConcurrentAA concurrent(aa);
+    std::mutex globalMutex;
+
+    std::printf("%zu blocks of %zu keys, %zu lookups shared by the readers, one writer (%u hardware threads)\n", BLOCKS, KEYS_PER_BLOCK,
+                LOOKUPS, std::thread::hardware_concurrency());
+    std::printf("%8s %26s %26s\n", "readers", "global mutex, klookups/s", "ConcurrentAA, klookups/s");
+    for (std::size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+        double locked = run(
+            threads, keys,
+            [&](const WSEML& key) {
+                std::lock_guard lock(globalMutex);
+                const WSEML* value = findValuePtrInAA(aa, key);
+                return value != nullptr ? *value : NULLOBJ;
+            },
+            [&](const WSEML& key) {
+                std::lock_guard lock(globalMutex);
+                appendBlock(aa, createBlock());
+                addKeyValueAssociationToAA(aa, key, WSEML("scoped"));
+                popBlock(aa);
+            });
+        double sharded = run(
+            threads, keys, [&](const WSEML& key) { return concurrent.findValue(key); },
+            [&](const WSEML& key) {
+                concurrent.pushBlock();
+                concurrent.insert(key, WSEML("scoped"));
+                concurrent.popBlock();
+            });
+        std::printf("%8zu %26.1f %26.1f\n", threads, locked, sharded);
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/factStore.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    WSEML makeFact(std::size_t i) {
+        WSEML fact = createAssociativeArray();
+        addKeyValueAssociationToAA(fact, WSEML("id"), WSEML(std::to_string(i)));
+        addKeyValueAssociationToAA(fact, WSEML("group"), WSEML(std::to_string(i % 100)));
+        addKeyValueAssociationToAA(fact, WSEML("payload"), WSEML("payload" + std::to_string(i)));
+        return fact;
+    }
+} // namespace
+
+int main() {
+    WSEML pattern = createAssociativeArray();
+    addKeyValueAssociationToAA(pattern, WSEML("group"), WSEML("42"));
+    addKeyValueAssociationToAA(pattern, WSEML("payload"), createPlaceholder("p"));
+
+    for (std::size_t count : {1000, 10000}) {
+        std::vector<WSEML> facts;
+        FactStore store;
+        for (std::size_t i = 0; i < count; i++) {
+            facts.push_back(makeFact(i));
+            store.add(makeFact(i));
+        }
+        std::printf("facts %zu\n", count);
+
+        double linear = bench::measure("  unify against every fact", 3, [&]() {
+            std::size_t matches = 0;
+            for (const WSEML& fact : facts) {
+                matches += unify(fact, pattern).first != NULLOBJ;
+            }
+            bench::doNotOptimize(matches);
+        });
+        double indexed = bench::measure("  FactStore::query", 3, [&]() {
+            std::vector<FactMatch> matches = store.query(pattern);
+            bench::doNotOptimize(matches.size());
+        });
+        std::printf("  speedup %.1fx\n", linear / indexed);
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <cstdio>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/hashCons.hpp"
+#include "../include/lists.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    const std::vector<const WSEML*> PROGRAMS = {&assignList, &additionList, &subtractionList, &multiplicationList, &divisionList,
+                                                &remainderList, &powerList, &concatList, &isEqList, &isNeqList, &isLessList,
+                                                &isGreaterList, &isLeqList, &isGeqList, &logicAndList, &logicOrList, &logicNotList,
+                                                &insertList, &eraseList, &callList, &ifList, &forkList};
+
+    /* the operands of every instruction of the programs in a document, e.g. the pointer descriptors repeated throughout
+       them */
+    std::vector<const WSEML*> collectOperands(const WSEML& document) {
+        std::vector<const WSEML*> operands;
+        for (const Pair& program : document.getInnerList()) {
+            for (const Pair& instruction : program.getData().getInnerList()) {
+                if (instruction.getData().structureTypeInfo() != StructureType::List) {
+                    continue;
+                }
+                for (const Pair& operand : instruction.getData().getInnerList()) {
+                    operands.push_back(&operand.getData());
+                }
+            }
+        }
+        return operands;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    int iters = argc > 1 ? std::stoi(argv[1]) : 10;
+
+    WSEML document = WSEML(std::list<Pair>());
+    for (const WSEML* program : PROGRAMS) {
+        document.append(*program);
+    }
+    std::size_t copiedBytes = footprint(document);
+
+    HashConsTable table;
+    FrozenWSEML interned = table.intern(document);
+    HashConsStats stats = table.stats();
+    std::printf("%zu subtrees, %zu distinct\n", stats.interned, stats.distinct);
+    std::printf("  copies %zu bytes, hash-consed %zu bytes (%zu saved, %zu in shared nodes)\n", copiedBytes, footprint(*interned),
+                stats.bytesSaved, stats.overheadBytes);
+
+    /* pairs of equal operands at different places: separately frozen copies compare by value, hash-consed by pointer */
+    std::vector<const WSEML*> operands = collectOperands(*interned);
+    std::vector<FrozenWSEML> frozen;
+    for (const WSEML* operand : collectOperands(document)) {
+        frozen.push_back(freeze(*operand));
+    }
+    std::vector<std::pair<std::size_t, std::size_t>> equalPairs;
+    for (std::size_t i = 0; i < operands.size(); i++) {
+        for (std::size_t j = i + 1; j < operands.size(); j++) {
+            if (operands[i]->isShared() and operands[i]->getSharedNode() == operands[j]->getSharedNode()) {
+                equalPairs.emplace_back(i, j);
+            }
+        }
+    }
+    std::printf("%zu pairs of equal operands\n", equalPairs.size());
+    double deep = bench::measure("  by value (freeze)", iters, [&]() {
+        std::size_t matches = 0;
+        for (auto [i, j] : equalPairs) {
+            matches += frozen[i] == frozen[j];
+        }
+        bench::doNotOptimize(matches);
+    });
+    double consed = bench::measure("  by pointer (HashConsTable)", iters, [&]() {
+        std::size_t matches = 0;
+        for (auto [i, j] : equalPairs) {
+            matches += *operands[i] == *operands[j];
+        }
+        bench::doNotOptimize(matches);
+    });
+    std::printf("  speedup %.1fx\n", deep / consed);
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <cstdio>
+#include <string>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    WSEML makeLargeValue(std::size_t size) {
+        WSEML value = WSEML(std::list<Pair>());
+        for (std::size_t i = 0; i < size; i++) {
+            value.append(WSEML("element" + std::to_string(i)));
+        }
+        return value;
+    }
+
+    WSEML makeAA(std::size_t keys, std::size_t valueSize) {
+        WSEML aa = createAssociativeArray();
+        for (std::size_t i = 0; i < keys; i++) {
+            addKeyValueAssociationToAA(aa, WSEML("key" + std::to_string(i)), makeLargeValue(valueSize));
+        }
+        return aa;
+    }
+} // namespace
+
+int main() {
+    for (std::size_t valueSize : {1, 100, 10000}) {
+        WSEML aa = makeAA(64, valueSize);
+        WSEML key("key32");
+        std::size_t iterations = valueSize >= 10000 ? 200 : 20000;
+        std::printf("value size %zu\n", valueSize);
+
+        double copying = bench::measure("  findValueInAA", iterations, [&]() {
+            WSEML value = findValueInAA(aa, key);
+            bench::doNotOptimize(value);
+        });
+        double pointer = bench::measure("  findValuePtrInAA", iterations, [&]() {
+            const WSEML* value = findValuePtrInAA(aa, key);
+            bench::doNotOptimize(value);
+        });
+
+        const WSEML& assoc = getAssociationsFromBlock(getBlocksFromAA(aa).front().getData()).front().getData();
+        bench::measure("  getKey/ValueFromAssociation", iterations, [&]() {
+            const WSEML& storedKey = getKeyFromAssociation(assoc);
+            const WSEML& storedValue = getValueFromAssociation(assoc);
+            bench::doNotOptimize(&storedKey);
+            bench::doNotOptimize(&storedValue);
+        });
+        std::printf("  speedup %.1fx\n", copying / pointer);
+    }
+
+    /* misses walk every block unless key filters rule the blocks out */
+    WSEML layered = createAssociativeArray();
+    for (std::size_t block = 0; block < 32; block++) {
+        WSEML newBlock = createBlock();
+        for (std::size_t i = 0; i < 32; i++) {
+            addKeyValueAssociationToBlock(newBlock, WSEML("key" + std::to_string(block) + "_" + std::to_string(i)), WSEML("value"));
+        }
+        appendBlock(layered, newBlock);
+    }
+    WSEML missingKey("missing");
+    std::printf("32 blocks of 32 keys, missing key\n");
+    double unfiltered = bench::measure("  findValuePtrInAA", 2000, [&]() {
+        const WSEML* value = findValuePtrInAA(layered, missingKey);
+        bench::doNotOptimize(value);
+    });
+    for (Pair& block : layered.getList()) {
+        enableKeyFilter(block.getData(), 32);
+    }
+    double filtered = bench::measure("  findValuePtrInAA, key filters", 2000, [&]() {
+        const WSEML* value = findValuePtrInAA(layered, missingKey);
+        bench::doNotOptimize(value);
+    });
+    std::printf("  speedup %.1fx\n", unfiltered / filtered);
+
+    /* the functional fallback of findValueInAA: the trigger of the bottom block is the worst case for a scan */
+    WSEML functional = createAssociativeArray();
+    for (std::size_t block = 0; block < 32; block++) {
+        WSEML newBlock = createBlock();
+        for (std::size_t i = 0; i < 8; i++) {
+            WSEML trigger("type" + std::to_string(block) + "_" + std::to_string(i));
+            addFunctionalAssociationToBlock(newBlock, createFunctionalAssociation(trigger, createFunctionReference("./lib.so", "f")));
+        }
+        appendBlock(functional, newBlock);
+    }
+    WSEML bottomTrigger("type0_7");
+    std::printf("32 blocks of 8 functional associations, bottom trigger\n");
+    enableTriggerIndex(functional);
+    double indexed = bench::measure("  findFunctionalAssociationInAA, trigger index", 20000, [&]() {
+        const WSEML* funcAssoc = findFunctionalAssociationInAA(functional, bottomTrigger);
+        bench::doNotOptimize(funcAssoc);
+    });
+    disableTriggerIndex(functional);
+    double scanned = bench::measure("  findFunctionalAssociationInAA, scan", 2000, [&]() {
+        const WSEML* funcAssoc = findFunctionalAssociationInAA(functional, bottomTrigger);
+        bench::doNotOptimize(funcAssoc);
+    });
+    std::printf("  speedup %.1fx\n", scanned / indexed);
+
+    /* a long-running AA: every block rebinds the same keys, so old blocks are almost entirely shadowed */
+    WSEML shadowed = createAssociativeArray();
+    for (std::size_t block = 0; block < 256; block++) {
+        WSEML newBlock = createBlock();
+        for (std::size_t i = 0; i < 64; i++) {
+            addKeyValueAssociationToBlock(newBlock, WSEML("key" + std::to_string((block + i) % 128)), WSEML("value" + std::to_string(block)));
+        }
+        appendBlock(shadowed, newBlock);
+    }
+    WSEML absentKey("missing");
+    WSEML uncompacted = shadowed;
+    std::printf("256 blocks rebinding 128 keys, missing key\n");
+    double deepLookup = bench::measure("  findValuePtrInAA", 20, [&]() {
+        const WSEML* value = findValuePtrInAA(uncompacted, absentKey);
+        bench::doNotOptimize(value);
+    });
+    double deepMerge = bench::measure("  merge", 20, [&]() {
+        WSEML merged = merge(uncompacted);
+        bench::doNotOptimize(merged);
+    });
+    CompactionStats stats = compactAA(shadowed, 1);
+    std::printf("  compactAA: %zu blocks and %zu associations removed, %zu bytes reclaimed\n", stats.blocksRemoved,
+                stats.associationsRemoved, stats.bytesReclaimed);
+    double compactLookup = bench::measure("  findValuePtrInAA, compacted", 20, [&]() {
+        const WSEML* value = findValuePtrInAA(shadowed, absentKey);
+        bench::doNotOptimize(value);
+    });
+    double compactMerge = bench::measure("  merge, compacted", 20, [&]() {
+        WSEML merged = merge(shadowed);
+        bench::doNotOptimize(merged);
+    });
+    std::printf("  speedup %.1fx lookup, %.1fx merge\n", deepLookup / compactLookup, deepMerge / compactMerge);
+    return 0;
+}
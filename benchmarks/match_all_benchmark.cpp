@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/patternMatcher.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    WSEML makeStorage(std::size_t keys, std::size_t seed) {
+        WSEML storage = createAssociativeArray();
+        for (std::size_t i = 0; i < keys; i++) {
+            addKeyValueAssociationToAA(storage, WSEML("key" + std::to_string(i)), WSEML("value" + std::to_string((i + seed) % 4)));
+        }
+        return storage;
+    }
+
+    WSEML makePattern() {
+        WSEML pattern = createAssociativeArray();
+        addKeyValueAssociationToAA(pattern, WSEML("key1"), createPlaceholder("a"));
+        addKeyValueAssociationToAA(pattern, WSEML("key2"), WSEML("value2"));
+        addKeyValueAssociationToAA(pattern, WSEML("key3"), createPlaceholder("b"));
+        return pattern;
+    }
+} // namespace
+
+int main() {
+    WSEML pattern = makePattern();
+    std::vector<WSEML> storages;
+    for (std::size_t seed = 0; seed < 4096; seed++) {
+        storages.push_back(makeStorage(32, seed));
+    }
+    std::printf("%zu storages of 32 keys\n", storages.size());
+
+    double sequential = bench::measure("  PatternMatcher::match loop", 5, [&]() {
+        PatternMatcher matcher(pattern);
+        PatternMatcher::Scratch scratch;
+        for (const WSEML& storage : storages) {
+            WSEML result = matcher.match(storage, scratch);
+            bench::doNotOptimize(result);
+        }
+    });
+
+    std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        std::string name = "  matchAll, " + std::to_string(threads) + " threads";
+        double parallel = bench::measure(name, 5, [&]() {
+            std::vector<WSEML> results = matchAll(pattern, storages, pool);
+            bench::doNotOptimize(results);
+        });
+        std::printf("  speedup %.1fx\n", sequential / parallel);
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/patternMatcher.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    WSEML makeStorage(std::size_t keys, std::size_t seed) {
+        WSEML storage = createAssociativeArray();
+        for (std::size_t i = 0; i < keys; i++) {
+            addKeyValueAssociationToAA(storage, WSEML("key" + std::to_string(i)), WSEML("value" + std::to_string(i + seed)));
+        }
+        WSEML point = WSEML(std::list<Pair>());
+        point.append(WSEML(std::to_string(seed)), WSEML("x"));
+        point.append(WSEML("0"), WSEML("y"));
+        addKeyValueAssociationToAA(storage, WSEML("point"), std::move(point));
+        return storage;
+    }
+
+    WSEML makePattern() {
+        WSEML pattern = createAssociativeArray();
+        addKeyValueAssociationToAA(pattern, WSEML("key1"), createPlaceholder("a"));
+        addKeyValueAssociationToAA(pattern, WSEML("key2"), createPlaceholder("b"));
+        addKeyValueAssociationToAA(pattern, WSEML("key3"), ANPLACEHOLDER);
+        WSEML point = WSEML(std::list<Pair>());
+        point.append(createPlaceholder("x"), WSEML("x"));
+        point.append(WSEML("0"), WSEML("y"));
+        addKeyValueAssociationToAA(pattern, WSEML("point"), std::move(point));
+        return pattern;
+    }
+} // namespace
+
+int main() {
+    WSEML pattern = makePattern();
+    PatternMatcher matcher(pattern);
+    PatternMatcher::Scratch scratch;
+
+    for (std::size_t keys : {8, 64, 512}) {
+        std::vector<WSEML> storages;
+        for (std::size_t seed = 0; seed < 16; seed++) {
+            storages.push_back(makeStorage(keys, seed));
+        }
+        std::size_t iterations = keys >= 512 ? 50 : 500;
+        std::printf("storage keys %zu\n", keys);
+
+        std::size_t next = 0;
+        double generic = bench::measure("  matchAndSubstitute", iterations, [&]() {
+            WSEML result = matchAndSubstitute(storages[next++ % storages.size()], pattern);
+            bench::doNotOptimize(result);
+        });
+        double compiled = bench::measure("  PatternMatcher::match", iterations, [&]() {
+            WSEML result = matcher.match(storages[next++ % storages.size()], scratch);
+            bench::doNotOptimize(result);
+        });
+        std::printf("  speedup %.1fx\n", generic / compiled);
+    }
+    return 0;
+}
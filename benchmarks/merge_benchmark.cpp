@@ -0,0 +1,42 @@
+#include <cstdio>
+#include <string>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/workStealingPool.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    /* every block rebinds half of the keys of the block below it */
+    WSEML makeAA(std::size_t blocks, std::size_t keysPerBlock) {
+        WSEML aa = createAssociativeArray();
+        for (std::size_t block = 0; block < blocks; block++) {
+            WSEML newBlock = createBlock();
+            for (std::size_t i = 0; i < keysPerBlock; i++) {
+                std::size_t key = block * keysPerBlock / 2 + i;
+                addKeyValueAssociationToBlock(newBlock, WSEML("key" + std::to_string(key)), WSEML("value" + std::to_string(block)));
+            }
+            appendBlock(aa, newBlock);
+        }
+        return aa;
+    }
+} // namespace
+
+int main() {
+    WSEML aa = makeAA(32, 8192);
+    std::printf("32 blocks of 8192 keys, half of them shadowed\n");
+    double sequential = bench::measure("  merge", 3, [&]() {
+        WSEML merged = merge(aa);
+        bench::doNotOptimize(merged);
+    });
+    for (std::size_t threads : {1, 2, 4, 8}) {
+        WorkStealingPool pool(threads);
+        double parallel = bench::measure("  merge, " + std::to_string(threads) + " threads", 3, [&]() {
+            WSEML merged = merge(aa, pool);
+            bench::doNotOptimize(merged);
+        });
+        std::printf("  speedup %.1fx\n", sequential / parallel);
+    }
+    return 0;
+}
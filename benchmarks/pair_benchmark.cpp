@@ -0,0 +1,48 @@
+#include <cstdio>
+#include <functional>
+#include <string>
+#include "../include/WSEML.hpp"
+#include "../include/builder.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    /* a Block of key-value associations, the bulk of a typical Associative Array, with no roles set */
+    WSEML makeBlock(std::size_t entries) {
+        BlockBuilder builder;
+        builder.reserve(entries);
+        for (std::size_t i = 0; i < entries; i++) {
+            builder.add(WSEML("key" + std::to_string(i)), WSEML(std::to_string(i)));
+        }
+        return builder.finish();
+    }
+
+    /* a List of keyed pairs, as in a parsed document, with no roles set */
+    WSEML makeList(std::size_t entries) {
+        ListBuilder builder;
+        builder.reserve(entries);
+        for (std::size_t i = 0; i < entries; i++) {
+            builder.append(WSEML(std::to_string(i)), WSEML("key" + std::to_string(i)));
+        }
+        return builder.finish();
+    }
+
+    void measureCopyHashEqual(const char* name, const WSEML& object, int iters) {
+        std::printf("%s\n", name);
+        WSEML copy = object;
+        bench::measure("  copy", iters, [&]() { bench::doNotOptimize(WSEML(object)); });
+        bench::measure("  hash", iters, [&]() { bench::doNotOptimize(std::hash<WSEML>{}(object)); });
+        bench::measure("  equal", iters, [&]() { bench::doNotOptimize(equal(object, copy)); });
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t entries = argc > 1 ? std::stoul(argv[1]) : 500000;
+    int iters = argc > 2 ? std::stoi(argv[2]) : 10;
+    std::printf("sizeof(Pair) = %zu, sizeof(WSEML) = %zu, sizeof(ByteString) = %zu, sizeof(List) = %zu\n", sizeof(Pair), sizeof(WSEML),
+                sizeof(ByteString), sizeof(List));
+    measureCopyHashEqual("List of pairs", makeList(entries), iters);
+    measureCopyHashEqual("Block of key-value associations", makeBlock(entries), iters);
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include <cstdio>
+#include <string>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/parallelTraversal.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    /* rows of key-value pairs under a wide list, half of the rows being blocks */
+    WSEML makeTree(std::size_t rows, std::size_t columns) {
+        WSEML tree = WSEML(std::list<Pair>());
+        for (std::size_t row = 0; row < rows; row++) {
+            if (row % 2 == 0) {
+                WSEML block = createBlock();
+                for (std::size_t column = 0; column < columns; column++) {
+                    addKeyValueAssociationToBlock(block, WSEML("key" + std::to_string(column)), WSEML("value" + std::to_string(row)));
+                }
+                tree.append(block);
+            } else {
+                WSEML list = WSEML(std::list<Pair>());
+                for (std::size_t column = 0; column < columns; column++) {
+                    list.append(WSEML("value" + std::to_string(row * columns + column)), WSEML("key" + std::to_string(column)));
+                }
+                tree.append(list);
+            }
+        }
+        return tree;
+    }
+} // namespace
+
+int main() {
+    WSEML tree = makeTree(256, 1024);
+    WSEML copy = tree;
+    std::printf("256 rows of 1024 pairs\n");
+    double sequentialHash = bench::measure("  hash_value", 3, [&]() { bench::doNotOptimize(hash_value(tree)); });
+    double sequentialEqual = bench::measure("  equal", 3, [&]() { bench::doNotOptimize(equal(tree, copy)); });
+    for (std::size_t threads : {1, 2, 4, 8}) {
+        WorkStealingPool pool(threads);
+        std::string suffix = ", " + std::to_string(threads) + " threads";
+        double parallelHash = bench::measure("  parallelHashValue" + suffix, 3, [&]() {
+            bench::doNotOptimize(parallelHashValue(tree, pool, 64));
+        });
+        double parallelEq = bench::measure("  parallelEqual" + suffix, 3, [&]() {
+            bench::doNotOptimize(parallelEqual(tree, copy, pool, 64));
+        });
+        std::printf("  speedup %.1fx hash, %.1fx equal, %zu steals\n", sequentialHash / parallelHash, sequentialEqual / parallelEq,
+                    pool.getStealCount());
+    }
+    return 0;
+}
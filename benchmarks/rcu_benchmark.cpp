@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/versionedAA.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    constexpr std::size_t READERS = 2;
+    constexpr std::size_t LOOKUPS_PER_READER = 20000;
+
+    WSEML makeAA(std::vector<WSEML>& keys) {
+        WSEML aa = createAssociativeArray();
+        for (std::size_t block = 0; block < 8; block++) {
+            WSEML newBlock = createBlock();
+            for (std::size_t i = 0; i < 64; i++) {
+                keys.emplace_back("key" + std::to_string(block * 64 + i));
+                addKeyValueAssociationToBlock(newBlock, keys.back(), WSEML("value"));
+            }
+            enableKeyFilter(newBlock, 64);
+            appendBlock(aa, newBlock);
+        }
+        return aa;
+    }
+
+    /* per-lookup latencies of the readers while the writer runs every millisecond, if any */
+    template <typename Read, typename Write>
+    void run(const char* name, const std::vector<WSEML>& keys, Read read, Write write, bool withWriter) {
+        std::atomic<bool> stop = false;
+        std::thread writer([&]() {
+            while (withWriter and not stop) {
+                write();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        std::vector<std::vector<double>> latencies(READERS);
+        std::vector<std::thread> readers;
+        for (std::size_t t = 0; t < READERS; t++) {
+            readers.emplace_back([&, t]() {
+                latencies[t].reserve(LOOKUPS_PER_READER);
+                for (std::size_t i = 0; i < LOOKUPS_PER_READER; i++) {
+                    auto start = std::chrono::steady_clock::now();
+                    bench::doNotOptimize(read(keys[(i * 7919 + t) % keys.size()]));
+                    latencies[t].push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+                }
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        stop = true;
+        writer.join();
+
+        std::vector<double> all;
+        for (const std::vector<double>& readerLatencies : latencies) {
+            all.insert(all.end(), readerLatencies.begin(), readerLatencies.end());
+        }
+        std::sort(all.begin(), all.end());
+        std::printf("  %-36s p50 %10.1f ns   p99 %12.1f ns\n", name, all[all.size() / 2], all[all.size() * 99 / 100]);
+    }
+} // namespace
+
+int main() {
+    std::vector<WSEML> keys;
+    WSEML initial = makeAA(keys);
+    std::printf("8 blocks of 64 keys, %zu readers, writer every 1 ms\n", READERS);
+
+    WSEML shared = initial;
+    std::shared_mutex mutex;
+    auto lockedRead = [&](const WSEML& key) {
+        std::shared_lock lock(mutex);
+        return findValuePtrInAA(shared, key) != nullptr;
+    };
+    auto lockedWrite = [&]() {
+        std::unique_lock lock(mutex);
+        appendBlock(shared, createBlock());
+        addKeyValueAssociationToAA(shared, keys.front(), WSEML("scoped"));
+        popBlock(shared);
+    };
+    run("shared_mutex, no writer", keys, lockedRead, lockedWrite, false);
+    run("shared_mutex, writer", keys, lockedRead, lockedWrite, true);
+
+    VersionedAA versioned(initial);
+    auto versionedRead = [&](const WSEML& key) {
+        VersionedAA::ReadGuard guard = versioned.read();
+        return findValuePtrInAA(*guard, key) != nullptr;
+    };
+    auto versionedWrite = [&]() {
+        versioned.update([&](WSEML& aa) {
+            appendBlock(aa, createBlock());
+            addKeyValueAssociationToAA(aa, keys.front(), WSEML("scoped"));
+            popBlock(aa);
+        });
+    };
+    run("VersionedAA, no writer", keys, versionedRead, versionedWrite, false);
+    run("VersionedAA, writer", keys, versionedRead, versionedWrite, true);
+    std::printf("  %llu versions published, %zu awaiting reclamation\n", static_cast<unsigned long long>(versioned.getVersion()),
+                versioned.getRetiredCount());
+    return 0;
+}
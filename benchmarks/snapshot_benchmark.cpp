@@ -0,0 +1,57 @@
+#include <cstdio>
+#include <string>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    WSEML makeAA(std::size_t blocks, std::size_t keysPerBlock) {
+        WSEML aa = createAssociativeArray();
+        for (std::size_t block = 0; block < blocks; block++) {
+            WSEML newBlock = createBlock();
+            for (std::size_t i = 0; i < keysPerBlock; i++) {
+                addKeyValueAssociationToBlock(newBlock, WSEML("key" + std::to_string(block) + "_" + std::to_string(i)),
+                                              WSEML("value" + std::to_string(i)));
+            }
+            appendBlock(aa, newBlock);
+        }
+        return aa;
+    }
+
+    /* a transaction: removals in the bottom block, a new scope with a few bindings, a popped scope */
+    void edit(WSEML& aa, std::size_t changes) {
+        WSEML& bottom = aa.getList().get().front().getData();
+        for (std::size_t i = 0; i < changes; i++) {
+            removeKeyValueAssociationFromBlock(bottom, WSEML("key0_" + std::to_string(i)));
+        }
+        WSEML scope = createBlock();
+        appendBlock(aa, scope);
+        for (std::size_t i = 0; i < changes; i++) {
+            addKeyValueAssociationToAA(aa, WSEML("new" + std::to_string(i)), WSEML("value"));
+        }
+        popBlock(aa);
+    }
+} // namespace
+
+int main() {
+    for (std::size_t keysPerBlock : {16, 256}) {
+        WSEML aa = makeAA(64, keysPerBlock);
+        std::printf("64 blocks of %zu keys, transaction of 2x8 changes rolled back\n", keysPerBlock);
+        std::size_t iterations = keysPerBlock >= 256 ? 20 : 200;
+
+        double copying = bench::measure("  copy, edit, restore", iterations, [&]() {
+            WSEML saved = aa;
+            edit(aa, 8);
+            aa = std::move(saved);
+        });
+        double snapshot = bench::measure("  takeSnapshot, edit, rollbackToSnapshot", iterations, [&]() {
+            AASnapshot taken = takeSnapshot(aa);
+            edit(aa, 8);
+            rollbackToSnapshot(aa, taken);
+        });
+        std::printf("  speedup %.1fx\n", copying / snapshot);
+    }
+    return 0;
+}
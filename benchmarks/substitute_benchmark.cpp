@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/substitutionTemplate.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    WSEML makeTemplate(std::size_t groundEntries) {
+        WSEML templateObj = WSEML(std::list<Pair>());
+        for (std::size_t i = 0; i < groundEntries; i++) {
+            WSEML entry = WSEML(std::list<Pair>());
+            entry.append(WSEML("value" + std::to_string(i)), WSEML("field"));
+            templateObj.append(std::move(entry), WSEML("entry" + std::to_string(i)));
+        }
+        templateObj.append(createPlaceholder("a"), WSEML("a"));
+        templateObj.append(createPlaceholder("b"), WSEML("b"));
+        return templateObj;
+    }
+
+    WSEML makeBindings(std::size_t seed) {
+        WSEML bindings = createAssociativeArray();
+        addKeyValueAssociationToAA(bindings, createPlaceholder("a"), WSEML(std::to_string(seed)));
+        addKeyValueAssociationToAA(bindings, createPlaceholder("b"), WSEML(std::to_string(seed + 1)));
+        return bindings;
+    }
+} // namespace
+
+int main() {
+    std::vector<WSEML> bindings;
+    for (std::size_t seed = 0; seed < 16; seed++) {
+        bindings.push_back(makeBindings(seed));
+    }
+
+    for (std::size_t groundEntries : {8, 64, 512}) {
+        WSEML templateObj = makeTemplate(groundEntries);
+        SubstitutionTemplate compiled(templateObj);
+        std::size_t iterations = groundEntries >= 512 ? 200 : 2000;
+        std::printf("template with %zu ground entries\n", groundEntries);
+
+        std::size_t next = 0;
+        double generic = bench::measure("  substitutePlaceholders", iterations, [&]() {
+            WSEML result = substitutePlaceholders(bindings[next++ % bindings.size()], templateObj);
+            bench::doNotOptimize(result);
+        });
+        double compiledTime = bench::measure("  SubstitutionTemplate::substitute", iterations, [&]() {
+            WSEML result = compiled.substitute(bindings[next++ % bindings.size()]);
+            bench::doNotOptimize(result);
+        });
+        std::printf("  speedup %.1fx\n", generic / compiledTime);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <cstdio>
+#include <string>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/parser.hpp"
+#include "benchmark.hpp"
+
+using namespace wseml;
+
+namespace {
+    /* a chain of single-pair lists, the shape of pointer chains and generated documents */
+    WSEML makeChain(std::size_t depth) {
+        WSEML chain = createPlaceholder("X");
+        for (std::size_t i = 0; i < depth; i++) {
+            WSEML link = WSEML(std::list<Pair>());
+            link.append(std::move(chain), WSEML("next"));
+            chain = std::move(link);
+        }
+        return chain;
+    }
+
+    /* a balanced tree of lists with string leaves */
+    WSEML makeBushy(std::size_t depth, std::size_t width) {
+        WSEML node = WSEML(std::list<Pair>());
+        for (std::size_t i = 0; i < width; i++) {
+            if (depth == 0) {
+                node.append(WSEML("leaf" + std::to_string(i)), WSEML("k" + std::to_string(i)));
+            } else {
+                node.append(makeBushy(depth - 1, width), WSEML("k" + std::to_string(i)), i == 0 ? WSEML("role") : NULLOBJ);
+            }
+        }
+        return node;
+    }
+
+    void run(const char* name, std::size_t iterations, const WSEML& tree, std::size_t chainDepth) {
+        std::printf("%s\n", name);
+        WSEML copy = tree;
+        WSEML bindings = createAssociativeArray();
+        addKeyValueAssociationToAA(bindings, createPlaceholder("X"), WSEML("bound"));
+        bench::measure("  build", iterations, [&]() {
+            WSEML built = chainDepth != 0 ? makeChain(chainDepth) : makeBushy(4, 12);
+            bench::doNotOptimize(built);
+        });
+        bench::measure("  copy + destroy", iterations, [&]() {
+            WSEML cloned = tree;
+            bench::doNotOptimize(cloned);
+        });
+        bench::measure("  equal", iterations, [&]() { bench::doNotOptimize(equal(tree, copy)); });
+        bench::measure("  hash_value", iterations, [&]() { bench::doNotOptimize(hash_value(tree)); });
+        bench::measure("  pack", iterations, [&]() {
+            std::string packed = pack(tree);
+            bench::doNotOptimize(packed);
+        });
+        bench::measure("  substitutePlaceholders", iterations, [&]() {
+            WSEML substituted = substitutePlaceholders(bindings, tree);
+            bench::doNotOptimize(substituted);
+        });
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t depth = argc > 1 ? std::stoul(argv[1]) : 100000;
+    run("bushy tree, 12^5 leaves", 3, makeBushy(4, 12), 0);
+    std::printf("chain of %zu lists\n", depth);
+    run("chain", 3, makeChain(depth), depth);
+    return 0;
+}
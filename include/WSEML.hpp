@@ -7,9 +7,13 @@
  */
 
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <list>
 #include <string>
 #include <memory>
+#include <string_view>
+#include <vector>
 
 namespace wseml {
 
@@ -18,8 +22,13 @@ namespace wseml {
     class ByteString;
     class List;
     class WSEML;
+    struct SharedNode;
+    class KeyFilter;
+    class TriggerIndex;
+    struct AutoCompaction;
+    class UndoLog;
 
-    extern WSEML NULLOBJ;
+    extern const WSEML NULLOBJ;
 
     extern WSEML FUNCTION_TYPE;
 
@@ -35,11 +44,45 @@ namespace wseml {
      */
     bool equal(const WSEML& first, const WSEML& second);
 
+    /**
+     * @brief Returns the number of @ref Object instances created by the current thread so far.
+     */
+    std::size_t getObjectAllocationCount();
+
+    /**
+     * @brief Returns the number of modifications of watched objects so far (see Object::watch).
+     * @details Lookup caches record the count they were synchronized at; while it has not moved, none of the objects
+     *          they depend on has changed.
+     */
+    std::uint64_t getModificationCount();
+
+    /**
+     * @brief Returns the number of the modifications counted by getModificationCount that the calling thread made.
+     */
+    std::uint64_t getOwnModificationCount();
+
+    /**
+     * @brief Estimates the heap bytes owned by @p obj: its objects, list nodes, pair roles and the strings too long for
+     *        the small string buffer.
+     * @param throughShared Whether to count the nodes @p obj shares (see WSEML::share), each once however many of its
+     *        handles refer to it. Without them the estimate is of the bytes @p obj holds alone.
+     */
+    std::size_t footprint(const WSEML& obj, bool throughShared = true);
+
     /**
      * @brief A main class in the hierarchy, acting as a handle to WSEML data.
      *
      * Stores a pointer to the underlying @ref Object and manages its lifetime.
      * Provides value semantics (copying creates a deep copy).
+     *
+     * An untyped string of up to 7 bytes (most keys, numbers and tags) is stored in the handle itself rather than in a
+     * ByteString, and so is the null object. Such a string is promoted to a ByteString when an Object is asked for
+     * (getRawObject, getByteString, getInnerString), when it gets a semantic type and when it is linked to a Pair as
+     * a role; as the key or data of a Pair it keeps the link in the handle.
+     *
+     * A handle may also share an immutable tree with other handles (see share). Its const accessors read the shared
+     * tree, while its mutating accessors first replace the handle's reference by a copy of the tree's root (copy on
+     * write), whose nested handles go on sharing their own trees.
      */
     class WSEML {
     public:
@@ -242,21 +285,59 @@ namespace wseml {
          */
         const std::string& getInnerString() const;
 
+        /**
+         * @brief Returns the string like getInnerString, without promoting a string stored in the handle.
+         * @param buffer Receives the bytes of a string stored in the handle; they fit its small string buffer.
+         * @return A view of @p buffer or of the string of the ByteString, valid while both are unchanged.
+         * @throws std::runtime_error if underlying object is not a ByteString.
+         */
+        std::string_view getStringView(std::string& buffer) const;
+
+        /**
+         * @brief Returns true if the handle stores a short untyped string in place of a ByteString.
+         */
+        bool isInline() const;
+
+        /**
+         * @brief Moves @p tree into a node that the returned handle and its copies share; copying such a handle only
+         *        counts a reference.
+         * @param tree A tree that no longer changes, such as those made by @ref freeze and @ref HashConsTable. A handle
+         *        that is already shared is returned as it is.
+         * @note The objects of the tree are not linked to the pairs holding its handles: getContainingPair of a shared
+         *       handle returns its own pair, but walking up from inside the tree stops at its root.
+         */
+        static WSEML share(WSEML tree);
+
+        /**
+         * @brief Returns true if the handle shares a tree (see share).
+         */
+        bool isShared() const;
+
+        /**
+         * @brief Returns the node shared by the handle, or nullptr if the handle owns its contents.
+         */
+        const SharedNode* getSharedNode() const;
+
         /**
          * @brief Returns the raw pointer to the  @ref Object this WSEML points to.
          * @return Pointer to the Object, or nullptr if empty.
+         * @note A string stored in the handle is promoted to a ByteString first (see isInline), and a shared tree is
+         *       copied first (see share).
          */
         Object* getRawObject();
 
         /**
          * @brief Returns the raw pointer to the const @ref Object this WSEML points to.
          * @return Const pointer to the Object, or nullptr if empty.
+         * @note A string stored in the handle is promoted to a ByteString first (see isInline); concurrent readers
+         *       may do so safely.
          */
         const Object* getRawObject() const;
 
         /**
          * @brief Functions to recursively set correct back pointers in contained objects.
          * @param p Pointer to the pair that contains this WSEML objects as key, data, key role, or data role.
+         * @note Walks the tree with an explicit stack, so the depth of the tree is not limited by the call stack.
          */
         void updateLinksRecursively(Pair* p);
 
@@ -269,7 +350,59 @@ namespace wseml {
         friend Pair;
 
     private:
-        std::unique_ptr<Object> obj_ = nullptr;
+        /* sets the back pointers of the object and of its own pairs; deeper links do not depend on this handle */
+        void updateLinks(Pair* p);
+
+        /* the held object, promoting a string stored in the handle first; nullptr if the handle is empty */
+        Object* object() const;
+
+        /* the held object without promoting, nullptr for an inline string and a shared node */
+        Object* heldObject() const;
+
+        /* the handle whose contents the const accessors read: the tree of a shared node, or this handle */
+        const WSEML& target() const;
+
+        /* the node of a shared handle held by no other handle, nullptr otherwise */
+        SharedNode* soleNode() const;
+
+        /* replaces a shared node by a copy of its root, before a change */
+        void unshare();
+
+        /* the pair the inline string or shared node in word is the key or data of */
+        Pair* slotPair(std::uintptr_t word) const;
+
+        /* counts a modification of the contents word: of the object, or of the List holding the pair of an inline string
+           or a shared node */
+        void noteChange(std::uintptr_t word) const;
+
+        /* replaces the contents, linking the new ones to the pair the old ones were linked to */
+        void reset(std::uintptr_t word);
+
+        /* gives up the held object, leaving the handle empty */
+        Object* release();
+
+        /* takes the contents of other into this empty handle unlinked, for the caller to link them once */
+        void adopt(WSEML& other);
+
+        /* an owned Object*, 0 for the null object, an untyped string stored inline or a SharedNode* (see WSEML.cpp).
+           Readers promote inline strings on demand, hence the atomic */
+        mutable std::atomic<std::uintptr_t> word_ = 0;
+    };
+
+    /**
+     * @brief A tree held by any number of WSEML handles, see WSEML::share.
+     */
+    struct alignas(16) SharedNode {
+        SharedNode(WSEML sharedTree, std::size_t treeHash);
+
+        /* the handles never change the tree */
+        WSEML tree;
+        /* the hash of the tree, so that hashing a handle to the node does not descend into it */
+        std::size_t hash;
+        /* the id of the HashConsTable holding the node, 0 if none; set before the node is handed out. A table holds a
+           single node per value, so two of its nodes are equal exactly when they are the same node */
+        std::uint64_t table = 0;
+        std::atomic<std::size_t> references = 1;
     };
 
     /**
@@ -297,6 +430,12 @@ namespace wseml {
          */
         Object(const WSEML& type, Pair* pair); // Pass type by const&
 
+        /**
+         * @brief Copies the semantic type and the containing pair pointer of @p other.
+         * @note The copy is never frozen.
+         */
+        Object(const Object& other);
+
         /**
          * @brief Creates a deep copy of the Object.
          * @return A unique_ptr owning the new copy.
@@ -324,6 +463,7 @@ namespace wseml {
 
         /**
          * @brief Gets the semantic 'type' of this object.
+         * @note The type may be changed through the reference, so the object counts as escaped (see watch).
          */
         WSEML& getSemanticType(); // Only const getter needed publicly
 
@@ -383,6 +523,52 @@ namespace wseml {
          */
         virtual void updateLinksRecursively(Pair* p, WSEML* holder) = 0;
 
+        /**
+         * @brief Updates the back pointer of this object and the owner pointers of its own pairs only.
+         * @details Moving a WSEML handle or a Pair changes only the links to that handle or Pair, so this is all the
+         *          copy and move operations need; nested objects keep their links.
+         * @param p Pointer to the pair that contains this object as key, data, key role or data role.
+         * @param holder Pointer to the WSEML instance that holds this Object.
+         */
+        virtual void updateLinks(Pair* p, WSEML* holder) = 0;
+
+        /**
+         * @brief Returns true if the object belongs to a tree frozen by @ref freeze.
+         */
+        bool isFrozen() const;
+
+        /**
+         * @brief Marks the object as immutable; the mutating accessors assert on it in debug builds.
+         * @note Called by @ref freeze on every object of the tree.
+         */
+        void setFrozen();
+
+        /**
+         * @brief Marks the object as one a lookup cache depends on, so that its modifications are counted by
+         *        getModificationCount.
+         * @return False if the object escaped: a mutable reference to its contents or to its type was handed out
+         *         (ByteString::get, List::get, getSemanticType), so it may change without being counted.
+         * @note May be called by concurrent readers.
+         */
+        bool watch() const;
+
+        /**
+         * @brief Counts a modification of the object if it is watched; called by the modifiers.
+         */
+        void noteModification();
+
+        /**
+         * @brief Takes the frozen and watched flags of @p holder, the List holding the pair of a string promoted from
+         *        a WSEML handle: they stood for the string while it had no object.
+         */
+        void inheritFlags(const Object& holder);
+
+    protected:
+        void assertMutable() const;
+
+        /* counts a modification and marks the object as escaped, see watch */
+        void noteEscape();
+
     private:
         // Object(const Object&) = delete;
         // Object& operator=(const Object&) = delete;
@@ -390,7 +576,10 @@ namespace wseml {
         // Object& operator=(Object&&) = delete;
 
         WSEML semanticType_;
-        Pair* containingPair_ = nullptr;
+        /* the containing pair, tagged with the frozen, watched and escaped flags in the low bits that the alignment of
+           a Pair keeps free; flags of their own would be padded to a whole word in every object. Readers building a
+           lookup cache set the watched flag, hence the atomic */
+        mutable std::atomic<std::uintptr_t> containingPair_ = 0;
     };
 
     /**
@@ -426,6 +615,8 @@ namespace wseml {
 
         /**
          * @brief Returns a reference to the string stored in this object.
+         * @note The string may be changed through the reference at any later time, so the object counts as escaped
+         *       (see Object::watch).
          */
         std::string& get();
 
@@ -445,6 +636,8 @@ namespace wseml {
          */
         void updateLinksRecursively(Pair* p, WSEML* holder) override;
 
+        void updateLinks(Pair* p, WSEML* holder) override;
+
         // Needed for hashing
         friend std::size_t hash_value(const WSEML& w);
 
@@ -474,6 +667,17 @@ namespace wseml {
          */
         List(std::list<Pair> l, const WSEML& type = NULLOBJ, Pair* p = nullptr);
 
+        /**
+         * @brief Copies the pairs, the type, the key filter (rebuilt on the first lookup) and the automatic compaction
+         *        state of @p other.
+         * @note A trigger index is not copied (it refers to the pairs of @p other); an empty one is attached instead.
+         *       Open snapshots are not copied either. Nested Lists are copied with an explicit stack.
+         */
+        List(const List& other);
+
+        /**
+         * @brief Destroys the pairs; nested Lists are detached and destroyed one by one rather than recursively.
+         */
         ~List() override;
 
         /**
@@ -497,14 +701,32 @@ namespace wseml {
 
         /**
          * @brief Returns a reference to the internal std::list< @ref Pair>.
+         * @note The pairs may be changed through the reference at any later time, so the List counts as escaped (see
+         *       Object::watch). The modifiers below and the iterators do not have this effect.
          */
         std::list<Pair>& get();
 
         /**
          * @brief Returns a new key suitable for pairs without a defined key.
+         * @details The keys of a List whose pairs all got generated keys are keyAt(0), keyAt(1), ...
          */
         WSEML genKey();
 
+        /**
+         * @brief Returns the key genKey generates for the pair at @p index of a List whose keys were all generated.
+         */
+        static WSEML keyAt(std::size_t index);
+
+        /**
+         * @brief Makes genKey continue as if the keys of the first @p count pairs had been generated.
+         */
+        void setNextKeyAfter(std::size_t count);
+
+        /**
+         * @brief Returns the number of keys genKey has generated, or was made to continue after (see setNextKeyAfter).
+         */
+        std::size_t generatedKeyCount() const;
+
         /**
          * @brief Returns a reference to the current default key stored inside.
          */
@@ -514,7 +736,8 @@ namespace wseml {
          * @brief Finds the 'data' WSEML associated with the given key.
          * @param key The key to search for.
          * @return A reference to the 'data' WSEML if found.
-         * @return A reference to wseml::NULLOBJ if not found.
+         * @return A reference to an empty per-thread sentinel if not found. The sentinel is reset on every miss, so writes
+         *         through it never reach wseml::NULLOBJ.
          */
         WSEML& find(const WSEML& key);
 
@@ -530,7 +753,7 @@ namespace wseml {
          * @brief Finds the 'data' WSEML associated with the given string key.
          * @param key The key to search for.
          * @return A reference to the 'data' WSEML if found.
-         * @return A reference to wseml::NULLOBJ if not found.
+         * @return A reference to an empty per-thread sentinel if not found (see find(const WSEML&)).
          */
         WSEML& find(const std::string& key);
 
@@ -570,6 +793,39 @@ namespace wseml {
          */
         bool erase(const std::string& key);
 
+        /**
+         * @brief Removes the pair at @p pos.
+         * @return The iterator following the removed pair.
+         */
+        iterator erase(iterator pos);
+
+        /**
+         * @brief Removes the pairs [first, last).
+         * @return The iterator following the removed pairs.
+         */
+        iterator erase(iterator first, iterator last);
+
+        /**
+         * @brief Appends a pair with the given members as they are; unlike append, no key is generated or returned.
+         * @param listOwner Pointer to the WSEML object that *owns* this List.
+         * @return The new pair.
+         */
+        Pair& emplace_back(WSEML* listOwner, WSEML key, WSEML data, WSEML keyRole = NULLOBJ, WSEML dataRole = NULLOBJ);
+
+        /**
+         * @brief Appends a pair without roles, moving @p key and @p data into it directly.
+         * @details The bulk construction counterpart of emplace_back: every intermediate move of a handle relinks
+         *          its object, which shows when millions of pairs are built (see BlockBuilder).
+         * @return The new pair.
+         */
+        Pair& appendMoved(WSEML* listOwner, WSEML&& key, WSEML&& data);
+
+        /**
+         * @brief Moves the pairs of @p other before @p pos, leaving @p other empty.
+         * @pre The pairs of @p other are linked to the owner of this List (see Pair::setListOwner).
+         */
+        void splice(iterator pos, List& other);
+
         /**
          * @brief Appends a new Pair to the end of the list.
          * @param listOwner Pointer to the WSEML object that *owns* this List. Needed to set back-pointers correctly.
@@ -677,18 +933,85 @@ namespace wseml {
          */
         void updateLinksRecursively(Pair* p, WSEML* holder) override;
 
+        void updateLinks(Pair* p, WSEML* holder) override;
+
+        /* Key filter */
+
+        /**
+         * @brief Returns the key filter attached to this List, or nullptr.
+         * @note The filter is a cache maintained by the Associative Array functions; it is not part of the value.
+         */
+        KeyFilter* getKeyFilter() const;
+
+        /**
+         * @brief Attaches a key filter (nullptr detaches it).
+         */
+        void setKeyFilter(std::unique_ptr<KeyFilter> filter);
+
+        /**
+         * @brief Returns the trigger index attached to this List, or nullptr.
+         * @note Like the key filter, the index is a cache maintained by the Associative Array functions.
+         */
+        TriggerIndex* getTriggerIndex() const;
+
+        /**
+         * @brief Attaches a trigger index (nullptr detaches it).
+         */
+        void setTriggerIndex(std::unique_ptr<TriggerIndex> index);
+
+        /**
+         * @brief Returns the automatic compaction state of this List, or nullptr (see enableAutoCompaction).
+         */
+        AutoCompaction* getAutoCompaction() const;
+
+        void setAutoCompaction(std::unique_ptr<AutoCompaction> autoCompaction);
+
+        /**
+         * @brief Returns the undo log of the open snapshots of this List, or nullptr (see takeSnapshot).
+         */
+        UndoLog* getUndoLog() const;
+
+        void setUndoLog(std::unique_ptr<UndoLog> undoLog);
+
         friend class WSEML;
+        friend class UndoLog;
 
     private:
+        struct MetadataOnly {};
+
+        /* copies everything the copy constructor does except the pairs */
+        List(const List& other, MetadataOnly);
+
+        void copyPairsFrom(const List& source);
+
+        /* moves the non-empty Lists held by the pairs into pending */
+        void releaseNested(std::vector<std::unique_ptr<Object>>& pending);
+
+        /* the key of the number, written into the handle without a std::string while it fits there */
+        static WSEML numberKey(std::size_t number);
+
+        /* the generated keys are FIRST_KEY, FIRST_KEY + KEY_STEP, ... */
+        static constexpr unsigned int FIRST_KEY = 1;
+        static constexpr unsigned int KEY_STEP = 2;
+
+        /* the key filter, trigger index, compaction state and undo log, which few Lists have; out of line, so that
+           the many small Lists (e.g. every association) stay small */
+        struct Attachments;
+
+        /* the attachments, allocated by the first one set */
+        Attachments& attachments();
+
         std::list<Pair> pairList_;
-        unsigned int nextKey_ = 1;
+        unsigned int nextKey_ = FIRST_KEY;
+        std::unique_ptr<Attachments> attachments_;
     };
 
     /**
      * @brief Stores a key-value pair along with optional roles.
      *
-     * Contains WSEML objects for key, data, keyRole, and dataRole.
-     * Also stores a pointer back to the WSEML List containing this Pair.
+     * Contains WSEML objects for key and data. The keyRole and dataRole are NULLOBJ in almost all pairs, so they are
+     * kept in a separate allocation made only while one of them is set.
+     * Also stores a pointer back to the WSEML List containing this Pair, which moves into the roles while they are set.
      */
     class Pair {
     public:
@@ -705,11 +1028,20 @@ namespace wseml {
          */
         Pair(WSEML* listPtr, WSEML key, WSEML data, WSEML keyRole = NULLOBJ, WSEML dataRole = NULLOBJ);
 
+        /* selects the constructor below */
+        struct MovedIn {};
+
+        /**
+         * @brief Construct a new Pair object without roles, moving the key and the data straight into it.
+         * @note Spares the moves through the by-value parameters of the constructor above (see List::appendMoved).
+         */
+        Pair(MovedIn, WSEML* listPtr, WSEML&& key, WSEML&& data);
+
         /**
          * @brief Deep copy constructor.
          * @param other The Pair to copy.
          * @note The new Pair's members will have their `containingPair_` pointer set to `this`.
-         * @note The `listOwner_` pointer is not copied.
+         * @note The List owner is not copied.
          */
         Pair(const Pair& other);
 
@@ -717,7 +1049,7 @@ namespace wseml {
          * @brief Move constructor.
          * @param other The Pair to move from.
          * @note Updates the `containingPair_` pointer of the moved WSEML members to `this`.
-         * @note The `listOwner_` pointer is moved.
+         * @note The List owner is moved.
          */
         Pair(Pair&& other) noexcept;
 
@@ -734,7 +1066,7 @@ namespace wseml {
         /**
          * @brief Destructor.
          */
-        ~Pair() = default;
+        ~Pair();
 
         /* Access and modification */
 
@@ -759,24 +1091,52 @@ namespace wseml {
         const WSEML& getData() const;
 
         /**
-         * @brief Returns a reference to the key role.
+         * @brief Returns a const reference to the key role (NULLOBJ if it is not set).
          */
-        WSEML& getKeyRole();
+        const WSEML& getKeyRole() const;
 
         /**
-         * @brief Returns a const reference to the key role.
+         * @brief Returns a const reference to the data role (NULLOBJ if it is not set).
          */
-        const WSEML& getKeyRole() const;
+        const WSEML& getDataRole() const;
 
         /**
-         * @brief Returns a reference to the data role.
+         * @brief Replaces the key role; the roles are released once both are NULLOBJ.
          */
-        WSEML& getDataRole();
+        void setKeyRole(WSEML keyRole);
 
         /**
-         * @brief Returns a const reference to the data role.
+         * @brief Replaces the data role; the roles are released once both are NULLOBJ.
          */
-        const WSEML& getDataRole() const;
+        void setDataRole(WSEML dataRole);
+
+        /**
+         * @brief Checks whether a key role or a data role is set.
+         */
+        bool hasRoles() const;
+
+        /**
+         * @brief Calls f with each member of the pair: the key, the data and, if set, the key role and the data role.
+         */
+        template <class F>
+        void forEachMember(F&& f) {
+            f(key_);
+            f(data_);
+            if (Roles* roles = this->roles()) {
+                f(roles->keyRole);
+                f(roles->dataRole);
+            }
+        }
+
+        template <class F>
+        void forEachMember(F&& f) const {
+            f(key_);
+            f(data_);
+            if (const Roles* roles = this->roles()) {
+                f(roles->keyRole);
+                f(roles->dataRole);
+            }
+        }
 
         /**
          * @brief Gets the pointer to the WSEML List that contains this pair.
@@ -805,11 +1165,34 @@ namespace wseml {
         void updateLinksRecursively(WSEML* listHolder);
 
     private:
+        void updateLinks(WSEML* listHolder);
+
+        /* counts a modification of the List holding the pair, see Object::noteModification */
+        void noteModification();
+
+        struct Roles {
+            WSEML keyRole;
+            WSEML dataRole;
+            WSEML* listOwner = nullptr;
+        };
+
+        /* allocates the roles only if one of them is set */
+        static std::unique_ptr<Roles> makeRoles(WSEML keyRole, WSEML dataRole);
+
+        /* the roles, or nullptr if none is set */
+        Roles* roles() const;
+
+        /* replaces the roles, keeping the List owner */
+        void setRoles(std::unique_ptr<Roles> roles);
+
+        /* tags owner_ as pointing to the roles */
+        static constexpr std::uintptr_t ROLES_BIT = 1;
+
         WSEML key_;
         WSEML data_;
-        WSEML keyRole_;
-        WSEML dataRole_;
-        WSEML* listOwner_ = nullptr;
+        /* the List owner, or the roles tagged with ROLES_BIT, which then hold the List owner; a Pair without roles
+           takes no room for them */
+        std::uintptr_t owner_ = 0;
 
         friend class WSEML;
     };
@@ -833,4 +1216,24 @@ namespace std {
             return wseml::hash_value(pair);
         }
     };
-} // namespace std
\ No newline at end of file
+} // namespace std
+
+namespace wseml {
+    /**
+     * @brief Hashes a WSEML object through a pointer, for containers indexing objects without copying them.
+     */
+    struct WSEMLPtrHash {
+        size_t operator()(const WSEML* obj) const {
+            return std::hash<WSEML>{}(*obj);
+        }
+    };
+
+    /**
+     * @brief Compares WSEML objects through pointers, see WSEMLPtrHash.
+     */
+    struct WSEMLPtrEqual {
+        bool operator()(const WSEML* lhs, const WSEML* rhs) const {
+            return *lhs == *rhs;
+        }
+    };
+} // namespace wseml
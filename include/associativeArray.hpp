@@ -1,8 +1,13 @@
 #pragma once
 
+#include <span>
+#include <vector>
 #include "WSEML.hpp"
+#include "keyFilter.hpp"
 
 namespace wseml {
+    class WorkStealingPool;
+
     extern WSEML AATYPE;
     extern WSEML BLOCKTYPE;
     extern WSEML KV_ASSOC_TYPE;
@@ -14,10 +19,11 @@ namespace wseml {
      * @brief Creates a WSEML object representing a Functional Association.
      * @param triggerType The WSEML object representing the semantic type of a key that should trigger this function.
      * @param functionReference The WSEML object (type FUNCTION_TYPE) referencing the function to call.
+     * @param pure True if the function result depends only on the key, so it may be memoized.
      * @return A WSEML object of type FUNC_ASSOC_TYPE.
      * @throws std::runtime_error if functionReference is not a valid DllFunctionReference.
      */
-    WSEML createFunctionalAssociation(const WSEML& triggerType, const WSEML& functionReference);
+    WSEML createFunctionalAssociation(const WSEML& triggerType, const WSEML& functionReference, bool pure = false);
 
     /**
      * @brief Checks if a WSEML object represents a Functional Association.
@@ -42,6 +48,24 @@ namespace wseml {
      */
     const WSEML& getFuncAssocFunction(const WSEML& funcAssoc);
 
+    /**
+     * @brief Checks if a Functional Association is marked as pure.
+     * @param funcAssoc The WSEML object (must be a Functional Association).
+     * @return True if results of the function may be memoized.
+     * @throws std::runtime_error if funcAssoc is not a valid Functional Association.
+     */
+    bool isPureFunctionalAssociation(const WSEML& funcAssoc);
+
+    /**
+     * @brief Applies a Functional Association to a key.
+     * @details Results of pure associations are served from and stored in the global FunctionResultCache.
+     * @param funcAssoc The WSEML object (must be a Functional Association).
+     * @param key The key that triggered the association.
+     * @return The result of the function, or NULLOBJ on error.
+     * @throws std::runtime_error if funcAssoc is not a valid Functional Association.
+     */
+    WSEML callFunctionalAssociation(const WSEML& funcAssoc, const WSEML& key);
+
     /* Factory functions */
 
     /**
@@ -115,6 +139,18 @@ namespace wseml {
      */
     bool isPlaceholder(const WSEML& obj);
 
+    /**
+     * @brief Checks if a WSEML object is or contains a placeholder in any key, data or role.
+     * @param obj The WSEML object to check.
+     */
+    bool containsPlaceholder(const WSEML& obj);
+
+    /**
+     * @brief Checks if a WSEML object is or contains an Associative Array or a Block, which unification compares after merging.
+     * @param obj The WSEML object to check.
+     */
+    bool containsAssociativeStructure(const WSEML& obj);
+
     /**
      * @brief Checks if the given WSEML object is a valid key-value association.
      */
@@ -136,6 +172,8 @@ namespace wseml {
      * @brief Appends a block to the end of an Associative Array's block list.
      * @param aa The Associative Array (must be of AATYPE). Modified in place.
      * @param block The Block (must be of BLOCKTYPE) to append (copied).
+     * @note With automatic compaction enabled (see enableAutoCompaction), the blocks below the kept top ones may be
+     *       compacted afterwards.
      * @throws std::runtime_error if aa is not an Associative Array or block is not a Block.
      */
     void appendBlock(WSEML& aa, const WSEML& block);
@@ -181,6 +219,60 @@ namespace wseml {
      */
     void removeFunctionalAssociationFromBlock(WSEML& block, const WSEML& funcAssoc);
 
+    /**
+     * @brief Attaches a Bloom filter of its keys to a Block, so that lookups can skip it when a key is definitely absent.
+     * @details The filter is updated by addKeyValueAssociationToBlock and rebuilt on the next lookup after any other
+     *          modification of a watched object (see getModificationCount). A Block whose list or keys were handed out
+     *          for editing (List::get, WSEML::getInnerList, WSEML::getInnerString) cannot be watched, so its lookups
+     *          scan it until those objects are replaced. Copies of the Block keep the filter.
+     * @param block The Block (must be of BLOCKTYPE).
+     * @param expectedKeys The expected number of keys; the filter grows when it is exceeded.
+     * @throws std::runtime_error if block is not a Block.
+     */
+    void enableKeyFilter(WSEML& block, std::size_t expectedKeys = 16);
+
+    /**
+     * @brief Detaches the key filter of a Block, if any.
+     * @throws std::runtime_error if block is not a Block.
+     */
+    void disableKeyFilter(WSEML& block);
+
+    /**
+     * @brief Returns true if a key filter is attached to a Block.
+     * @throws std::runtime_error if block is not a Block.
+     */
+    bool hasKeyFilter(const WSEML& block);
+
+    /**
+     * @brief Returns the counters of the key filter of a Block, or zeros if it has none.
+     * @throws std::runtime_error if block is not a Block.
+     */
+    KeyFilterStats getKeyFilterStats(const WSEML& block);
+
+    /**
+     * @brief Attaches an index of its functional associations by trigger type to an Associative Array, so that
+     *        findFunctionalAssociationInAA is a single hash probe.
+     * @details The index is built on the next lookup and rebuilt after any modification of a watched object (see
+     *          getModificationCount); adding or removing key-value associations through the AA functions keeps it. An
+     *          AA whose lists or functional associations were handed out for editing (List::get,
+     *          WSEML::getInnerList, WSEML::getInnerString) cannot be watched, so its lookups scan the blocks until
+     *          those objects are replaced. Copies of the AA get an empty index.
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    void enableTriggerIndex(WSEML& aa);
+
+    /**
+     * @brief Detaches the trigger index of an Associative Array, if any.
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    void disableTriggerIndex(WSEML& aa);
+
+    /**
+     * @brief Returns true if a trigger index is attached to an Associative Array.
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    bool hasTriggerIndex(const WSEML& aa);
+
     /**
      * @brief Adds a functional association to the *last* block of an Associative Array.
      * @param aa The Associative Array (must be of AATYPE). Modified in place.
@@ -206,7 +298,7 @@ namespace wseml {
      * @return Const reference to the key WSEML object.
      * @throws std::runtime_error if kvAssociation is not a valid key-value association.
      */
-    WSEML getKeyFromAssociation(WSEML kvAssociation);
+    const WSEML& getKeyFromAssociation(const WSEML& kvAssociation);
 
     /**
      * @brief Extracts the value from a KeyValueAssociation WSEML object.
@@ -214,7 +306,7 @@ namespace wseml {
      * @return Const reference to the value WSEML object.
      * @throws std::runtime_error if kvAssociation is not a valid key-value association.
      */
-    WSEML getValueFromAssociation(WSEML kvAssociation);
+    const WSEML& getValueFromAssociation(const WSEML& kvAssociation);
 
     /**
      * @brief Gets the list of blocks from an Associative Array.
@@ -250,6 +342,75 @@ namespace wseml {
      */
     WSEML findValueInAA(const WSEML& aa, const WSEML& key);
 
+    /**
+     * @brief Collects the effective key-value associations of an AA without copying them.
+     * @param aa The Associative Array (must be of AATYPE).
+     * @return (key, value) pointers into aa for every distinct key; the first association of a key in lookup order wins.
+     *         The pointers are valid until aa is modified.
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    std::vector<std::pair<const WSEML*, const WSEML*>> getEffectiveAssociations(const WSEML& aa);
+
+    /**
+     * @brief Finds the value stored for a key without copying it.
+     * @details Only key-value associations are considered, functional associations are not applied. Blocks with a key
+     *          filter (see enableKeyFilter) that rules the key out are skipped.
+     * @param aa The Associative Array (must be of AATYPE).
+     * @param key The key to search for.
+     * @return Pointer to the value stored in aa, or nullptr if no key-value association exists.
+     *         The pointer is valid until aa is modified.
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    const WSEML* findValuePtrInAA(const WSEML& aa, const WSEML& key);
+
+    /**
+     * @brief Finds the functional association that findValueInAA applies to keys of a semantic type.
+     * @details Associative Arrays with a trigger index (see enableTriggerIndex) answer with a single hash probe; the
+     *          others are scanned block by block.
+     * @param aa The Associative Array (must be of AATYPE).
+     * @param triggerType The semantic type of the key.
+     * @return Pointer to the functional association in aa, or nullptr. The pointer is valid until aa is modified.
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    const WSEML* findFunctionalAssociationInAA(const WSEML& aa, const WSEML& triggerType);
+
+    /**
+     * @brief Brings the lookup caches of an Associative Array (the trigger index and the key filters of its blocks)
+     *        up to date, so that the following lookups do not rebuild them.
+     * @param aa The Associative Array (must be of AATYPE).
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    void syncLookupCaches(const WSEML& aa);
+
+    /**
+     * @brief Finds the values associated with a batch of keys, with the same semantics as findValueInAA.
+     * @details The AA is validated once and walked once for the whole batch. With threads > 1 the keys are split into
+     *          chunks that are resolved concurrently; the AA must not be modified meanwhile.
+     * @param aa The Associative Array (must be of AATYPE).
+     * @param keys The keys to search for.
+     * @param out Storage for the results; out[i] receives the value for keys[i], or wseml::NULLOBJ if not found.
+     * @param threads The number of threads to use.
+     * @throws std::runtime_error if aa is not an Associative Array or out is smaller than keys.
+     */
+    void findValuesInAA(const WSEML& aa, std::span<const WSEML> keys, std::span<WSEML> out, std::size_t threads = 1);
+
+    /**
+     * @brief Finds the values associated with a batch of keys.
+     * @return A vector with the value for every key, see findValuesInAA(aa, keys, out, threads).
+     */
+    std::vector<WSEML> findValuesInAA(const WSEML& aa, std::span<const WSEML> keys, std::size_t threads = 1);
+
+    /**
+     * @brief Finds the stored values of a batch of keys without copying them.
+     * @details Only key-value associations are considered, functional associations are not applied.
+     * @param aa The Associative Array (must be of AATYPE).
+     * @param keys The keys to search for.
+     * @return For every key, a pointer to the value stored in aa, or nullptr if no key-value association exists.
+     *         The pointers are valid until aa is modified.
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    std::vector<const WSEML*> findValueRefsInAA(const WSEML& aa, std::span<const WSEML> keys);
+
     /**
      * @brief Gets the list of blocks from an Associative Array.
      * @param aa The Associative Array (must be of AATYPE).
@@ -289,6 +450,142 @@ namespace wseml {
      */
     WSEML merge(const WSEML& aa);
 
+    /**
+     * @brief Parallel variant of merge, producing the same Associative Array.
+     * @details Keys are hashed in parallel and partitioned by hash; each partition resolves shadowing on its own,
+     *          comparing full keys. The associations of the result are copied by chunks in parallel and spliced into
+     *          its block in lookup order.
+     * @param aa The Associative Array (must be of AATYPE).
+     * @param pool The pool running the partitions and the copies.
+     * @throws std::runtime_error if aa is not a valid Associative Array.
+     */
+    WSEML merge(const WSEML& aa, WorkStealingPool& pool);
+
+    /**
+     * @brief Result of a block compaction.
+     */
+    struct CompactionStats {
+        std::size_t compactions = 0;
+        /* blocks merged away, i.e. the number of blocks in the compacted ranges minus one per range */
+        std::size_t blocksRemoved = 0;
+        /* shadowed key-value associations dropped */
+        std::size_t associationsRemoved = 0;
+        /* estimated heap footprint of the compacted ranges before minus after */
+        std::size_t bytesReclaimed = 0;
+    };
+
+    /**
+     * @brief When automatic compaction runs, see enableAutoCompaction.
+     */
+    struct CompactionPolicy {
+        /* compact once this share of the key-value associations below the kept blocks is shadowed */
+        double shadowRatio = 0.5;
+        /* do not consider compaction before the AA has this many blocks */
+        std::size_t minBlocks = 16;
+        /* number of top blocks that are never compacted, e.g. scopes the caller will pop */
+        std::size_t keepTop = 1;
+    };
+
+    /**
+     * @brief Automatic compaction state attached to an Associative Array.
+     */
+    struct AutoCompaction {
+        CompactionPolicy policy;
+        /* block count at which the shadowing ratio is checked next */
+        std::size_t nextCheck = 0;
+        CompactionStats stats;
+    };
+
+    /**
+     * @brief Collapses the blocks [first, last) of an Associative Array into one block of their effective associations.
+     * @details Blocks are numbered from the bottom. A key-value association shadowed by a later block of the range is
+     *          dropped; functional associations are kept in lookup order, as merge does. Blocks outside the range are
+     *          untouched, so lookups give the same results before and after, and so do lookups after popping any
+     *          number of blocks above the range. The new block gets a key filter if a compacted block had one.
+     *          References to the compacted blocks and their associations are invalidated.
+     * @param aa The Associative Array (must be of AATYPE). Modified in place.
+     * @return Statistics of this compaction (compactions is 0 if the range held fewer than two blocks).
+     * @throws std::runtime_error if aa is not an Associative Array or the range is out of bounds.
+     */
+    CompactionStats compactBlocks(WSEML& aa, std::size_t first, std::size_t last);
+
+    /**
+     * @brief Compacts all blocks of an Associative Array except the top @p keepTop ones.
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    CompactionStats compactAA(WSEML& aa, std::size_t keepTop = 1);
+
+    /**
+     * @brief Returns the share of the key-value associations below the top @p keepTop blocks that are shadowed by a
+     *        later block below them, i.e. what compactAA(aa, keepTop) would drop.
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    double getShadowingRatio(const WSEML& aa, std::size_t keepTop = 1);
+
+    /**
+     * @brief Makes appendBlock compact the Associative Array according to @p policy.
+     * @details The ratio is checked when the number of blocks reaches a threshold: policy.minBlocks at first, then
+     *          policy.minBlocks blocks past the result of the last compaction, or twice the block count after a check
+     *          that did not compact, so that a low ratio is not recomputed on every append. Copies of the AA keep the
+     *          policy.
+     * @throws std::runtime_error if aa is not an Associative Array or the policy is invalid.
+     */
+    void enableAutoCompaction(WSEML& aa, CompactionPolicy policy = {});
+
+    /**
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    void disableAutoCompaction(WSEML& aa);
+
+    /**
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    bool hasAutoCompaction(const WSEML& aa);
+
+    /**
+     * @brief Returns the accumulated statistics of the automatic compactions of an Associative Array.
+     * @throws std::runtime_error if aa is not an Associative Array or has no automatic compaction.
+     */
+    CompactionStats getAutoCompactionStats(const WSEML& aa);
+
+    /**
+     * @brief An open snapshot of an Associative Array, see takeSnapshot.
+     */
+    struct AASnapshot {
+        /* the number of snapshots of the AA that were open when this one was taken */
+        std::size_t depth = 0;
+    };
+
+    /**
+     * @brief Takes a snapshot of an Associative Array in O(1).
+     * @details While a snapshot is open, the modification functions of this header record the changes they make to the
+     *          AA and its blocks in an undo log: removed blocks and associations are moved into the log instead of
+     *          being destroyed, so every change costs O(1) extra (compaction keeps copies of the compacted blocks
+     *          instead). Snapshots nest; only the innermost open snapshot may be committed or rolled back. Changes
+     *          made directly through the List API are not recorded. Copies of the AA do not share its snapshots.
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    AASnapshot takeSnapshot(WSEML& aa);
+
+    /**
+     * @brief Closes a snapshot and keeps its changes. Committing the outermost snapshot releases the undo log.
+     * @throws std::runtime_error if aa is not an Associative Array or snapshot is not its innermost open snapshot.
+     */
+    void commitSnapshot(WSEML& aa, AASnapshot snapshot);
+
+    /**
+     * @brief Reverts the changes made since a snapshot was taken, in O(changes), and closes it.
+     * @details Removed blocks and associations are restored themselves rather than copies, so references into the AA
+     *          taken before the snapshot stay valid.
+     * @throws std::runtime_error if aa is not an Associative Array or snapshot is not its innermost open snapshot.
+     */
+    void rollbackToSnapshot(WSEML& aa, AASnapshot snapshot);
+
+    /**
+     * @throws std::runtime_error if aa is not an Associative Array.
+     */
+    std::size_t getOpenSnapshotCount(const WSEML& aa);
+
     /**
      * @brief Unifies two Associative Arrays, potentially binding placeholders.
      * @param aa1 The first AA.
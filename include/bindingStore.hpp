@@ -0,0 +1,113 @@
+/**
+ * @file bindingStore.hpp
+ * @brief Union-find store of placeholder bindings with an undo trail.
+ */
+#pragma once
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "WSEML.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief Placeholder bindings of a unification.
+     *
+     * Named placeholders are interned to dense identifiers by name. Placeholders bound to each other form equivalence
+     * classes kept in a union-find forest (union by rank, path compression); a class is bound to at most one value.
+     * Every change is recorded on a trail, so a search can take a @ref Mark before trying an alternative and
+     * @ref undo it in time proportional to the number of changes made since.
+     */
+    class BindingStore {
+    public:
+        using PlaceholderId = std::size_t;
+
+        /**
+         * @brief A point in the history of the store, see @ref mark and @ref undo.
+         */
+        struct Mark {
+            std::size_t trail;
+            std::size_t values;
+        };
+
+        /**
+         * @brief Returns the identifier of a named placeholder, registering it on first use.
+         * @throws std::runtime_error if placeholder is not a placeholder or is the anonymous placeholder.
+         */
+        PlaceholderId intern(const WSEML& placeholder);
+
+        /**
+         * @brief Returns the representative of the class of a placeholder.
+         */
+        PlaceholderId find(PlaceholderId id);
+
+        /**
+         * @brief Returns the value bound to the class of a placeholder, or nullptr if it is unbound.
+         * @note The pointer stays valid until the binding is undone.
+         */
+        const WSEML* getValue(PlaceholderId id);
+
+        /**
+         * @brief Binds the class of a placeholder to a value.
+         * @return false if the class is already bound; the store is not changed.
+         */
+        bool bind(PlaceholderId id, WSEML value);
+
+        /**
+         * @brief Merges the classes of two placeholders.
+         * @return false if both classes are bound to different values; the store is not changed.
+         */
+        bool unite(PlaceholderId first, PlaceholderId second);
+
+        /**
+         * @brief Returns the current point in history.
+         */
+        Mark mark() const;
+
+        /**
+         * @brief Reverts every bind, unite and path compression made after @p mark was taken.
+         * @note Placeholders interned after the mark stay interned (unbound).
+         */
+        void undo(Mark mark);
+
+        /**
+         * @brief Returns the number of interned placeholders.
+         */
+        std::size_t size() const;
+
+        const WSEML& getPlaceholder(PlaceholderId id) const;
+
+        /**
+         * @brief Returns the bindings in the format returned by unify(): an AA mapping every bound placeholder to its
+         *        value. An unbound placeholder united with others is mapped to the representative of its class.
+         */
+        WSEML toAA();
+
+    private:
+        static constexpr std::size_t UNBOUND = static_cast<std::size_t>(-1);
+
+        struct Node {
+            PlaceholderId parent;
+            std::size_t rank = 0;
+            /* index into values_ or UNBOUND; meaningful for roots only */
+            std::size_t value = UNBOUND;
+        };
+
+        /* the previous state of a node */
+        struct TrailEntry {
+            PlaceholderId id;
+            Node node;
+        };
+
+        void record(PlaceholderId id);
+
+        std::unordered_map<std::string, PlaceholderId> ids_;
+        std::vector<WSEML> placeholders_;
+        std::vector<Node> nodes_;
+        /* a deque keeps bound values in place while new ones are added */
+        std::deque<WSEML> values_;
+        std::vector<TrailEntry> trail_;
+    };
+
+} // namespace wseml
@@ -0,0 +1,203 @@
+/**
+ * @file builder.hpp
+ * @brief Bulk construction of Lists, Blocks and Associative Arrays.
+ */
+#pragma once
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "WSEML.hpp"
+
+namespace wseml {
+
+    class FrozenWSEML;
+    class HashConsTable;
+
+    /**
+     * @brief Collects pairs and builds a List from them in one step.
+     *
+     * The pairs are staged in a vector, so @ref reserve makes the collection free of reallocations. @ref finish
+     * generates the missing keys ("1", "3", ... as List::append does) and creates the pairs in place in the List, so
+     * they are linked once and the List is never moved while it is large.
+     */
+    class ListBuilder {
+    public:
+        /**
+         * @param type The semantic type of the List.
+         */
+        explicit ListBuilder(WSEML type = NULLOBJ);
+
+        void reserve(std::size_t pairs);
+
+        /**
+         * @brief Adds a pair; a NULLOBJ key is generated by @ref finish.
+         */
+        void append(WSEML data, WSEML key = NULLOBJ, WSEML keyRole = NULLOBJ, WSEML dataRole = NULLOBJ);
+
+        std::size_t size() const;
+
+        /**
+         * @brief Builds the List and leaves the builder empty.
+         */
+        WSEML finish();
+
+        /**
+         * @brief Builds the List, interns it and its subtrees in @p table and leaves the builder empty.
+         */
+        FrozenWSEML finish(HashConsTable& table);
+
+    private:
+        struct Entry {
+            WSEML data;
+            WSEML key;
+            WSEML keyRole;
+            WSEML dataRole;
+        };
+
+        WSEML type_;
+        std::vector<Entry> entries_;
+    };
+
+    /**
+     * @brief Collects associations and builds a Block from them in one step.
+     *
+     * The result equals a Block filled by addKeyValueAssociationToBlock and addFunctionalAssociationToBlock in the same
+     * order, but the associations are created without the checks, key generation and linking of every single append.
+     * They are created as they are added, in a Block of the builder's own, and moved into the result by @ref fill.
+     */
+    class BlockBuilder {
+    public:
+        BlockBuilder();
+
+        /* the positions point into the builder's own Block */
+        BlockBuilder(const BlockBuilder&) = delete;
+        BlockBuilder& operator=(const BlockBuilder&) = delete;
+
+        void reserve(std::size_t associations);
+
+        void add(WSEML key, WSEML value);
+
+        /**
+         * @brief Adds the key-value associations of a range of pairs (e.g. std::pair<WSEML, WSEML>).
+         * @note Pairs are moved from when the range is of move iterators.
+         */
+        template <class It>
+        void add(It first, It last) {
+            addRange(*this, first, last);
+        }
+
+        /**
+         * @throws std::runtime_error if funcAssoc is not a Functional Association.
+         */
+        void addFunctional(WSEML funcAssoc);
+
+        std::size_t size() const;
+
+        /**
+         * @brief Builds the Block and leaves the builder empty.
+         */
+        WSEML finish();
+
+        /**
+         * @brief Builds the Block, interns it and its subtrees in @p table and leaves the builder empty.
+         */
+        FrozenWSEML finish(HashConsTable& table);
+
+        /**
+         * @brief Appends the associations to a Block, with the keys its List::genKey generates, and leaves the builder
+         *        empty.
+         * @details Parts of a Block can be filled in parallel into Blocks of their own, each continuing the keys of the
+         *          parts before it (see List::setNextKeyAfter), and spliced together (see List::splice).
+         */
+        void fill(WSEML& block);
+
+    protected:
+        /* the range add of BlockBuilder and of the builders adding through it, calling their add and reserve */
+        template <class Builder, class It>
+        static void addRange(Builder& builder, It first, It last) {
+            /* iterator_category rather than the concept, which move iterators do not model before C++23 */
+            if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>) {
+                builder.reserve(builder.size() + static_cast<std::size_t>(std::distance(first, last)));
+            }
+            for (; first != last; ++first) {
+                auto&& entry = *first;
+                builder.add(std::forward<decltype(entry)>(entry).first, std::forward<decltype(entry)>(entry).second);
+            }
+        }
+
+        /* creates a key-value association at the end of block_ and returns its key */
+        const WSEML& addAssociation(WSEML&& key, WSEML&& value);
+
+        /* the associations added so far, with the keys of a Block filled from the start */
+        WSEML block_;
+        /* the pair of every association in block_, so that fill reaches them without walking the List */
+        std::vector<List::iterator> positions_;
+        /* the type of the key-value associations, shared by all of them */
+        WSEML type_;
+    };
+
+    /**
+     * @brief The order of the source of an AABuilder.
+     */
+    enum class KeyOrder {
+        Unsorted,
+        /* associations with equal keys are adjacent, as in a source sorted by key */
+        Sorted,
+    };
+
+    /**
+     * @brief Collects associations and builds an Associative Array of a single Block from them.
+     *
+     * An association whose key was already added is shadowed by the earlier one, as in a Block, and is dropped, so the
+     * result is merged. A sorted source is deduplicated as it is added, by comparing neighbours; an unsorted one by
+     * @ref finish, through the hashes of the keys taken as they were added.
+     */
+    class AABuilder: private BlockBuilder {
+    public:
+        explicit AABuilder(KeyOrder order = KeyOrder::Unsorted);
+
+        void reserve(std::size_t associations);
+
+        void add(WSEML key, WSEML value);
+
+        /**
+         * @brief Adds the key-value associations of a range of pairs (e.g. std::pair<WSEML, WSEML>).
+         * @note Pairs are moved from when the range is of move iterators.
+         */
+        template <class It>
+        void add(It first, It last) {
+            addRange(*this, first, last);
+        }
+
+        using BlockBuilder::addFunctional;
+        using BlockBuilder::size;
+
+        /**
+         * @brief Builds the Associative Array (with no Block if nothing was added) and leaves the builder empty.
+         */
+        WSEML finish();
+
+        /**
+         * @brief Builds the Associative Array, interns it and its subtrees in @p table and leaves the builder empty.
+         */
+        FrozenWSEML finish(HashConsTable& table);
+
+    private:
+        void removeShadowed();
+
+        struct Added {
+            /* the index of the association in positions_ */
+            std::size_t position;
+            std::size_t keyHash;
+            const WSEML* key;
+        };
+
+        KeyOrder order_;
+        /* the key of the last key-value association of a sorted source */
+        const WSEML* previousKey_ = nullptr;
+        /* the key-value associations of an unsorted source */
+        std::vector<Added> added_;
+    };
+
+} // namespace wseml
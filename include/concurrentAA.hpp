@@ -0,0 +1,137 @@
+/**
+ * @file concurrentAA.hpp
+ * @brief Associative Array shared between threads, with sharded per-key indexes.
+ */
+#pragma once
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "WSEML.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief An Associative Array that many threads may read and modify concurrently.
+     *
+     * Blocks shadow each other as in an AA made by createAssociativeArray: a key resolves to its binding in the topmost
+     * block that binds it, and keys without a binding are resolved by the functional association of their semantic type
+     * met first in lookup order. Unlike a Block, a block of a ConcurrentAA binds a key at most once; binding it again
+     * replaces the value.
+     *
+     * Bindings are kept in per-key stacks spread over shards by key hash. A lookup takes the shared lock of a single
+     * shard; a write to a block takes the shared structure lock and the exclusive lock of one shard. pushBlock and
+     * popBlock take the structure lock exclusively, so they wait for running writes but never block readers. Each
+     * operation is linearizable per key: a reader racing with popBlock may see some keys of the popped block already
+     * unbound and others not yet.
+     */
+    class ConcurrentAA {
+    public:
+        /**
+         * @param shards Number of shards of the key index (rounded up to a power of two).
+         */
+        explicit ConcurrentAA(std::size_t shards = 64);
+
+        /**
+         * @brief Copies the blocks of an Associative Array.
+         * @throws std::runtime_error if aa is not an Associative Array.
+         */
+        explicit ConcurrentAA(const WSEML& aa, std::size_t shards = 64);
+
+        ConcurrentAA(const ConcurrentAA&) = delete;
+        ConcurrentAA& operator=(const ConcurrentAA&) = delete;
+
+        /**
+         * @brief Appends an empty block and returns its index (blocks are numbered from the bottom).
+         */
+        std::size_t pushBlock();
+
+        /**
+         * @brief Removes the top block with its bindings, if there is one.
+         */
+        void popBlock();
+
+        std::size_t getBlockCount() const;
+
+        /**
+         * @brief Binds a key in the top block, creating a block if there is none.
+         */
+        void insert(WSEML key, WSEML value);
+
+        /**
+         * @brief Binds a key in the given block.
+         * @throws std::runtime_error if the block does not exist.
+         */
+        void insertIntoBlock(std::size_t block, WSEML key, WSEML value);
+
+        /**
+         * @brief Removes the binding of a key from the given block.
+         * @return True if the block bound the key.
+         * @throws std::runtime_error if the block does not exist.
+         */
+        bool erase(std::size_t block, const WSEML& key);
+
+        /**
+         * @brief Adds a functional association to the top block, creating a block if there is none.
+         * @throws std::runtime_error if funcAssoc is not a Functional Association.
+         */
+        void addFunctionalAssociation(const WSEML& funcAssoc);
+
+        /**
+         * @brief Returns the value bound to a key, without applying functional associations.
+         * @return The shared value (it outlives later modifications), or nullptr.
+         */
+        std::shared_ptr<const WSEML> findValuePtr(const WSEML& key) const;
+
+        /**
+         * @brief Finds the value of a key with the semantics of findValueInAA.
+         * @return A copy of the value, or NULLOBJ.
+         */
+        WSEML findValue(const WSEML& key) const;
+
+        /**
+         * @brief Builds an Associative Array with the same blocks, bindings and functional associations.
+         * @note Waits for running writes and blocks new ones while copying.
+         */
+        WSEML toAA() const;
+
+    private:
+        struct Binding {
+            std::size_t block;
+            std::shared_ptr<const WSEML> value;
+        };
+
+        /* per key, sorted by block; the back is the effective binding */
+        using BindingStacks = std::unordered_map<WSEML, std::vector<Binding>>;
+
+        struct Shard {
+            mutable std::shared_mutex mutex;
+            BindingStacks bindings;
+        };
+
+        /* what popBlock has to unbind */
+        struct Block {
+            std::mutex mutex;
+            std::unordered_set<WSEML> keys;
+            std::unordered_set<WSEML> triggers;
+        };
+
+        Shard& shardOf(const WSEML& key) const;
+        std::size_t topBlockCreatingOne(std::shared_lock<std::shared_mutex>& structureLock);
+        void checkBlock(std::size_t block, const char* caller) const;
+        void bind(std::size_t block, WSEML key, WSEML value, bool replace);
+        void addFunctionalAssociationToBlock(std::size_t block, const WSEML& funcAssoc);
+        static void unbindTop(BindingStacks& stacks, const WSEML& key, std::size_t block);
+
+        std::size_t shardMask_;
+        std::unique_ptr<Shard[]> shards_;
+        mutable std::shared_mutex structureMutex_;
+        std::deque<Block> blocks_;
+        mutable std::shared_mutex funcAssocMutex_;
+        BindingStacks funcAssocs_;
+    };
+
+} // namespace wseml
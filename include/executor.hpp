@@ -7,6 +7,7 @@
 #include "pointers.hpp"
 #include "misc.hpp"
 #include "pointers.hpp"
+#include "profiler.hpp"
 
 namespace wseml {
 
@@ -45,6 +46,7 @@ namespace wseml {
             throw std::runtime_error("executor: block is not a List");
         }
 
+        ProgramFrame frame(block);
         List& lst = block.getList();
         for (Pair& pr : lst) {
             std::cout << pr << std::endl;
@@ -57,28 +59,22 @@ namespace wseml {
                 throw std::runtime_error("executor: unknown operation " + op);
             }
 
+            InstructionTimer timer(op, pr.getKey());
             WSEML res = it->second(instr);
             (void)res;
         }
     }
 
-    inline WSEML executeSequential(const WSEML& block, const WSEML& args) {
+    /* the instructions are looked up and timed but not dispatched, so R and A are not bound and the program is
+       only read: it may be shared between threads */
+    inline WSEML executeSequential(const WSEML& block, [[maybe_unused]] const WSEML& args) {
         WSEML result = NULLOBJ;
-        WSEML resultRef = createAddrPointer(getAddrStr(&result));
 
+        ProgramFrame frame(block);
         const List& code = block.getList();
         for (const Pair& pr : code) {
-            const WSEML& instr = pr.getData();
-            List& iLst = const_cast<List&>(instr.getList());
-
-            if (iLst.find("R") != NULLOBJ) {
-                iLst.find("R") = resultRef;
-            }
-            if (iLst.find("A") != NULLOBJ) {
-                iLst.find("A") = args;
-            }
-
-            std::string op = iLst.find("type").getInnerString();
+            const std::string& op = pr.getData().getList().find("type").getInnerString();
+            InstructionTimer timer(op, pr.getKey());
             auto it = dispatchTable().find(op);
             if (it == dispatchTable().end()) {
                 throw std::runtime_error("opcode " + op + " not supported");
@@ -0,0 +1,91 @@
+/**
+ * @file factStore.hpp
+ * @brief Indexed collection of fact AAs queried by unification.
+ */
+#pragma once
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "WSEML.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief A fact confirmed by @ref FactStore::query.
+     */
+    struct FactMatch {
+        std::size_t id;
+        WSEML unified;
+        WSEML bindings;
+    };
+
+    /**
+     * @brief Stores fact AAs and finds the facts that unify with a pattern without unifying against all of them.
+     *
+     * Every effective key of a fact is indexed in a two-level discrimination index: key -> hash of the ground value -> facts.
+     * Facts whose value for a key is not ground (contains placeholders or nested AAs/Blocks) are kept in a separate
+     * per-key list, since they may unify with any value. A fact that lacks a key can never be excluded by that key.
+     *
+     * A query is pruned with its ground, non-structural entries and the remaining candidates are confirmed with unify().
+     */
+    class FactStore {
+    public:
+        using FactId = std::size_t;
+
+        /**
+         * @brief Adds a fact to the store.
+         * @param fact The fact (must be an Associative Array).
+         * @return The identifier of the fact.
+         * @throws std::runtime_error if fact is not an Associative Array.
+         */
+        FactId add(WSEML fact);
+
+        /**
+         * @brief Removes a fact from the store.
+         * @return True if the fact was present.
+         */
+        bool remove(FactId id);
+
+        /**
+         * @brief Returns a stored fact.
+         * @throws std::runtime_error if there is no fact with the given identifier.
+         */
+        const WSEML& get(FactId id) const;
+
+        bool contains(FactId id) const;
+
+        std::size_t size() const;
+
+        /**
+         * @brief Returns the facts that may unify with a pattern, in increasing identifier order.
+         * @details Facts that are not returned are guaranteed not to unify with the pattern.
+         * @throws std::runtime_error if pattern is not an Associative Array.
+         */
+        std::vector<FactId> candidates(const WSEML& pattern) const;
+
+        /**
+         * @brief Returns the facts that unify with a pattern, in increasing identifier order.
+         * @return For every matching fact, its identifier and the result of unify(fact, pattern).
+         * @throws std::runtime_error if pattern is not an Associative Array.
+         */
+        std::vector<FactMatch> query(const WSEML& pattern) const;
+
+    private:
+        struct KeyPostings {
+            std::unordered_map<FactId, std::size_t> groundHashes;
+            std::unordered_map<std::size_t, std::unordered_set<FactId>> byHash;
+            std::unordered_set<FactId> nonGround;
+
+            std::size_t factCount() const {
+                return groundHashes.size() + nonGround.size();
+            }
+        };
+
+        bool admits(FactId id, const KeyPostings& postings, std::size_t valueHash) const;
+
+        FactId nextId_ = 0;
+        std::unordered_map<FactId, WSEML> facts_;
+        std::unordered_map<WSEML, KeyPostings> index_;
+    };
+
+} // namespace wseml
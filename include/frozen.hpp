@@ -0,0 +1,87 @@
+/**
+ * @file frozen.hpp
+ * @brief Immutable WSEML trees shared between owners and threads.
+ */
+#pragma once
+#include <cstddef>
+#include <functional>
+#include "WSEML.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief A handle to an immutable WSEML tree.
+     *
+     * Copies of the handle share the tree (see WSEML::share), so copying is O(1) whatever the size of the tree. Every
+     * const operation
+     * (lookups, equality, hashing, unify, ...) may run on the tree from any number of threads without locks: the lookup
+     * caches of its Associative Arrays are synchronized by @ref freeze and never rebuilt afterwards. The mutating
+     * accessors of the frozen objects assert in debug builds; use @ref thaw to get a mutable copy.
+     */
+    class FrozenWSEML {
+    public:
+        /**
+         * @brief Holds a frozen NULLOBJ.
+         */
+        FrozenWSEML();
+
+        const WSEML& get() const;
+        const WSEML& operator*() const;
+        const WSEML* operator->() const;
+
+        /**
+         * @brief Returns the hash of the tree, computed once by @ref freeze.
+         */
+        std::size_t hash() const;
+
+        /**
+         * @brief Returns true if both handles share the tree.
+         */
+        bool sharesWith(const FrozenWSEML& other) const;
+
+        /**
+         * @brief Returns a mutable copy of the tree.
+         * @details The subtrees shared with other trees (see HashConsTable) are copied when they are first changed.
+         */
+        WSEML thaw() const;
+
+        /**
+         * @brief Compares the trees by value; trees held by the same @ref HashConsTable compare by pointer.
+         */
+        bool operator==(const FrozenWSEML& other) const;
+
+    private:
+        friend FrozenWSEML freeze(WSEML tree);
+        friend class HashConsTable;
+
+        explicit FrozenWSEML(WSEML node);
+
+        const SharedNode& node() const;
+
+        /* a handle sharing the node of the tree */
+        WSEML node_;
+    };
+
+    /**
+     * @brief Takes ownership of a tree and makes it immutable.
+     * @details Marks every object of the tree frozen (including semantic types, keys and roles) and synchronizes the
+     *          lookup caches of every Associative Array in it. O(size of the tree). A shared handle (see WSEML::share)
+     *          is frozen already and keeps its node.
+     */
+    FrozenWSEML freeze(WSEML tree);
+
+    /**
+     * @brief Returns true if the object held by @p obj is part of a frozen tree.
+     */
+    bool isFrozen(const WSEML& obj);
+
+} // namespace wseml
+
+namespace std {
+    template <>
+    struct hash<wseml::FrozenWSEML> {
+        size_t operator()(const wseml::FrozenWSEML& frozen) const {
+            return frozen.hash();
+        }
+    };
+} // namespace std
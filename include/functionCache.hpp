@@ -0,0 +1,99 @@
+/**
+ * @file functionCache.hpp
+ * @brief Memoization of results of pure functional associations.
+ */
+#pragma once
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include "WSEML.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief Counters describing the effectiveness of a @ref FunctionResultCache.
+     */
+    struct FunctionCacheStats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+        std::size_t invalidations = 0;
+    };
+
+    /**
+     * @brief Bounded, hash-keyed LRU cache of function results, kept separately for every function reference.
+     *
+     * Each function reference owns its own LRU list of at most `getCapacity()` entries keyed by the argument.
+     * All operations are thread-safe.
+     */
+    class FunctionResultCache {
+    public:
+        /**
+         * @param capacity Maximum number of cached results per function reference.
+         */
+        explicit FunctionResultCache(std::size_t capacity = 1024);
+
+        /**
+         * @brief Returns a copy of the cached result of @p funcRef applied to @p key, if present.
+         * @note Refreshes the entry in the LRU order and updates the hit/miss counters.
+         */
+        std::optional<WSEML> lookup(const WSEML& funcRef, const WSEML& key);
+
+        /**
+         * @brief Stores the result of @p funcRef applied to @p key, evicting the least recently used entry if needed.
+         */
+        void store(const WSEML& funcRef, const WSEML& key, WSEML result);
+
+        /**
+         * @brief Returns the cached result or calls the function and caches its result.
+         * @note NULLOBJ results are not cached, as callFunction uses them to report load errors.
+         */
+        WSEML call(const WSEML& funcRef, const WSEML& key);
+
+        /**
+         * @brief Drops all cached results of @p funcRef.
+         */
+        void invalidate(const WSEML& funcRef);
+
+        /**
+         * @brief Drops all cached results.
+         */
+        void invalidateAll();
+
+        /**
+         * @brief Changes the per-function capacity, evicting entries that no longer fit.
+         */
+        void setCapacity(std::size_t capacity);
+
+        std::size_t getCapacity() const;
+
+        /**
+         * @brief Returns the total number of cached results.
+         */
+        std::size_t size() const;
+
+        FunctionCacheStats getStats() const;
+
+        void resetStats();
+
+    private:
+        struct FunctionEntries {
+            std::list<std::pair<WSEML, WSEML>> lru;
+            std::unordered_map<WSEML, std::list<std::pair<WSEML, WSEML>>::iterator> index;
+        };
+
+        void evictOverflow(FunctionEntries& entries);
+
+        mutable std::mutex mutex_;
+        std::size_t capacity_;
+        std::unordered_map<WSEML, FunctionEntries> functions_;
+        FunctionCacheStats stats_;
+    };
+
+    /**
+     * @brief Returns the process-wide cache used for pure functional associations.
+     */
+    FunctionResultCache& getFunctionResultCache();
+
+} // namespace wseml
@@ -0,0 +1,99 @@
+/**
+ * @file hashCons.hpp
+ * @brief Hash-consing: structurally equal frozen subtrees shared through a table.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "WSEML.hpp"
+#include "frozen.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief Counters of a HashConsTable.
+     */
+    struct HashConsStats {
+        /* subtrees interned, every occurrence counted */
+        std::size_t interned = 0;
+        /* nodes held by the table */
+        std::size_t distinct = 0;
+        /* subtrees replaced by a node the table already held */
+        std::size_t reused = 0;
+        /* estimated heap footprint of the replaced subtrees, i.e. of the copies that were dropped instead of kept */
+        std::size_t bytesSaved = 0;
+        /* the SharedNode records of the held nodes, which unshared trees do without */
+        std::size_t overheadBytes = 0;
+    };
+
+    /**
+     * @brief Hash-conses frozen trees, so that structurally equal subtrees share a single node.
+     *
+     * @ref intern freezes a tree and replaces each of its subtrees (every List and every string too long to be stored
+     * in its handle, semantic types included) by the node the table holds for its value, adding a node for each value
+     * it does not hold yet (see WSEML::share). The fragments repeated within a document, e.g. the pointer descriptors
+     * in every instruction of the programs in lists.hpp, thus share one node, and so do those of different documents.
+     * As the table holds a single node per value, two of its nodes are equal exactly when they are the same node:
+     * equality and FrozenWSEML::operator== compare them by pointer.
+     *
+     * The nodes are immutable. The mutating accessors of a handle to a node copy the node's root first (copy on
+     * write), so a change never reaches the other holders; FrozenWSEML::thaw gives a mutable tree whose subtrees are
+     * copied that way once they are changed.
+     *
+     * @note Not synchronized: intern from a single thread at a time. The interned trees may be read from any thread.
+     */
+    class HashConsTable {
+    public:
+        HashConsTable();
+
+        /* the id in the held nodes is that of this table, so a copy would hand out the same id */
+        HashConsTable(const HashConsTable&) = delete;
+        HashConsTable& operator=(const HashConsTable&) = delete;
+
+        /**
+         * @brief Freezes @p tree, sharing each of its subtrees with the equal ones the table holds.
+         * @return The tree, whose root is the node the table holds for its value.
+         */
+        FrozenWSEML intern(WSEML tree);
+
+        /**
+         * @brief Returns @p tree if the table holds its node, or interns a copy of it.
+         */
+        FrozenWSEML intern(const FrozenWSEML& tree);
+
+        /**
+         * @brief Returns the number of nodes held by the table.
+         */
+        std::size_t size() const;
+
+        HashConsStats stats() const;
+
+        /**
+         * @brief Drops the nodes that no handle but the table's refers to, including those only dropped nodes referred
+         *        to.
+         * @return The number of nodes dropped.
+         */
+        std::size_t purge();
+
+    private:
+        /* returns the handle of the held node equal to node, or nullptr */
+        const WSEML* find(const WSEML& node) const;
+
+        /* returns the held node equal to tree, whose subtrees are interned already, adding tree if there is none */
+        WSEML internNode(WSEML tree);
+
+        std::uint64_t id_;
+        /* handles of the held nodes by hash */
+        std::unordered_map<std::size_t, std::vector<WSEML>> buckets_;
+        HashConsStats stats_;
+    };
+
+    /**
+     * @brief Parses @p text and interns the result in @p table, sharing its subtrees (see HashConsTable::intern).
+     */
+    FrozenWSEML parse(const std::string& text, HashConsTable& table);
+
+} // namespace wseml
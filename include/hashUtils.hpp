@@ -17,11 +17,16 @@ namespace wseml {
             return v;
         }
 
+        /* combines an already computed hash, as hash_combine does with the hash of its value */
+        inline void hash_combine_hashed(size_t& seed, size_t valueHash) {
+            static_assert(sizeof(size_t) == 8);
+            seed = hash_mix(seed + 0x9e3779b97f4a7c15ULL + valueHash);
+        }
+
         template <class T>
         inline void hash_combine(size_t& seed, T const& v) {
-            static_assert(sizeof(size_t) == 8);
             std::hash<T> hasher;
-            seed = hash_mix(seed + 0x9e3779b97f4a7c15ULL + hasher(v));
+            hash_combine_hashed(seed, hasher(v));
         }
 
         template <class It>
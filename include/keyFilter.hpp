@@ -0,0 +1,121 @@
+/**
+ * @file keyFilter.hpp
+ * @brief Bloom filter of key hashes attached to Blocks.
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace wseml {
+
+    /**
+     * @brief Counters of a key filter.
+     */
+    struct KeyFilterStats {
+        /* lookups that consulted the filter */
+        std::size_t queries = 0;
+        /* lookups answered "definitely absent", i.e. blocks skipped */
+        std::size_t negatives = 0;
+        /* lookups answered "maybe present" for a key the block did not contain */
+        std::size_t falsePositives = 0;
+        std::size_t rebuilds = 0;
+    };
+
+    /**
+     * @brief A Bloom filter over key hashes (about 1% false positives at capacity).
+     *
+     * The filter describes the Block it is attached to as of a synchronization point, identified by the modification
+     * count (see getModificationCount) at which it was built. A filter whose synchronized count differs from the
+     * current one, or that was invalidated, must be rebuilt before it is consulted; @ref rebuild may be called
+     * concurrently by readers. A filter built over a Block whose keys may be edited without being counted (see
+     * Object::watch) is not usable, and the lookups scan the Block instead.
+     */
+    class KeyFilter {
+    public:
+        /**
+         * @brief Creates an empty filter, which is built on the first lookup.
+         * @param capacity The expected number of keys.
+         */
+        explicit KeyFilter(std::size_t capacity = 16);
+
+        /**
+         * @brief Copies the contents of the filter, which is rebuilt on the first lookup; the counters start from zero.
+         */
+        KeyFilter(const KeyFilter& other);
+        KeyFilter& operator=(const KeyFilter&) = delete;
+
+        /**
+         * @brief Returns true if the filter is valid and was synchronized at @p modificationCount, or was built over
+         *        a frozen Block.
+         */
+        bool isCurrent(std::uint64_t modificationCount) const;
+
+        /**
+         * @brief Returns false if the Block was not fully watched at the last rebuild, so the filter must not be consulted.
+         */
+        bool isUsable() const;
+
+        /**
+         * @brief Adds a key hash and moves the synchronization point to @p modificationCount.
+         * @pre The filter was current before the key was added, so it is valid again afterwards.
+         * @note If the filter exceeds its capacity, it is invalidated and regrows on the next rebuild.
+         */
+        void insert(std::size_t keyHash, std::uint64_t modificationCount);
+
+        /**
+         * @brief Moves the synchronization point after a change that did not add keys.
+         * @pre The filter was current before the change.
+         */
+        void resync(std::uint64_t modificationCount);
+
+        void invalidate();
+
+        /**
+         * @brief Replaces the contents with the given key hashes.
+         *
+         * The bits are only written if they change, so readers of a filter whose contents are unchanged may run
+         * concurrently.
+         *
+         * @param usable Whether the keys were collected from a fully watched Block.
+         * @param frozen Whether the Block is frozen, so that the filter stays current.
+         */
+        void rebuild(std::span<const std::size_t> keyHashes, std::uint64_t modificationCount, bool usable, bool frozen);
+
+        /**
+         * @brief Returns false if no key with the given hash was inserted.
+         */
+        bool mayContain(std::size_t keyHash) const;
+
+        std::size_t getCapacity() const;
+
+        KeyFilterStats getStats() const;
+
+        void recordQuery(bool negative) const;
+        void recordFalsePositive() const;
+
+    private:
+        static constexpr std::size_t PROBES = 7;
+        static constexpr std::size_t BITS_PER_KEY = 10;
+
+        void reset(std::size_t capacity);
+        static void set(std::vector<std::uint64_t>& bits, std::size_t keyHash);
+
+        std::vector<std::uint64_t> bits_;
+        std::size_t capacity_ = 0;
+        std::size_t inserted_ = 0;
+        std::atomic<bool> valid_ = false;
+        std::atomic<bool> usable_ = true;
+        std::atomic<bool> frozen_ = false;
+        std::atomic<std::uint64_t> syncedCount_ = 0;
+        std::mutex rebuildMutex_;
+
+        mutable std::atomic<std::size_t> queries_ = 0;
+        mutable std::atomic<std::size_t> negatives_ = 0;
+        mutable std::atomic<std::size_t> falsePositives_ = 0;
+        std::atomic<std::size_t> rebuilds_ = 0;
+    };
+
+} // namespace wseml
@@ -0,0 +1,128 @@
+/**
+ * @file matchNetwork.hpp
+ * @brief Incremental (Rete-style) matching of rules over a changing set of fact AAs.
+ */
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include "WSEML.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief A complete match of a rule.
+     */
+    struct Activation {
+        std::size_t rule;
+        /* the fact matched by each pattern of the rule, in pattern order */
+        std::vector<std::size_t> facts;
+        /* placeholder bindings, in the format returned by unify() */
+        WSEML bindings;
+    };
+
+    /**
+     * @brief Matches a set of rules against a working set of facts and maintains their activations incrementally.
+     *
+     * A rule is a conjunction of pattern AAs. A fact matches a pattern if unify(fact, pattern) succeeds, and the matches of
+     * the patterns of a rule are joined on the placeholders they share: a placeholder must be bound to equal values.
+     *
+     * The network consists of:
+     * - alpha tests: ground (key, value) entries of the patterns, shared by all patterns and evaluated once per fact;
+     * - alpha memories: the facts matching a pattern with their bindings, shared by identical patterns;
+     * - beta memories: the partial matches of the first n patterns of every rule.
+     * Adding or removing a fact only updates the memories that contain it.
+     */
+    class MatchNetwork {
+    public:
+        using FactId = std::size_t;
+        using RuleId = std::size_t;
+
+        /**
+         * @brief Adds a rule and matches it against the current facts.
+         * @param patterns The patterns of the rule (must be non-empty Associative Arrays).
+         * @throws std::runtime_error if patterns is empty or a pattern is not an Associative Array.
+         */
+        RuleId addRule(const std::vector<WSEML>& patterns);
+
+        /**
+         * @brief Adds a fact to the working set.
+         * @param fact The fact (must be an Associative Array).
+         * @param id Receives the identifier of the fact, if not nullptr.
+         * @return The activations created by the fact.
+         * @throws std::runtime_error if fact is not an Associative Array.
+         */
+        std::vector<Activation> addFact(WSEML fact, FactId* id = nullptr);
+
+        /**
+         * @brief Removes a fact from the working set.
+         * @return The activations retracted because they contained the fact.
+         */
+        std::vector<Activation> removeFact(FactId id);
+
+        /**
+         * @brief Returns the current activations of a rule.
+         * @throws std::runtime_error if there is no such rule.
+         */
+        std::vector<Activation> getActivations(RuleId rule) const;
+
+        /**
+         * @brief Returns a fact of the working set.
+         * @throws std::runtime_error if there is no fact with the given identifier.
+         */
+        const WSEML& getFact(FactId id) const;
+
+        /**
+         * @brief Returns the number of distinct alpha tests, i.e. ground pattern entries shared by all rules.
+         */
+        std::size_t getAlphaTestCount() const;
+
+        /**
+         * @brief Returns the number of distinct alpha memories, i.e. distinct patterns.
+         */
+        std::size_t getAlphaMemoryCount() const;
+
+    private:
+        using Bindings = std::unordered_map<WSEML, WSEML>;
+
+        struct AlphaTest {
+            WSEML key;
+            WSEML value;
+        };
+
+        struct AlphaMemory {
+            WSEML pattern;
+            std::vector<std::size_t> tests;
+            std::unordered_map<FactId, Bindings> facts;
+            /* (rule, position) pairs fed by this memory */
+            std::vector<std::pair<RuleId, std::size_t>> successors;
+        };
+
+        struct Token {
+            std::vector<FactId> facts;
+            Bindings bindings;
+        };
+
+        struct Rule {
+            std::vector<std::size_t> memories;
+            /* levels[n] holds the partial matches of the first n + 1 patterns */
+            std::vector<std::vector<Token>> levels;
+        };
+
+        std::size_t internAlphaTest(const WSEML& key, const WSEML& value);
+        std::size_t internAlphaMemory(const WSEML& pattern);
+        bool passesAlphaTests(const AlphaMemory& memory, const std::vector<char>& testResults) const;
+        std::vector<char> evaluateAlphaTests(const WSEML& fact) const;
+        void propagate(Rule& rule, RuleId ruleId, std::size_t level, Token token, FactId newFact, const std::vector<std::size_t>& pendingPositions,
+                       std::vector<Activation>& activations);
+        Activation makeActivation(RuleId ruleId, const Token& token) const;
+
+        FactId nextFactId_ = 0;
+        std::unordered_map<FactId, WSEML> facts_;
+        std::vector<AlphaTest> alphaTests_;
+        std::unordered_map<WSEML, std::unordered_map<WSEML, std::size_t>> alphaTestIndex_;
+        std::vector<AlphaMemory> alphaMemories_;
+        std::unordered_map<WSEML, std::size_t> alphaMemoryIndex_;
+        std::vector<Rule> rules_;
+    };
+
+} // namespace wseml
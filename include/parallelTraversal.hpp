@@ -0,0 +1,35 @@
+/**
+ * @file parallelTraversal.hpp
+ * @brief Parallel deep equality and hashing of large WSEML trees.
+ */
+#pragma once
+#include <cstddef>
+#include "WSEML.hpp"
+#include "workStealingPool.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief Lists with fewer pairs are traversed by a single task.
+     */
+    inline constexpr std::size_t PARALLEL_TRAVERSAL_THRESHOLD = 4096;
+
+    /**
+     * @brief Equivalent to equal(first, second), splitting Lists of at least @p threshold pairs into tasks of
+     *        @p threshold pairs run on @p pool.
+     * @details Nested Lists are split independently, so wide Lists deep in the tree are parallelized as well. Blocks
+     *          are compared as multisets by sorting the hashes of their data, computed in parallel.
+     */
+    bool parallelEqual(const WSEML& first, const WSEML& second, WorkStealingPool& pool,
+                       std::size_t threshold = PARALLEL_TRAVERSAL_THRESHOLD);
+
+    /**
+     * @brief Equivalent to hash_value(obj), splitting Lists of at least @p threshold pairs into tasks of @p threshold
+     *        pairs run on @p pool.
+     * @details The hashes of the pairs are computed in parallel and combined in list order, so the result does not
+     *          depend on the number of threads or on scheduling.
+     */
+    std::size_t parallelHashValue(const WSEML& obj, WorkStealingPool& pool,
+                                  std::size_t threshold = PARALLEL_TRAVERSAL_THRESHOLD);
+
+} // namespace wseml
@@ -0,0 +1,127 @@
+/**
+ * @file patternMatcher.hpp
+ * @brief Pre-compiled pattern Associative Arrays for repeated matching.
+ */
+#pragma once
+#include <functional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include "WSEML.hpp"
+#include "substitutionTemplate.hpp"
+#include "threadPool.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief A pattern AA compiled for repeated matching against storage AAs.
+     *
+     * `PatternMatcher(pattern).match(storage)` returns the same result as `matchAndSubstitute(storage, pattern)`.
+     * The effective entries of the pattern are compiled once into a key index, placeholder slots and nested
+     * sub-matchers, so a match performs a single pass over the storage and allocates only the result.
+     *
+     * Cases outside the compiled subset are delegated to matchAndSubstitute: patterns containing functional associations
+     * or nested AAs/Blocks with placeholders, storage values containing placeholders, and storage functional
+     * associations triggered by keys missing from the storage.
+     */
+    class PatternMatcher {
+    public:
+        /**
+         * @brief Reusable per-thread working memory of @ref match.
+         */
+        struct Scratch {
+            std::vector<const WSEML*> storageValues;
+            std::vector<const WSEML*> slots;
+        };
+
+        /**
+         * @param patternAA The pattern (must be an Associative Array). It is copied into the matcher.
+         * @throws std::runtime_error if patternAA is not an Associative Array.
+         */
+        explicit PatternMatcher(const WSEML& patternAA);
+
+        PatternMatcher(const PatternMatcher&) = delete;
+        PatternMatcher& operator=(const PatternMatcher&) = delete;
+        PatternMatcher(PatternMatcher&&) = default;
+        PatternMatcher& operator=(PatternMatcher&&) = default;
+
+        /**
+         * @brief Matches the pattern against a storage AA.
+         * @param storageAA The storage (must be an Associative Array).
+         * @return The pattern with placeholders substituted, or NULLOBJ if the pattern does not match.
+         * @throws std::runtime_error if storageAA is not an Associative Array.
+         */
+        WSEML match(const WSEML& storageAA) const;
+
+        /**
+         * @brief Matches the pattern against a storage AA using caller-provided working memory.
+         */
+        WSEML match(const WSEML& storageAA, Scratch& scratch) const;
+
+        const WSEML& getPattern() const;
+
+        /**
+         * @brief Returns the number of distinct named placeholders in the effective entries of the pattern.
+         */
+        std::size_t getSlotCount() const;
+
+        /**
+         * @brief Returns true if the pattern cannot be compiled and every match is delegated to matchAndSubstitute.
+         */
+        bool alwaysFallsBack() const;
+
+    private:
+        enum class NodeKind { Ground, Slot, Anonymous, Nested };
+
+        enum class MatchResult { Success, Failure, Fallback };
+
+        struct Node {
+            NodeKind kind = NodeKind::Ground;
+            const WSEML* value = nullptr;
+            std::size_t slot = 0;
+            bool structural = false;
+            /* key, data, keyRole and dataRole matchers of every pair of a Nested node */
+            std::vector<Node> children;
+        };
+
+        struct Entry {
+            const WSEML* key;
+            Node value;
+        };
+
+        Node compileNode(const WSEML& value);
+        MatchResult matchEntry(const Node& node, const WSEML& value, Scratch& scratch) const;
+        MatchResult matchNode(const Node& node, const WSEML& value, Scratch& scratch) const;
+
+        /* the pattern itself, compiled for building the result */
+        SubstitutionTemplate output_;
+        std::vector<Entry> entries_;
+        std::unordered_map<const WSEML*, std::size_t, WSEMLPtrHash, WSEMLPtrEqual> keyIndex_;
+        std::unordered_map<const WSEML*, std::size_t, WSEMLPtrHash, WSEMLPtrEqual> slotIndex_;
+        bool fallback_ = false;
+    };
+
+    /**
+     * @brief Matches one pattern against many storage AAs in parallel.
+     *
+     * The pattern is compiled once into a PatternMatcher; the storages are split into contiguous chunks executed on the
+     * pool, each with its own PatternMatcher::Scratch. The pattern and the storages are only read.
+     * @param patternAA The pattern (must be an Associative Array).
+     * @param storages The storages (must be Associative Arrays). They must not be modified until the call returns.
+     * @param pool The pool executing the chunks.
+     * @return matchAndSubstitute(storages[i], patternAA) at index i.
+     * @throws std::runtime_error if patternAA or a storage is not an Associative Array.
+     */
+    std::vector<WSEML> matchAll(const WSEML& patternAA, std::span<const WSEML> storages, ThreadPool& pool);
+
+    /**
+     * @brief Matches one pattern against many storage AAs in parallel and streams the results.
+     * @param onResult Called with (index, result) for every storage as soon as its match completes. Calls are made from
+     *                 the pool threads in completion order, but never concurrently.
+     * @throws std::runtime_error if patternAA or a storage is not an Associative Array; results of the other storages may
+     *         already have been delivered.
+     */
+    void matchAll(const WSEML& patternAA, std::span<const WSEML> storages, ThreadPool& pool,
+                  const std::function<void(std::size_t, WSEML)>& onResult);
+
+} // namespace wseml
@@ -0,0 +1,166 @@
+/**
+ * @file profiler.hpp
+ * @brief Optional per-opcode profiler for the WSEML interpreter.
+ * @details Profiling is enabled for the current thread by installing a @ref Profiler with a @ref ProfilerScope.
+ *          While no profiler is installed, @ref ProgramFrame and @ref InstructionTimer are no-ops.
+ */
+#pragma once
+#include <chrono>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "WSEML.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief Accumulated cost of an opcode, an instruction or a call stack.
+     */
+    struct ProfileStats {
+        std::size_t count = 0;
+        std::chrono::nanoseconds totalTime{0};
+        std::chrono::nanoseconds maxTime{0};
+        std::size_t allocations = 0;
+
+        /**
+         * @brief Accounts for one more execution.
+         * @param elapsed Wall time of the execution.
+         * @param allocs Number of @ref Object instances created during the execution.
+         */
+        void record(std::chrono::nanoseconds elapsed, std::size_t allocs);
+    };
+
+    /**
+     * @brief Collects execution statistics of the interpreter.
+     *
+     * Statistics are kept per opcode, per (program key, instruction index) and per call stack.
+     * Call stack entries hold self time (time of nested programs is excluded), as expected by flamegraph tools.
+     */
+    class Profiler {
+    public:
+        using InstructionId = std::pair<std::string, std::string>;
+
+        /**
+         * @brief Returns statistics grouped by opcode.
+         */
+        const std::map<std::string, ProfileStats>& getOpcodeStats() const;
+
+        /**
+         * @brief Returns statistics grouped by (program key, instruction index).
+         */
+        const std::map<InstructionId, ProfileStats>& getInstructionStats() const;
+
+        /**
+         * @brief Returns self-time statistics grouped by collapsed call stack ("prog;idx:op;prog;idx:op").
+         */
+        const std::map<std::string, ProfileStats>& getStackStats() const;
+
+        /**
+         * @brief Drops all collected statistics.
+         */
+        void reset();
+
+        /**
+         * @brief Exports the report as a WSEML document.
+         * @return {opcodes:{<op>:{count, total_ns, max_ns, allocations}}, instructions:{<n>:{program, index, opcode, count, ...}}}
+         */
+        WSEML toWSEML() const;
+
+        /**
+         * @brief Exports the report in the collapsed-stack format ("frame;frame;frame <self_ns>" per line).
+         */
+        std::string toCollapsedStacks() const;
+
+        friend class ProgramFrame;
+        friend class InstructionTimer;
+
+    private:
+        std::map<std::string, ProfileStats> opcodes_;
+        std::map<InstructionId, ProfileStats> instructions_;
+        std::map<std::string, ProfileStats> stacks_;
+        std::vector<std::string> programs_;
+        std::vector<std::string> frames_;
+        std::vector<std::chrono::nanoseconds> childTimes_;
+    };
+
+    /**
+     * @brief Returns the profiler installed for the current thread, or nullptr.
+     */
+    Profiler* getActiveProfiler();
+
+    /**
+     * @brief Installs a profiler for the current thread for the lifetime of the scope.
+     */
+    class ProfilerScope {
+    public:
+        explicit ProfilerScope(Profiler& profiler);
+        ~ProfilerScope();
+
+        ProfilerScope(const ProfilerScope&) = delete;
+        ProfilerScope& operator=(const ProfilerScope&) = delete;
+
+    private:
+        Profiler* previous_;
+    };
+
+    /**
+     * @brief Marks the execution of a program (a list of instructions) for the active profiler.
+     */
+    class ProgramFrame {
+    public:
+        /**
+         * @param program The program being executed. Its key in the containing list is used as the program key.
+         */
+        explicit ProgramFrame(const WSEML& program);
+
+        /**
+         * @param programKey The program key.
+         */
+        explicit ProgramFrame(std::string programKey);
+
+        ~ProgramFrame();
+
+        ProgramFrame(const ProgramFrame&) = delete;
+        ProgramFrame& operator=(const ProgramFrame&) = delete;
+
+    private:
+        Profiler* profiler_;
+    };
+
+    /**
+     * @brief Measures a single instruction for the active profiler.
+     */
+    class InstructionTimer {
+    public:
+        /**
+         * @param opcode The opcode of the instruction.
+         * @param index The key of the instruction in its program.
+         */
+        InstructionTimer(const std::string& opcode, const WSEML& index);
+
+        ~InstructionTimer();
+
+        /**
+         * @brief Replaces the opcode and the index, e.g. when they are only known after dispatch.
+         * @warning Must be called before any nested program of this instruction starts.
+         */
+        void relabel(const std::string& opcode, const WSEML& index);
+
+        InstructionTimer(const InstructionTimer&) = delete;
+        InstructionTimer& operator=(const InstructionTimer&) = delete;
+
+    private:
+        Profiler* profiler_;
+        std::string opcode_;
+        std::string index_;
+        std::chrono::steady_clock::time_point start_;
+        std::size_t startAllocations_ = 0;
+    };
+
+    /**
+     * @brief Returns a short printable label for a WSEML key (the string itself for ByteStrings, `pack` otherwise).
+     */
+    std::string profileLabel(const WSEML& obj);
+
+} // namespace wseml
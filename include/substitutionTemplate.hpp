@@ -0,0 +1,88 @@
+/**
+ * @file substitutionTemplate.hpp
+ * @brief Pre-compiled templates for repeated placeholder substitution.
+ */
+#pragma once
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include "WSEML.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief A template object compiled for repeated substitution.
+     *
+     * `SubstitutionTemplate(templateObj).substitute(bindingsAA)` returns the same result as
+     * `substitutePlaceholders(bindingsAA, templateObj)`. Compilation records the positions of the placeholders (holes)
+     * and marks every placeholder-free subtree, so a substitution copies such subtrees whole and only walks the paths
+     * leading to holes.
+     */
+    class SubstitutionTemplate {
+    public:
+        /**
+         * @param templateObj The template. It is copied into the compiled template.
+         */
+        explicit SubstitutionTemplate(const WSEML& templateObj);
+
+        SubstitutionTemplate(const SubstitutionTemplate&) = delete;
+        SubstitutionTemplate& operator=(const SubstitutionTemplate&) = delete;
+        SubstitutionTemplate(SubstitutionTemplate&&) = default;
+        SubstitutionTemplate& operator=(SubstitutionTemplate&&) = default;
+
+        /**
+         * @brief Substitutes the placeholders of the template.
+         * @param bindingsAA An Associative Array where keys are placeholders and values are their bindings, or NULLOBJ.
+         * @throws std::runtime_error under the same conditions as substitutePlaceholders.
+         */
+        WSEML substitute(const WSEML& bindingsAA) const;
+
+        /**
+         * @brief Fills the holes of the template with the given values.
+         * @param values The value of every hole, indexed as by @ref findHole; nullptr keeps the placeholder. The values
+         *               are inserted as they are, without substituting placeholders inside them.
+         * @throws std::runtime_error if values.size() differs from getHoleCount().
+         */
+        WSEML instantiate(std::span<const WSEML* const> values) const;
+
+        /**
+         * @brief Returns the number of distinct placeholders of the template.
+         */
+        std::size_t getHoleCount() const;
+
+        /**
+         * @brief Returns the index of the hole of a placeholder, or std::nullopt if the template does not contain it.
+         */
+        std::optional<std::size_t> findHole(const WSEML& placeholder) const;
+
+        /**
+         * @brief Returns the placeholder of a hole.
+         */
+        const WSEML& getHole(std::size_t hole) const;
+
+        const WSEML& getTemplate() const;
+
+    private:
+        enum class NodeKind { Copy, Hole, List };
+
+        struct Node {
+            NodeKind kind = NodeKind::Copy;
+            const WSEML* value = nullptr;
+            std::size_t hole = 0;
+            /* key, data, keyRole and dataRole of every pair of a List node */
+            std::vector<Node> children;
+        };
+
+        Node compile(const WSEML& value);
+        WSEML build(const Node& node, std::span<const WSEML* const> values) const;
+
+        /* heap-allocated so that the compiled pointers survive moves */
+        std::unique_ptr<const WSEML> template_;
+        std::vector<const WSEML*> holes_;
+        std::unordered_map<const WSEML*, std::size_t, WSEMLPtrHash, WSEMLPtrEqual> holeIndex_;
+        Node root_;
+    };
+
+} // namespace wseml
@@ -0,0 +1,63 @@
+/**
+ * @file threadPool.hpp
+ * @brief Fixed-size thread pool used by the parallel algorithms.
+ */
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace wseml {
+
+    /**
+     * @brief A fixed set of worker threads executing submitted tasks in FIFO order.
+     * @note The destructor completes all queued tasks before joining the workers.
+     */
+    class ThreadPool {
+    public:
+        /**
+         * @param threads The number of worker threads; 0 selects std::thread::hardware_concurrency().
+         */
+        explicit ThreadPool(std::size_t threads = 0);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Schedules a task.
+         * @return A future receiving the result of the task or the exception it threw.
+         */
+        template <typename F>
+        auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+            using Result = std::invoke_result_t<std::decay_t<F>>;
+            auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+            std::future<Result> future = packaged->get_future();
+            enqueue([packaged]() { (*packaged)(); });
+            return future;
+        }
+
+        /**
+         * @brief Returns the number of worker threads.
+         */
+        std::size_t size() const;
+
+    private:
+        void enqueue(std::function<void()> task);
+        void workerLoop();
+
+        std::vector<std::thread> workers_;
+        std::queue<std::function<void()>> tasks_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        bool stopping_ = false;
+    };
+
+} // namespace wseml
@@ -0,0 +1,79 @@
+/**
+ * @file triggerIndex.hpp
+ * @brief Index of the functional associations of an Associative Array by trigger type.
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include "WSEML.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief Maps each trigger type of an Associative Array to the functional association that handles it.
+     *
+     * The index describes the AA as of a synchronization point, identified by the modification count (see
+     * getModificationCount) at which it was built. An index that was invalidated or whose synchronized count differs
+     * from the current one must be rebuilt before it is consulted; @ref rebuild may be called concurrently by readers.
+     * An index built over an AA whose functional associations may be edited without being counted (see Object::watch)
+     * is not usable, and the lookups scan the blocks instead.
+     */
+    class TriggerIndex {
+    public:
+        struct Entry {
+            /* 0 for the last (top) block */
+            std::size_t depth;
+            const WSEML* funcAssoc;
+
+            bool operator==(const Entry&) const = default;
+        };
+
+        using Entries = std::unordered_map<WSEML, Entry>;
+
+        /**
+         * @brief Returns true if the index is valid and was synchronized at @p modificationCount, or was built over
+         *        a frozen AA.
+         */
+        bool isCurrent(std::uint64_t modificationCount) const;
+
+        /**
+         * @brief Returns false if the AA was not fully watched at the last rebuild, so the index must not be consulted.
+         */
+        bool isUsable() const;
+
+        void invalidate();
+
+        /**
+         * @brief Moves the synchronization point after a change that kept the functional associations of the AA.
+         * @pre The index was current before the change.
+         */
+        void resync(std::uint64_t modificationCount);
+
+        /**
+         * @brief Replaces the entries.
+         *
+         * The entries are only written if they change, so readers of an index whose entries are unchanged may run
+         * concurrently.
+         *
+         * @param usable Whether the entries were collected from a fully watched AA.
+         * @param frozen Whether the AA is frozen, so that the index stays current.
+         */
+        void rebuild(Entries entries, std::uint64_t modificationCount, bool usable, bool frozen);
+
+        /**
+         * @brief Returns the entry of a trigger type, or nullptr.
+         */
+        const Entry* find(const WSEML& triggerType) const;
+
+    private:
+        Entries entries_;
+        std::atomic<bool> valid_ = false;
+        std::atomic<bool> usable_ = true;
+        std::atomic<bool> frozen_ = false;
+        std::atomic<std::uint64_t> syncedCount_ = 0;
+        std::mutex rebuildMutex_;
+    };
+
+} // namespace wseml
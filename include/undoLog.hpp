@@ -0,0 +1,72 @@
+/**
+ * @file undoLog.hpp
+ * @brief Undo log of the structural changes of an Associative Array.
+ */
+#pragma once
+#include <list>
+#include <vector>
+#include "WSEML.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief Records insertions into and removals from Lists so they can be reverted in reverse order.
+     *
+     * Removed pairs are spliced into the log rather than destroyed, and restored by splicing them back, so recording and
+     * reverting a change costs O(1) regardless of the size of the removed subtree. Every change is identified by
+     * iterators, which std::list keeps valid across splices; reverting in reverse order therefore always finds the
+     * Lists in the state the change left them in.
+     *
+     * A log holds a stack of marks (the open snapshots); reverting to a mark undoes the changes recorded after it.
+     */
+    class UndoLog {
+    public:
+        UndoLog() = default;
+        UndoLog(const UndoLog&) = delete;
+        UndoLog& operator=(const UndoLog&) = delete;
+
+        /**
+         * @brief Records that @p position was inserted into @p list.
+         */
+        void recordInsertion(List& list, std::list<Pair>::iterator position);
+
+        /**
+         * @brief Moves the pairs [first, last) of @p list into the log.
+         */
+        void recordRemoval(List& list, std::list<Pair>::iterator first, std::list<Pair>::iterator last);
+
+        /**
+         * @brief Opens a snapshot and returns its depth (the number of snapshots opened before it).
+         */
+        std::size_t pushMark();
+
+        /**
+         * @brief Closes the innermost snapshot; its changes now belong to the enclosing one.
+         */
+        void popMark();
+
+        /**
+         * @brief Reverts the changes of the innermost snapshot and closes it.
+         * @param holder The WSEML holding the List the log belongs to. It may have been moved since the changes were
+         *        recorded, so the pairs restored to that List are linked to it.
+         */
+        void rollback(WSEML& holder);
+
+        std::size_t getDepth() const;
+
+        std::size_t getChangeCount() const;
+
+    private:
+        struct Change {
+            List* list = nullptr;
+            /* the inserted pair, or the pair the removed ones preceded */
+            std::list<Pair>::iterator position;
+            bool insertion = false;
+            std::list<Pair> removed;
+        };
+
+        std::vector<Change> changes_;
+        std::vector<std::size_t> marks_;
+    };
+
+} // namespace wseml
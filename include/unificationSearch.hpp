@@ -0,0 +1,111 @@
+/**
+ * @file unificationSearch.hpp
+ * @brief Enumeration of all unifiers of two Associative Arrays.
+ */
+#pragma once
+#include <chrono>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "WSEML.hpp"
+#include "bindingStore.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief Bounds of a unification search.
+     */
+    struct UnifyOptions {
+        /* maximum number of unifiers to produce, 0 for no limit */
+        std::size_t limit = 0;
+        /* time budget measured from the creation of the search, zero for no limit */
+        std::chrono::steady_clock::duration timeout = std::chrono::steady_clock::duration::zero();
+    };
+
+    /**
+     * @brief Lazily enumerates the unifiers of two Associative Arrays.
+     *
+     * Entries whose keys are present in both AAs, or are not placeholders, are unified exactly as by unify(). An entry
+     * whose key is a placeholder missing from the other AA is a free entry: it is either matched with an entry of the
+     * other AA whose key is present only there (binding the key placeholder to that key and unifying the values), or
+     * kept as a separate entry. Distinct free entries of one AA are matched with distinct entries.
+     *
+     * Alternatives are explored depth-first; the bindings of abandoned branches are reverted with the BindingStore
+     * trail instead of copying state. The last unifier produced is the one returned by unify().
+     */
+    class UnificationSearch {
+    public:
+        /**
+         * @throws std::runtime_error if aa1 or aa2 is not an Associative Array.
+         */
+        UnificationSearch(const WSEML& aa1, const WSEML& aa2, UnifyOptions options = {});
+
+        /**
+         * @brief Returns the next unifier in the format of unify(): {unified AA, placeholder bindings AA}.
+         * @return std::nullopt when the search is exhausted, the limit is reached or the timeout expired.
+         */
+        std::optional<std::pair<WSEML, WSEML>> next();
+
+        /**
+         * @brief Returns true if the search was stopped by the timeout before it was exhausted.
+         */
+        bool timedOut() const;
+
+        /**
+         * @brief Returns the number of unifiers produced so far.
+         */
+        std::size_t getSolutionCount() const;
+
+    private:
+        static constexpr std::size_t KEEP = static_cast<std::size_t>(-1);
+
+        struct Entry {
+            WSEML key;
+            WSEML value;
+        };
+
+        struct FreeEntry {
+            Entry entry;
+            /* indices into base_ of the entries present only in the other AA */
+            const std::vector<std::size_t>* targets;
+            std::size_t target = KEEP;
+            WSEML unifiedValue = NULLOBJ;
+        };
+
+        struct Frame {
+            std::size_t candidate;
+            BindingStore::Mark mark;
+        };
+
+        bool initialize();
+        bool tryCandidate(std::size_t freeIndex, std::size_t candidate);
+        void release(std::size_t freeIndex);
+        std::pair<WSEML, WSEML> buildSolution();
+        std::optional<std::pair<WSEML, WSEML>> emit();
+
+        WSEML aa1_;
+        WSEML aa2_;
+        UnifyOptions options_;
+        std::chrono::steady_clock::time_point deadline_;
+        BindingStore bindings_;
+        /* the unification of the entries that are not free */
+        std::vector<Entry> base_;
+        std::vector<WSEML> baseFunctionalAssociations_;
+        std::vector<char> baseUsed_;
+        std::vector<std::size_t> targets1_;
+        std::vector<std::size_t> targets2_;
+        std::vector<FreeEntry> free_;
+        std::vector<Frame> frames_;
+        std::size_t solutions_ = 0;
+        bool started_ = false;
+        bool done_ = false;
+        bool timedOut_ = false;
+    };
+
+    /**
+     * @brief Returns the unifiers of two Associative Arrays, see UnificationSearch.
+     * @throws std::runtime_error if aa1 or aa2 is not an Associative Array.
+     */
+    std::vector<std::pair<WSEML, WSEML>> unifyAll(const WSEML& aa1, const WSEML& aa2, UnifyOptions options = {});
+
+} // namespace wseml
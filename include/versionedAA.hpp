@@ -0,0 +1,132 @@
+/**
+ * @file versionedAA.hpp
+ * @brief Read-mostly Associative Array published in immutable versions (epoch-based reclamation).
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "WSEML.hpp"
+
+namespace wseml {
+
+    /**
+     * @brief An Associative Array whose readers work on immutable versions without taking locks.
+     *
+     * A reader pins the current epoch with @ref read and runs any const operation (findValueInAA, unify, ...) on the
+     * version it got; the version stays alive until the guard is released. A writer copies the current version, edits
+     * the copy and publishes it with one atomic store, so readers never wait for writers. The replaced version is
+     * retired and destroyed once no reader pinned before the publication is still active.
+     *
+     * Versions do not share subtrees: WSEML trees own their children exclusively, so every update copies the AA once.
+     * This suits AAs that are read far more often than they are updated.
+     */
+    class VersionedAA {
+    public:
+        /**
+         * @brief Pins the epoch of a reader and gives access to the version it observed.
+         */
+        class ReadGuard {
+        public:
+            ReadGuard(const ReadGuard&) = delete;
+            ReadGuard& operator=(const ReadGuard&) = delete;
+            ReadGuard(ReadGuard&& other) noexcept;
+            ReadGuard& operator=(ReadGuard&&) = delete;
+            ~ReadGuard();
+
+            const WSEML& get() const;
+            const WSEML& operator*() const;
+            const WSEML* operator->() const;
+
+            /**
+             * @brief Returns the number of the version, counting publications from 0.
+             */
+            std::uint64_t getVersion() const;
+
+        private:
+            friend class VersionedAA;
+            ReadGuard(std::atomic<std::uint64_t>* slot, const WSEML* aa, std::uint64_t version);
+
+            std::atomic<std::uint64_t>* slot_;
+            const WSEML* aa_;
+            std::uint64_t version_;
+        };
+
+        /**
+         * @param aa The initial version.
+         * @param readerSlots The maximum number of simultaneously pinned readers; further readers spin until a slot
+         *                    frees up.
+         * @throws std::runtime_error if aa is not an Associative Array.
+         */
+        explicit VersionedAA(WSEML aa, std::size_t readerSlots = 128);
+
+        VersionedAA(const VersionedAA&) = delete;
+        VersionedAA& operator=(const VersionedAA&) = delete;
+
+        /**
+         * @note All ReadGuards must have been released.
+         */
+        ~VersionedAA();
+
+        /**
+         * @brief Pins the current version. Lock-free: a load, a compare-and-swap on a reader slot and another load.
+         */
+        ReadGuard read() const;
+
+        /**
+         * @brief Publishes a copy of the current version edited by @p edit. Writers are serialized among themselves.
+         * @throws std::runtime_error if the edited copy is not an Associative Array; the current version stays.
+         */
+        void update(const std::function<void(WSEML&)>& edit);
+
+        /**
+         * @brief Publishes @p aa as the new version.
+         * @throws std::runtime_error if aa is not an Associative Array.
+         */
+        void publish(WSEML aa);
+
+        /**
+         * @brief Destroys the retired versions no pinned reader can still observe. Called by every publication.
+         * @return The number of versions destroyed.
+         */
+        std::size_t reclaim();
+
+        /**
+         * @brief Returns the number of retired versions waiting for their readers to finish.
+         */
+        std::size_t getRetiredCount() const;
+
+        std::uint64_t getVersion() const;
+
+    private:
+        struct alignas(64) Slot {
+            /* the pinned epoch, 0 if free */
+            std::atomic<std::uint64_t> epoch = 0;
+        };
+
+        struct Version {
+            WSEML aa;
+            std::uint64_t number = 0;
+        };
+
+        struct Retired {
+            std::unique_ptr<const Version> version;
+            /* readers that pinned this epoch or a later one cannot observe the version */
+            std::uint64_t epoch = 0;
+        };
+
+        void publishLocked(WSEML aa);
+        std::size_t reclaimLocked();
+
+        std::size_t slotCount_;
+        std::unique_ptr<Slot[]> slots_;
+        std::atomic<std::uint64_t> epoch_ = 1;
+        std::atomic<const Version*> current_ = nullptr;
+        mutable std::mutex writerMutex_;
+        std::vector<Retired> retired_;
+    };
+
+} // namespace wseml
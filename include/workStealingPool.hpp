@@ -0,0 +1,161 @@
+/**
+ * @file workStealingPool.hpp
+ * @brief Fork-join thread pool with per-worker deques and work stealing.
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace wseml {
+
+    /**
+     * @brief A thread pool for recursive fork-join parallelism.
+     *
+     * Each worker keeps a deque of forked tasks: it pushes and pops at the back, idle workers steal from the front.
+     * A worker joining a task that was stolen runs other tasks meanwhile instead of blocking, so tasks may fork and
+     * join at any depth without exhausting the pool (unlike ThreadPool, whose tasks must not wait for each other).
+     */
+    class WorkStealingPool {
+    public:
+        /**
+         * @param threads The number of worker threads; 0 selects std::thread::hardware_concurrency().
+         */
+        explicit WorkStealingPool(std::size_t threads = 0);
+
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        /**
+         * @brief Runs @p fn on a worker and waits for its result; from a worker of this pool, runs it inline.
+         * @throws Whatever fn throws.
+         */
+        template <typename F>
+        auto run(F&& fn) -> std::invoke_result_t<F&> {
+            using Result = std::invoke_result_t<F&>;
+            if (isWorkerThread()) {
+                return fn();
+            }
+            if constexpr (std::is_void_v<Result>) {
+                runTask(makeTask(fn));
+            } else {
+                std::optional<Result> result;
+                auto store = [&]() { result.emplace(fn()); };
+                runTask(makeTask(store));
+                return std::move(*result);
+            }
+        }
+
+        /**
+         * @brief Runs @p left and @p right, the latter possibly on another worker, and returns when both finished.
+         * @details Outside the workers of this pool, runs them one after the other.
+         * @throws The exception thrown by left, otherwise the one thrown by right.
+         */
+        template <typename L, typename R>
+        void invoke(L&& left, R&& right) {
+            if (not isWorkerThread()) {
+                left();
+                right();
+                return;
+            }
+            Task task = makeTask(right);
+            fork(task);
+            try {
+                left();
+            } catch (...) {
+                join(task);
+                throw;
+            }
+            join(task);
+            if (task.error) {
+                std::rethrow_exception(task.error);
+            }
+        }
+
+        /**
+         * @brief Calls @p body(first, last) on subranges of [begin, end) of at most @p grain indices, in parallel.
+         */
+        template <typename Body>
+        void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, const Body& body) {
+            if (end - begin <= std::max<std::size_t>(grain, 1)) {
+                body(begin, end);
+                return;
+            }
+            std::size_t middle = begin + (end - begin) / 2;
+            invoke([&]() { parallelFor(begin, middle, grain, body); }, [&]() { parallelFor(middle, end, grain, body); });
+        }
+
+        /**
+         * @brief Returns true if the calling thread is a worker of this pool.
+         */
+        bool isWorkerThread() const;
+
+        /**
+         * @brief Returns the number of worker threads.
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief Returns the number of tasks run by a worker other than the one that forked them.
+         */
+        std::size_t getStealCount() const;
+
+    private:
+        struct Task {
+            Task(void (*run)(void*), void* context)
+                : run(run)
+                , context(context) {
+            }
+
+            void (*run)(void*) = nullptr;
+            void* context = nullptr;
+            std::atomic<bool> done = false;
+            std::exception_ptr error;
+            /* submitted by run() from outside the pool; its waiter sleeps on finished_ */
+            bool injected = false;
+        };
+
+        struct alignas(64) Worker {
+            std::mutex mutex;
+            std::deque<Task*> tasks;
+        };
+
+        template <typename F>
+        static Task makeTask(F& fn) {
+            return Task([](void* context) { (*static_cast<F*>(context))(); }, const_cast<void*>(static_cast<const void*>(&fn)));
+        }
+
+        void runTask(Task&& task);
+        void fork(Task& task);
+        void join(Task& task);
+        void execute(Task& task);
+        Task* popOwn(std::size_t self);
+        Task* steal(std::size_t self);
+        void notify();
+        void workerLoop(std::size_t self);
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::vector<std::thread> threads_;
+        std::deque<Task*> injected_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        std::condition_variable finished_;
+        std::atomic<std::size_t> queued_ = 0;
+        std::atomic<std::size_t> sleepers_ = 0;
+        std::atomic<std::size_t> steals_ = 0;
+        bool stopping_ = false;
+    };
+
+} // namespace wseml
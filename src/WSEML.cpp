@@ -1,124 +1,491 @@
 #include <string>
 #include <ranges>
 #include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
 #include "../include/WSEML.hpp"
 #include "../include/hashUtils.hpp"
+#include "../include/keyFilter.hpp"
+#include "../include/triggerIndex.hpp"
+#include "../include/undoLog.hpp"
 #include "../include/parser.hpp"
 #include "../include/dllconfig.hpp"
 #include "../include/associativeArray.hpp"
+#include "../include/profiler.hpp"
 
 namespace wseml {
 
-    WSEML NULLOBJ = WSEML();
-    WSEML EMPTYLIST = parse("{}");
+    const WSEML NULLOBJ = WSEML();
+    const WSEML EMPTYLIST = parse("{}");
     WSEML FUNCTION_TYPE = WSEML("@functionType@");
 
+    namespace {
+        thread_local std::size_t objectAllocations = 0;
+
+        std::atomic<std::uint64_t> modificationCount = 0;
+        thread_local std::uint64_t ownModificationCount = 0;
+
+        void countModification() {
+            modificationCount.fetch_add(1, std::memory_order_release);
+            ownModificationCount++;
+        }
+
+        /* The word of a WSEML handle holding an inline string: INLINE_BIT (an Object pointer is aligned), the member of
+           the pair holding the handle, which stands for the containing pair of the missing object, the length, and
+           the bytes from the second byte of the word up. */
+        constexpr std::uintptr_t INLINE_BIT = 1;
+        constexpr int SLOT_SHIFT = 2;
+        constexpr std::uintptr_t SLOT_MASK = std::uintptr_t{3} << SLOT_SHIFT;
+        constexpr std::uintptr_t SLOT_NONE = 0;
+        constexpr std::uintptr_t SLOT_KEY = 1;
+        constexpr std::uintptr_t SLOT_DATA = 2;
+        constexpr int LENGTH_SHIFT = 4;
+        constexpr std::uintptr_t LENGTH_MASK = std::uintptr_t{7} << LENGTH_SHIFT;
+        constexpr std::size_t INLINE_CAPACITY = sizeof(std::uintptr_t) - 1;
+        static_assert(INLINE_CAPACITY <= (LENGTH_MASK >> LENGTH_SHIFT), "the length of an inline string fits its field");
+        static_assert(std::is_standard_layout_v<Pair>, "the pair of an inline string is found from the offset of its member");
+
+        /* The word of a handle sharing a node: SHARED_BIT, the slot as for an inline string, and the address of the
+           node, which its alignment keeps clear of both. */
+        constexpr std::uintptr_t SHARED_BIT = 2;
+        constexpr std::uintptr_t TAG_BITS = INLINE_BIT | SHARED_BIT;
+        constexpr std::uintptr_t NODE_BITS = TAG_BITS | SLOT_MASK;
+        static_assert(alignof(Object) > TAG_BITS, "an Object pointer leaves the tag bits of the handle clear");
+        static_assert(alignof(SharedNode) > NODE_BITS, "a node pointer leaves the tag and slot bits of the handle clear");
+
+        bool isInlineWord(std::uintptr_t word) {
+            return (word & INLINE_BIT) != 0;
+        }
+
+        bool isSharedWord(std::uintptr_t word) {
+            return (word & TAG_BITS) == SHARED_BIT;
+        }
+
+        /* an inline string or a shared node, which carry the slot of the handle */
+        bool isTaggedWord(std::uintptr_t word) {
+            return (word & TAG_BITS) != 0;
+        }
+
+        SharedNode* nodeOf(std::uintptr_t word) {
+            return reinterpret_cast<SharedNode*>(word & ~NODE_BITS);
+        }
+
+        std::uintptr_t encodeInline(std::string_view str) {
+            std::uintptr_t word = INLINE_BIT | (std::uintptr_t{str.size()} << LENGTH_SHIFT);
+            for (std::size_t i = 0; i < str.size(); i++) {
+                word |= std::uintptr_t{static_cast<unsigned char>(str[i])} << (8 * (i + 1));
+            }
+            return word;
+        }
+
+        void decodeInline(std::uintptr_t word, std::string& str) {
+            std::size_t length = (word & LENGTH_MASK) >> LENGTH_SHIFT;
+            str.resize(length);
+            for (std::size_t i = 0; i < length; i++) {
+                str[i] = static_cast<char>((word >> (8 * (i + 1))) & 0xff);
+            }
+        }
+
+        std::uintptr_t withSlot(std::uintptr_t word, std::uintptr_t slot) {
+            return (word & ~SLOT_MASK) | (slot << SLOT_SHIFT);
+        }
+
+        /* the word of a copy of the contents word: a deep copy of an object, another reference to a shared node, an
+           unlinked inline string */
+        std::uintptr_t copyWord(std::uintptr_t word) {
+            if (isSharedWord(word)) {
+                nodeOf(word)->references.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (isTaggedWord(word)) {
+                return withSlot(word, SLOT_NONE);
+            }
+            return word != 0 ? reinterpret_cast<std::uintptr_t>(reinterpret_cast<const Object*>(word)->clone().release()) : 0;
+        }
+
+        /* destroys the contents word: the object, or the reference to a shared node */
+        void destroyWord(std::uintptr_t word) {
+            if (isSharedWord(word)) {
+                SharedNode* node = nodeOf(word);
+                if (node->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    delete node;
+                }
+            } else if (not isInlineWord(word)) {
+                delete reinterpret_cast<Object*>(word);
+            }
+        }
+
+        /* the word of a handle holding the string, inline unless it is typed, linked or too long */
+        std::uintptr_t stringWord(std::string str, const WSEML& type, Pair* p) {
+            if (str.size() <= INLINE_CAPACITY and not type.hasObject() and p == nullptr) {
+                return encodeInline(str);
+            }
+            return reinterpret_cast<std::uintptr_t>(new ByteString(std::move(str), type, p));
+        }
+    } // namespace
+
+    std::size_t getObjectAllocationCount() {
+        return objectAllocations;
+    }
+
+    std::uint64_t getModificationCount() {
+        return modificationCount.load(std::memory_order_acquire);
+    }
+
+    std::uint64_t getOwnModificationCount() {
+        return ownModificationCount;
+    }
+
+    std::size_t footprint(const WSEML& obj, bool throughShared) {
+        static const std::size_t inlineCapacity = std::string().capacity();
+        std::size_t bytes = 0;
+        std::unordered_set<const SharedNode*> counted;
+        std::vector<const WSEML*> pending{&obj};
+        while (not pending.empty()) {
+            const WSEML* current = pending.back();
+            pending.pop_back();
+            /* a node held by several handles is counted once */
+            if (const SharedNode* node = current->getSharedNode()) {
+                if (throughShared and counted.insert(node).second) {
+                    bytes += sizeof(SharedNode);
+                    pending.push_back(&node->tree);
+                }
+                continue;
+            }
+            /* an inline string is all in the handle */
+            if (not current->hasObject() or current->isInline()) {
+                continue;
+            }
+            pending.push_back(&current->getSemanticType());
+            if (current->structureTypeInfo() == StructureType::String) {
+                const std::string& str = current->getInnerString();
+                bytes += sizeof(ByteString) + (str.capacity() > inlineCapacity ? str.capacity() + 1 : 0);
+                continue;
+            }
+            bytes += sizeof(List);
+            for (const Pair& pair : current->getInnerList()) {
+                /* a std::list node holds two links besides the pair */
+                bytes += sizeof(Pair) + 2 * sizeof(void*) + (pair.hasRoles() ? 2 * sizeof(WSEML) + sizeof(void*) : 0);
+                pair.forEachMember([&](const WSEML& member) { pending.push_back(&member); });
+            }
+        }
+        return bytes;
+    }
+
     /*  WSEML implementation */
 
     WSEML::WSEML()
-        : obj_(nullptr) {
+        : word_(0) {
     }
 
     WSEML::WSEML(std::unique_ptr<List> list)
-        : obj_(std::move(list)) {
+        : word_(reinterpret_cast<std::uintptr_t>(list.release())) {
         // Since this is a new WSEML instance, it can't be part of any pair already.
-        if (obj_) {
-            obj_->updateLinksRecursively(nullptr, this);
-        }
+        updateLinks(nullptr);
     }
 
     WSEML::WSEML(std::unique_ptr<ByteString> bytes)
-        : obj_(std::move(bytes)) {
+        : word_(reinterpret_cast<std::uintptr_t>(bytes.release())) {
         // Since this is a new WSEML instance, it can't be part of any pair already.
-        if (obj_) {
-            obj_->updateLinksRecursively(nullptr, this);
-        }
+        updateLinks(nullptr);
     }
 
     WSEML::WSEML(std::string str, const WSEML& type, Pair* p)
-        : obj_(std::make_unique<ByteString>(std::move(str), type, p)) {
+        : word_(stringWord(std::move(str), type, p)) {
         // Since its just a ByteString, passing p to constructor is enough.
     }
 
     WSEML::WSEML(std::list<Pair> l, const WSEML& type, Pair* p)
-        : obj_(std::make_unique<List>(std::move(l), type, p)) {
+        : word_(reinterpret_cast<std::uintptr_t>(new List(std::move(l), type, p))) {
         // Since this List can already contain some pairs, we have to update the pointers.
-        obj_->updateLinksRecursively(p, this);
+        updateLinks(p);
     }
 
     WSEML::WSEML(const WSEML& other)
-        : obj_(other.obj_ ? other.obj_->clone() : nullptr) {
-        if (obj_) {
-            obj_->updateLinksRecursively(nullptr, this);
-        }
+        : word_(copyWord(other.word_.load(std::memory_order_acquire))) {
+        updateLinks(nullptr);
     }
 
     WSEML::WSEML(WSEML&& other) noexcept
-        : obj_(std::move(other.obj_)) {
-        other.obj_ = nullptr;
-        if (obj_) {
-            obj_->updateLinksRecursively(nullptr, this);
-        }
+        : WSEML() {
+        std::uintptr_t word = other.word_.load(std::memory_order_relaxed);
+        /* the contents left the handle they were watched in */
+        other.noteChange(word);
+        other.word_.store(0, std::memory_order_relaxed);
+        word_.store(isTaggedWord(word) ? withSlot(word, SLOT_NONE) : word, std::memory_order_relaxed);
+        updateLinks(nullptr);
     }
 
     WSEML& WSEML::operator=(const WSEML& other) {
+        assert((heldObject() == nullptr or not heldObject()->isFrozen()) and "attempt to modify a frozen WSEML tree");
         if (this != &other) {
-            obj_ = (other.obj_ ? other.obj_->clone() : nullptr);
-            if (obj_) {
-                obj_->updateLinksRecursively(nullptr, this);
-            }
+            reset(copyWord(other.word_.load(std::memory_order_acquire)));
         }
         return *this;
     }
 
     WSEML& WSEML::operator=(WSEML&& other) noexcept {
+        assert((heldObject() == nullptr or not heldObject()->isFrozen()) and "attempt to modify a frozen WSEML tree");
         if (this != &other) {
-            obj_ = std::move(other.obj_);
-            other.obj_ = nullptr;
-            if (obj_) {
-                obj_->updateLinksRecursively(nullptr, this);
-            }
+            std::uintptr_t word = other.word_.load(std::memory_order_relaxed);
+            other.noteChange(word);
+            other.word_.store(0, std::memory_order_relaxed);
+            reset(word);
         }
         return *this;
     }
 
-    WSEML::~WSEML() = default;
+    WSEML::~WSEML() {
+        destroyWord(word_.load(std::memory_order_relaxed));
+    }
 
-    bool WSEML::hasObject() const {
-        return obj_ != nullptr;
+    SharedNode::SharedNode(WSEML sharedTree, std::size_t treeHash)
+        : tree(std::move(sharedTree))
+        , hash(treeHash) {
     }
 
-    bool equal(const WSEML& first, const WSEML& second) {
-        const Object* firstObject = first.getRawObject();
-        const Object* secondObject = second.getRawObject();
-        if (firstObject == nullptr and secondObject == nullptr) {
-            return true;
+    WSEML WSEML::share(WSEML tree) {
+        if (tree.isShared()) {
+            return tree;
         }
+        std::size_t hash = std::hash<WSEML>{}(tree);
+        auto* node = new SharedNode(std::move(tree), hash);
+        WSEML handle;
+        handle.word_.store(reinterpret_cast<std::uintptr_t>(node) | SHARED_BIT, std::memory_order_relaxed);
+        return handle;
+    }
 
-        if (firstObject == nullptr or secondObject == nullptr) {
-            return false;
+    bool WSEML::isShared() const {
+        return isSharedWord(word_.load(std::memory_order_acquire));
+    }
+
+    const SharedNode* WSEML::getSharedNode() const {
+        std::uintptr_t word = word_.load(std::memory_order_acquire);
+        return isSharedWord(word) ? nodeOf(word) : nullptr;
+    }
+
+    SharedNode* WSEML::soleNode() const {
+        std::uintptr_t word = word_.load(std::memory_order_acquire);
+        if (not isSharedWord(word)) {
+            return nullptr;
         }
+        SharedNode* node = nodeOf(word);
+        return node->references.load(std::memory_order_acquire) == 1 ? node : nullptr;
+    }
 
-        if (firstObject->structureTypeInfo() != secondObject->structureTypeInfo()) {
-            return false;
+    const WSEML& WSEML::target() const {
+        std::uintptr_t word = word_.load(std::memory_order_acquire);
+        return isSharedWord(word) ? nodeOf(word)->tree : *this;
+    }
+
+    Object* WSEML::heldObject() const {
+        std::uintptr_t word = word_.load(std::memory_order_acquire);
+        return isTaggedWord(word) ? nullptr : reinterpret_cast<Object*>(word);
+    }
+
+    namespace {
+        /* an object standing for an inline string or a shared node takes the flags of the List holding its pair,
+           which stood for the contents of the handle until then */
+        void inheritHolderFlags(Object& obj, const Pair* pair) {
+            if (pair != nullptr and pair->getListOwner() != nullptr) {
+                if (const Object* holder = std::as_const(*pair->getListOwner()).getRawObject()) {
+                    obj.inheritFlags(*holder);
+                }
+            }
         }
+    } // namespace
 
-        const WSEML& firstSemanticType = first.getSemanticType();
-        const WSEML& secondSemanticType = second.getSemanticType();
+    Object* WSEML::object() const {
+        std::uintptr_t word = word_.load(std::memory_order_acquire);
+        if (isSharedWord(word)) {
+            return nodeOf(word)->tree.object();
+        }
+        if (not isInlineWord(word)) {
+            return reinterpret_cast<Object*>(word);
+        }
+        std::string str;
+        decodeInline(word, str);
+        Pair* pair = slotPair(word);
+        auto promoted = std::make_unique<ByteString>(std::move(str), NULLOBJ, pair);
+        inheritHolderFlags(*promoted, pair);
+        /* concurrent readers may promote the same string; the first one wins */
+        if (word_.compare_exchange_strong(word, reinterpret_cast<std::uintptr_t>(promoted.get()), std::memory_order_acq_rel)) {
+            return promoted.release();
+        }
+        return reinterpret_cast<Object*>(word);
+    }
+
+    Pair* WSEML::slotPair(std::uintptr_t word) const {
+        auto address = reinterpret_cast<std::uintptr_t>(this);
+        switch ((word & SLOT_MASK) >> SLOT_SHIFT) {
+            case SLOT_KEY:
+                return reinterpret_cast<Pair*>(address - offsetof(Pair, key_));
+            case SLOT_DATA:
+                return reinterpret_cast<Pair*>(address - offsetof(Pair, data_));
+            default:
+                return nullptr;
+        }
+    }
 
-        if (firstSemanticType != secondSemanticType) {
-            return false;
+    void WSEML::noteChange(std::uintptr_t word) const {
+        if (not isTaggedWord(word)) {
+            if (word != 0) {
+                reinterpret_cast<Object*>(word)->noteModification();
+            }
+        } else if (Pair* pair = slotPair(word)) {
+            pair->noteModification();
         }
+    }
 
-        if (isAssociativeArray(first) && isAssociativeArray(second)) {
-            return compareAssociativeArrays(first, second);
+    void WSEML::reset(std::uintptr_t word) {
+        std::uintptr_t old = word_.load(std::memory_order_relaxed);
+        noteChange(old);
+        Pair* pair = isTaggedWord(old) ? slotPair(old) : (old != 0 ? reinterpret_cast<Object*>(old)->getContainingPair() : nullptr);
+        word_.store(isTaggedWord(word) ? withSlot(word, SLOT_NONE) : word, std::memory_order_relaxed);
+        destroyWord(old);
+        updateLinks(pair);
+    }
+
+    void WSEML::unshare() {
+        std::uintptr_t word = word_.load(std::memory_order_relaxed);
+        if (not isSharedWord(word)) {
+            return;
+        }
+        Pair* pair = slotPair(word);
+        reset(copyWord(nodeOf(word)->tree.word_.load(std::memory_order_acquire)));
+        if (Object* copy = heldObject()) {
+            inheritHolderFlags(*copy, pair);
         }
+    }
 
-        if (isBlock(first) && isBlock(second)) {
-            return compareBlocks(first, second);
+    Object* WSEML::release() {
+        Object* obj = heldObject();
+        if (obj != nullptr) {
+            word_.store(0, std::memory_order_relaxed);
         }
+        return obj;
+    }
+
+    void WSEML::adopt(WSEML& other) {
+        std::uintptr_t word = other.word_.load(std::memory_order_relaxed);
+        other.noteChange(word);
+        other.word_.store(0, std::memory_order_relaxed);
+        word_.store(isTaggedWord(word) ? withSlot(word, SLOT_NONE) : word, std::memory_order_relaxed);
+    }
 
-        return firstObject->equal(secondObject);
+    bool WSEML::isInline() const {
+        return isInlineWord(word_.load(std::memory_order_acquire));
+    }
+
+    bool WSEML::hasObject() const {
+        std::uintptr_t word = word_.load(std::memory_order_acquire);
+        return word != 0 and (not isSharedWord(word) or nodeOf(word)->tree.hasObject());
+    }
+
+    namespace {
+        enum class ShallowComparison { Equal, Different, Descend };
+
+        /* settles the common leaves (absent objects and untyped strings) and the shared nodes without touching the stack
+           of equal */
+        ShallowComparison compareShallow(const WSEML& first, const WSEML& second) {
+            const SharedNode* firstNode = first.getSharedNode();
+            const SharedNode* secondNode = second.getSharedNode();
+            if (firstNode != nullptr and secondNode != nullptr) {
+                if (firstNode == secondNode) {
+                    return ShallowComparison::Equal;
+                }
+                /* a table holds a single node per value */
+                if (firstNode->table != 0 and firstNode->table == secondNode->table) {
+                    return ShallowComparison::Different;
+                }
+            }
+            StructureType firstStructure = first.structureTypeInfo();
+            if (firstStructure != second.structureTypeInfo()) {
+                return ShallowComparison::Different;
+            }
+            if (firstStructure == StructureType::None) {
+                return ShallowComparison::Equal;
+            }
+            if (firstStructure != StructureType::String or first.getSemanticType().hasObject() or second.getSemanticType().hasObject()) {
+                return ShallowComparison::Descend;
+            }
+            std::string firstBuffer;
+            std::string secondBuffer;
+            return first.getStringView(firstBuffer) == second.getStringView(secondBuffer) ? ShallowComparison::Equal : ShallowComparison::Different;
+        }
+    } // namespace
+
+    bool equal(const WSEML& first, const WSEML& second) {
+        /* the handles left to compare, with their structure types already known to match */
+        std::vector<std::pair<const WSEML*, const WSEML*>> pending;
+        auto compare = [&pending](const WSEML& firstHandle, const WSEML& secondHandle) {
+            switch (compareShallow(firstHandle, secondHandle)) {
+                case ShallowComparison::Equal:
+                    return true;
+                case ShallowComparison::Different:
+                    return false;
+                case ShallowComparison::Descend:
+                    pending.emplace_back(&firstHandle, &secondHandle);
+                    return true;
+            }
+            return false;
+        };
+
+        if (not compare(first, second)) {
+            return false;
+        }
+        while (not pending.empty()) {
+            auto [firstHandle, secondHandle] = pending.back();
+            pending.pop_back();
+
+            /* the semantic types are compared on the same stack */
+            if (not compare(firstHandle->getSemanticType(), secondHandle->getSemanticType())) {
+                return false;
+            }
+
+            if (firstHandle->structureTypeInfo() == StructureType::String) {
+                if (firstHandle->getInnerString() != secondHandle->getInnerString()) {
+                    return false;
+                }
+                continue;
+            }
+
+            if (isAssociativeArray(*firstHandle) && isAssociativeArray(*secondHandle)) {
+                if (not compareAssociativeArrays(*firstHandle, *secondHandle)) {
+                    return false;
+                }
+                continue;
+            }
+
+            if (isBlock(*firstHandle) && isBlock(*secondHandle)) {
+                if (not compareBlocks(*firstHandle, *secondHandle)) {
+                    return false;
+                }
+                continue;
+            }
+
+            const std::list<Pair>& firstPairs = firstHandle->getInnerList();
+            const std::list<Pair>& secondPairs = secondHandle->getInnerList();
+            if (firstPairs.size() != secondPairs.size()) {
+                return false;
+            }
+            for (auto it1 = firstPairs.begin(), it2 = secondPairs.begin(); it1 != firstPairs.end(); ++it1, ++it2) {
+                if (not compare(it1->getKey(), it2->getKey()) or not compare(it1->getData(), it2->getData())) {
+                    return false;
+                }
+                if ((it1->hasRoles() or it2->hasRoles()) and
+                    (not compare(it1->getKeyRole(), it2->getKeyRole()) or not compare(it1->getDataRole(), it2->getDataRole()))) {
+                    return false;
+                }
+            }
+        }
+        return true;
     }
 
     bool WSEML::operator==(const WSEML& other) const {
@@ -130,32 +497,42 @@ namespace wseml {
     }
 
     const Object* WSEML::getRawObject() const {
-        return obj_.get();
+        return object();
     }
 
     Object* WSEML::getRawObject() {
-        return obj_.get();
+        unshare();
+        return object();
     }
 
     StructureType WSEML::structureTypeInfo() const {
-        if (!obj_) {
+        std::uintptr_t word = word_.load(std::memory_order_acquire);
+        if (word == 0) {
             return StructureType::None;
         }
-        return obj_->structureTypeInfo();
+        if (isSharedWord(word)) {
+            return nodeOf(word)->tree.structureTypeInfo();
+        }
+        return isInlineWord(word) ? StructureType::String : reinterpret_cast<const Object*>(word)->structureTypeInfo();
     }
 
     const WSEML& WSEML::getSemanticType() const {
-        if (!obj_) {
+        std::uintptr_t word = word_.load(std::memory_order_acquire);
+        if (word == 0) {
             throw std::runtime_error("Attempt to get semantic type from empty WSEML");
         }
-        return obj_->getSemanticType();
+        if (isSharedWord(word)) {
+            return nodeOf(word)->tree.getSemanticType();
+        }
+        return isInlineWord(word) ? NULLOBJ : std::as_const(*reinterpret_cast<const Object*>(word)).getSemanticType();
     }
 
     void WSEML::setSemanticType(const WSEML& newType) {
-        if (!obj_) {
+        if (not hasObject()) {
             throw std::runtime_error("Attempt to set semantic type on empty WSEML");
         }
-        obj_->setSemanticType(newType);
+        unshare();
+        object()->setSemanticType(newType);
     }
 
     WSEML* WSEML::getContainingList() const {
@@ -164,122 +541,314 @@ namespace wseml {
     }
 
     Pair* WSEML::getContainingPair() const {
-        return obj_ ? obj_->getContainingPair() : nullptr;
+        std::uintptr_t word = word_.load(std::memory_order_acquire);
+        if (isTaggedWord(word)) {
+            return slotPair(word);
+        }
+        return word != 0 ? reinterpret_cast<const Object*>(word)->getContainingPair() : nullptr;
     }
 
     const List& WSEML::getList() const {
-        if (obj_ && obj_->structureTypeInfo() == StructureType::List) {
-            return static_cast<List&>(*obj_);
+        const Object* obj = target().heldObject();
+        if (obj && obj->structureTypeInfo() == StructureType::List) {
+            return static_cast<const List&>(*obj);
         }
         throw std::runtime_error("Attempt to get List& from WSEML that doesn't contain a List");
     }
 
     List& WSEML::getList() {
-        if (obj_ && obj_->structureTypeInfo() == StructureType::List) {
-            return static_cast<List&>(*obj_);
+        unshare();
+        Object* obj = heldObject();
+        if (obj && obj->structureTypeInfo() == StructureType::List) {
+            assert(not obj->isFrozen() and "attempt to modify a frozen WSEML tree");
+            return static_cast<List&>(*obj);
         }
         throw std::runtime_error("Attempt to get List& from WSEML that doesn't contain a List");
     }
+
     WSEML WSEML::append(WSEML data, WSEML key, WSEML keyRole, WSEML dataRole) {
-        if (not obj_ or obj_->structureTypeInfo() != StructureType::List) {
+        if (structureTypeInfo() != StructureType::List) {
             throw std::runtime_error("Attempt to append to WSEML that doesn't contain a List");
         }
         return getList().append(this, std::move(data), std::move(key), std::move(keyRole), std::move(dataRole));
     }
 
     WSEML WSEML::appendFront(WSEML data, WSEML key, WSEML keyRole, WSEML dataRole) {
-        if (not obj_ or obj_->structureTypeInfo() != StructureType::List) {
+        if (structureTypeInfo() != StructureType::List) {
             throw std::runtime_error("Attempt to append to WSEML that doesn't contain a List");
         }
         return getList().appendFront(this, std::move(data), std::move(key), std::move(keyRole), std::move(dataRole));
     }
 
     std::list<Pair>& WSEML::getInnerList() {
-        if (obj_ && obj_->structureTypeInfo() == StructureType::List) {
-            return static_cast<List*>(obj_.get())->get();
+        unshare();
+        Object* obj = heldObject();
+        if (obj && obj->structureTypeInfo() == StructureType::List) {
+            assert(not obj->isFrozen() and "attempt to modify a frozen WSEML tree");
+            return static_cast<List*>(obj)->get();
         }
         throw std::runtime_error("Attempt to get std::list<Pair> from WSEML that doesn't contain a List");
     }
 
     const std::list<Pair>& WSEML::getInnerList() const {
-        if (obj_ && obj_->structureTypeInfo() == StructureType::List) {
-            return static_cast<List*>(obj_.get())->get();
+        const Object* obj = target().heldObject();
+        if (obj && obj->structureTypeInfo() == StructureType::List) {
+            return static_cast<const List*>(obj)->get();
         }
         throw std::runtime_error("Attempt to get std::list<Pair> from WSEML that doesn't contain a List");
     }
 
     const ByteString& WSEML::getByteString() const {
-        if (obj_ && obj_->structureTypeInfo() == StructureType::String) {
-            return static_cast<ByteString&>(*obj_);
+        if (structureTypeInfo() == StructureType::String) {
+            return static_cast<const ByteString&>(*object());
         }
         throw std::runtime_error("Attempt to get ByteString& from WSEML that doesn't contain a ByteString");
     }
 
     ByteString& WSEML::getByteString() {
-        if (obj_ && obj_->structureTypeInfo() == StructureType::String) {
-            return static_cast<ByteString&>(*obj_);
+        if (structureTypeInfo() == StructureType::String) {
+            unshare();
+            Object* obj = object();
+            assert(not obj->isFrozen() and "attempt to modify a frozen WSEML tree");
+            return static_cast<ByteString&>(*obj);
         }
         throw std::runtime_error("Attempt to get ByteString& from WSEML that doesn't contain a ByteString");
     }
 
     std::string& WSEML::getInnerString() {
-        if (obj_ && obj_->structureTypeInfo() == StructureType::String) {
-            return static_cast<ByteString*>(obj_.get())->get();
+        if (structureTypeInfo() == StructureType::String) {
+            unshare();
+            Object* obj = object();
+            assert(not obj->isFrozen() and "attempt to modify a frozen WSEML tree");
+            return static_cast<ByteString*>(obj)->get();
         }
         throw std::runtime_error("Attempt to get std::string from WSEML that doesn't contain a ByteString");
     }
 
     const std::string& WSEML::getInnerString() const {
-        if (obj_ && obj_->structureTypeInfo() == StructureType::String) {
-            return static_cast<ByteString*>(obj_.get())->get();
+        if (structureTypeInfo() == StructureType::String) {
+            return static_cast<const ByteString*>(object())->get();
+        }
+        throw std::runtime_error("Attempt to get std::string from WSEML that doesn't contain a ByteString");
+    }
+
+    std::string_view WSEML::getStringView(std::string& buffer) const {
+        std::uintptr_t word = word_.load(std::memory_order_acquire);
+        if (isSharedWord(word)) {
+            return nodeOf(word)->tree.getStringView(buffer);
+        }
+        if (isInlineWord(word)) {
+            decodeInline(word, buffer);
+            return buffer;
+        }
+        if (word != 0 and reinterpret_cast<const Object*>(word)->structureTypeInfo() == StructureType::String) {
+            return reinterpret_cast<const ByteString*>(word)->get();
         }
         throw std::runtime_error("Attempt to get std::string from WSEML that doesn't contain a ByteString");
     }
 
     void WSEML::updateLinksRecursively(Pair* p) {
-        if (obj_) {
-            obj_->updateLinksRecursively(p, this);
+        std::vector<std::pair<WSEML*, Pair*>> pending{{this, p}};
+        while (not pending.empty()) {
+            auto [holder, containingPair] = pending.back();
+            pending.pop_back();
+            Object* obj = holder->heldObject();
+            if (obj == nullptr) {
+                holder->updateLinks(containingPair);
+                continue;
+            }
+            obj->updateLinks(containingPair, holder);
+            if (obj->structureTypeInfo() == StructureType::List) {
+                for (Pair& pair : static_cast<List&>(*obj).pairList_) {
+                    pair.forEachMember([&](WSEML& member) { pending.emplace_back(&member, &pair); });
+                }
+            }
         }
     }
 
-    size_t hash_value(const WSEML& w) {
-        if (w.obj_ == nullptr) {
-            return 0;
+    void WSEML::updateLinks(Pair* p) {
+        std::uintptr_t word = word_.load(std::memory_order_relaxed);
+        if (not isTaggedWord(word)) {
+            if (word != 0) {
+                reinterpret_cast<Object*>(word)->updateLinks(p, this);
+            }
+            return;
         }
+        if (p == nullptr) {
+            word_.store(withSlot(word, SLOT_NONE), std::memory_order_relaxed);
+        } else if (this == &p->key_ or this == &p->data_) {
+            word_.store(withSlot(word, this == &p->key_ ? SLOT_KEY : SLOT_DATA), std::memory_order_relaxed);
+        } else {
+            /* a role has no slot in the handle; a shared node is not linked to the pairs holding it */
+            word_.store(withSlot(word, SLOT_NONE), std::memory_order_relaxed);
+            if (isInlineWord(word)) {
+                object()->updateLinks(p, this);
+            }
+        }
+    }
 
-        const WSEML& objType = w.getSemanticType();
+    namespace {
+        /* a List whose hash waits for the hashes of its children, see hash_value */
+        struct HashFrame {
+            enum class Kind { Pairs, Block, AA };
 
-        size_t seed = 0;
-        wseml::hash::hash_combine(seed, objType);
+            HashFrame(Kind kind, std::size_t seed, std::list<Pair>::const_iterator next, std::list<Pair>::const_iterator end)
+                : kind(kind), seed(seed), next(next), end(end) {
+            }
 
-        if (w.obj_->structureTypeInfo() == StructureType::String) {
-            ByteString* byteStringObj = dynamic_cast<ByteString*>(w.obj_.get());
-            wseml::hash::hash_combine(seed, byteStringObj->get());
-            return seed;
-        }
+            Kind kind;
+            std::size_t seed;
+            std::list<Pair>::const_iterator next;
+            std::list<Pair>::const_iterator end;
+            /* the sequential seed of the pairs, or the sum of the seeds of the data of a Block */
+            std::size_t accumulation = 0;
+            /* the member of the current pair whose hash is awaited, and the seed of that pair */
+            int field = 0;
+            std::size_t pairSeed = 0;
+            /* the merged copy of an AA, hashed in its place */
+            std::unique_ptr<WSEML> merged;
+
+            const WSEML* nextChild() {
+                switch (kind) {
+                    case Kind::AA:
+                        return merged ? &merged->getList().front() : nullptr;
+                    case Kind::Block:
+                        return next != end ? &next->getData() : nullptr;
+                    case Kind::Pairs:
+                        if (next == end) {
+                            return nullptr;
+                        }
+                        switch (field) {
+                            case 0:
+                                return &next->getKey();
+                            case 1:
+                                return &next->getData();
+                            case 2:
+                                return &next->getKeyRole();
+                            default:
+                                return &next->getDataRole();
+                        }
+                }
+                return nullptr;
+            }
 
-        if (w.obj_->structureTypeInfo() == StructureType::List and objType == AATYPE) {
-            WSEML merged = merge(w);
-            if (not merged.getInnerList().empty()) {
-                wseml::hash::hash_combine(seed, merged.getList().front());
+            void consume(std::size_t childHash) {
+                switch (kind) {
+                    case Kind::AA:
+                        hash::hash_combine_hashed(seed, childHash);
+                        merged.reset();
+                        break;
+                    case Kind::Block: {
+                        std::size_t elementSeed = 0;
+                        hash::hash_combine_hashed(elementSeed, childHash);
+                        accumulation += elementSeed;
+                        ++next;
+                        break;
+                    }
+                    case Kind::Pairs:
+                        hash::hash_combine_hashed(pairSeed, childHash);
+                        if (++field == 2 and not next->hasRoles()) {
+                            /* the hashes of the two absent roles */
+                            hash::hash_combine_hashed(pairSeed, 0);
+                            hash::hash_combine_hashed(pairSeed, 0);
+                            field = 4;
+                        }
+                        if (field == 4) {
+                            hash::hash_combine_hashed(accumulation, pairSeed);
+                            field = 0;
+                            pairSeed = 0;
+                            ++next;
+                        }
+                        break;
+                }
             }
-            return seed;
-        }
 
-        if (w.obj_->structureTypeInfo() == StructureType::List and objType == BLOCKTYPE) {
-            const std::list<Pair>& pairList = w.getInnerList();
-            auto dataView = pairList | std::ranges::views::transform([](const auto& pair) { return pair.getData(); });
-            wseml::hash::hash_combine(seed, wseml::hash::hash_unordered_range(dataView.begin(), dataView.end()));
-            return seed;
+            std::size_t result() {
+                if (kind != Kind::AA) {
+                    hash::hash_combine(seed, accumulation);
+                }
+                return seed;
+            }
+        };
+
+        /* hashes the common leaves (absent objects, untyped strings and shared nodes) without a frame */
+        bool hashLeaf(const WSEML& w, std::size_t& leafHash) {
+            if (const SharedNode* node = w.getSharedNode()) {
+                leafHash = node->hash;
+                return true;
+            }
+            StructureType structure = w.structureTypeInfo();
+            if (structure == StructureType::None) {
+                leafHash = 0;
+                return true;
+            }
+            if (structure != StructureType::String or w.getSemanticType().hasObject()) {
+                return false;
+            }
+            leafHash = 0;
+            /* the hash of the absent semantic type */
+            hash::hash_combine_hashed(leafHash, 0);
+            /* hashes as the std::string would */
+            std::string buffer;
+            hash::hash_combine(leafHash, w.getStringView(buffer));
+            return true;
         }
 
-        if (w.obj_->structureTypeInfo() == StructureType::List) {
+        /* returns the hash of a string, or pushes the frame of a List and returns nothing */
+        std::optional<std::size_t> startHash(const WSEML& w, std::vector<HashFrame>& stack) {
+            const Object* obj = w.getRawObject();
+            const WSEML& objType = w.getSemanticType();
+
+            size_t seed = 0;
+            wseml::hash::hash_combine(seed, objType);
+
+            if (obj->structureTypeInfo() == StructureType::String) {
+                wseml::hash::hash_combine(seed, static_cast<const ByteString*>(obj)->get());
+                return seed;
+            }
+
+            if (objType == AATYPE) {
+                auto merged = std::make_unique<WSEML>(merge(w));
+                if (merged->getInnerList().empty()) {
+                    return seed;
+                }
+                stack.emplace_back(HashFrame::Kind::AA, seed, std::list<Pair>::const_iterator(), std::list<Pair>::const_iterator());
+                stack.back().merged = std::move(merged);
+                return std::nullopt;
+            }
+
             const std::list<Pair>& pairList = w.getInnerList();
-            wseml::hash::hash_combine(seed, wseml::hash::hash_range(pairList.begin(), pairList.end()));
-            return seed;
+            stack.emplace_back(objType == BLOCKTYPE ? HashFrame::Kind::Block : HashFrame::Kind::Pairs, seed, pairList.begin(), pairList.end());
+            return std::nullopt;
         }
+    } // namespace
 
-        throw std::runtime_error("Unsupported type");
+    size_t hash_value(const WSEML& w) {
+        std::size_t leafHash = 0;
+        if (hashLeaf(w, leafHash)) {
+            return leafHash;
+        }
+        std::vector<HashFrame> stack;
+        std::optional<std::size_t> value = startHash(w, stack);
+        while (not stack.empty()) {
+            HashFrame& frame = stack.back();
+            if (value) {
+                frame.consume(*value);
+                value.reset();
+            }
+            const WSEML* child = frame.nextChild();
+            while (child != nullptr and hashLeaf(*child, leafHash)) {
+                frame.consume(leafHash);
+                child = frame.nextChild();
+            }
+            if (child == nullptr) {
+                value = frame.result();
+                stack.pop_back();
+                continue;
+            }
+            value = startHash(*child, stack);
+        }
+        return *value;
     }
 
     std::ostream& operator<<(std::ostream& os, const WSEML& wseml) {
@@ -288,22 +857,42 @@ namespace wseml {
 
     /* Object implementation */
 
+    namespace {
+        /* the bits of Object::containingPair_ that mark a frozen, a watched and an escaped object */
+        constexpr std::uintptr_t FROZEN_BIT = 1;
+        constexpr std::uintptr_t WATCHED_BIT = 2;
+        constexpr std::uintptr_t ESCAPED_BIT = 4;
+        constexpr std::uintptr_t FLAG_BITS = FROZEN_BIT | WATCHED_BIT | ESCAPED_BIT;
+        static_assert(alignof(Pair) > FLAG_BITS, "the flags of an object are stored in the alignment bits of a Pair pointer");
+    } // namespace
+
     Object::Object(const WSEML& type, Pair* pair)
         : semanticType_(type)
-        , containingPair_(pair) {
+        , containingPair_(reinterpret_cast<std::uintptr_t>(pair)) {
+        objectAllocations++;
+    }
+
+    Object::Object(const Object& other)
+        : semanticType_(other.semanticType_)
+        , containingPair_(other.containingPair_.load(std::memory_order_relaxed) & ~FLAG_BITS) {
+        objectAllocations++;
     }
 
     Object::~Object() = default;
 
     void Object::setContainingPair(Pair* p) {
-        containingPair_ = p;
+        assertMutable();
+        std::uintptr_t flags = containingPair_.load(std::memory_order_relaxed) & FLAG_BITS;
+        containingPair_.store(reinterpret_cast<std::uintptr_t>(p) | flags, std::memory_order_relaxed);
     }
 
     Pair* Object::getContainingPair() const {
-        return containingPair_;
+        return reinterpret_cast<Pair*>(containingPair_.load(std::memory_order_relaxed) & ~FLAG_BITS);
     }
 
     WSEML& Object::getSemanticType() {
+        assertMutable();
+        noteEscape();
         return semanticType_;
     }
 
@@ -312,9 +901,51 @@ namespace wseml {
     }
 
     void Object::setSemanticType(const WSEML& newType) {
+        assertMutable();
+        noteModification();
         semanticType_ = newType;
     }
 
+    bool Object::isFrozen() const {
+        return (containingPair_.load(std::memory_order_relaxed) & FROZEN_BIT) != 0;
+    }
+
+    void Object::setFrozen() {
+        containingPair_.fetch_or(FROZEN_BIT, std::memory_order_relaxed);
+    }
+
+    void Object::inheritFlags(const Object& holder) {
+        containingPair_.fetch_or(holder.containingPair_.load(std::memory_order_relaxed) & (FROZEN_BIT | WATCHED_BIT), std::memory_order_relaxed);
+    }
+
+    bool Object::watch() const {
+        std::uintptr_t flags = containingPair_.load(std::memory_order_relaxed);
+        if ((flags & WATCHED_BIT) == 0) {
+            flags = containingPair_.fetch_or(WATCHED_BIT, std::memory_order_relaxed);
+        }
+        return (flags & ESCAPED_BIT) == 0;
+    }
+
+    void Object::noteModification() {
+        if ((containingPair_.load(std::memory_order_relaxed) & WATCHED_BIT) != 0) {
+            countModification();
+        }
+    }
+
+    void Object::assertMutable() const {
+        assert(not isFrozen() and "attempt to modify a frozen WSEML tree");
+    }
+
+    void Object::noteEscape() {
+        std::uintptr_t flags = containingPair_.load(std::memory_order_relaxed);
+        if ((flags & ESCAPED_BIT) == 0) {
+            flags = containingPair_.fetch_or(ESCAPED_BIT, std::memory_order_relaxed);
+        }
+        if ((flags & WATCHED_BIT) != 0) {
+            countModification();
+        }
+    }
+
     /* ByteString implementation */
 
     ByteString::ByteString(std::string str, const WSEML& type, Pair* p)
@@ -329,6 +960,8 @@ namespace wseml {
     }
 
     std::string& ByteString::get() {
+        assertMutable();
+        noteEscape();
         return bytes_;
     }
 
@@ -371,6 +1004,10 @@ namespace wseml {
         setContainingPair(p);
     }
 
+    void ByteString::updateLinks(Pair* p, [[maybe_unused]] WSEML* holder) {
+        setContainingPair(p);
+    }
+
     /* List implementation */
 
     List::List()
@@ -383,13 +1020,155 @@ namespace wseml {
         , pairList_(std::move(l)) {
     }
 
-    List::~List() = default;
+    List::List(const List& other)
+        : List(other, MetadataOnly{}) {
+        copyPairsFrom(other);
+    }
+
+    struct List::Attachments {
+        std::unique_ptr<KeyFilter> keyFilter;
+        std::unique_ptr<TriggerIndex> triggerIndex;
+        std::unique_ptr<AutoCompaction> autoCompaction;
+        std::unique_ptr<UndoLog> undoLog;
+    };
+
+    List::List(const List& other, MetadataOnly)
+        : Object(other)
+        , nextKey_(other.nextKey_) {
+        if (const Attachments* source = other.attachments_.get()) {
+            if (source->keyFilter) {
+                setKeyFilter(std::make_unique<KeyFilter>(*source->keyFilter));
+            }
+            if (source->triggerIndex) {
+                setTriggerIndex(std::make_unique<TriggerIndex>());
+            }
+            if (source->autoCompaction) {
+                setAutoCompaction(std::make_unique<AutoCompaction>(*source->autoCompaction));
+            }
+        }
+    }
+
+    void List::copyPairsFrom(const List& source) {
+        /* the pairs of a nested List are copied once the List is in place, so the copy does not recurse */
+        struct PendingCopy {
+            const List* source;
+            List* target;
+            WSEML* holder;
+        };
+        std::vector<PendingCopy> pending{{&source, this, nullptr}};
+        auto copyHandle = [](const WSEML& handle) {
+            const Object* obj = handle.heldObject();
+            if (not obj or obj->structureTypeInfo() != StructureType::List) {
+                return WSEML(handle);
+            }
+            return WSEML(std::unique_ptr<List>(new List(static_cast<const List&>(*obj), MetadataOnly{})));
+        };
+        while (not pending.empty()) {
+            PendingCopy current = pending.back();
+            pending.pop_back();
+            for (const Pair& pair : current.source->pairList_) {
+                Pair& copy = current.target->pairList_.emplace_back(current.holder, copyHandle(pair.key_), copyHandle(pair.data_));
+                if (const Pair::Roles* roles = pair.roles()) {
+                    copy.setRoles(std::make_unique<Pair::Roles>(copyHandle(roles->keyRole), copyHandle(roles->dataRole)));
+                    copy.roles()->keyRole.updateLinks(&copy);
+                    copy.roles()->dataRole.updateLinks(&copy);
+                }
+                auto queueNested = [&](const WSEML& from, WSEML& to) {
+                    const Object* obj = from.heldObject();
+                    if (obj and obj->structureTypeInfo() == StructureType::List) {
+                        pending.push_back({&static_cast<const List&>(*obj), &static_cast<List&>(*to.heldObject()), &to});
+                    }
+                };
+                queueNested(pair.key_, copy.key_);
+                queueNested(pair.data_, copy.data_);
+                if (const Pair::Roles* roles = pair.roles()) {
+                    queueNested(roles->keyRole, copy.roles()->keyRole);
+                    queueNested(roles->dataRole, copy.roles()->dataRole);
+                }
+            }
+        }
+    }
+
+    List::~List() {
+        std::vector<std::unique_ptr<Object>> pending;
+        releaseNested(pending);
+        while (not pending.empty()) {
+            std::unique_ptr<Object> nested = std::move(pending.back());
+            pending.pop_back();
+            static_cast<List&>(*nested).releaseNested(pending);
+        }
+    }
+
+    void List::releaseNested(std::vector<std::unique_ptr<Object>>& pending) {
+        for (Pair& pair : pairList_) {
+            pair.forEachMember([&](WSEML& handle) {
+                /* the last handle of a shared node takes its tree, so that chains of nodes are not destroyed recursively */
+                WSEML* owner = &handle;
+                if (SharedNode* node = handle.soleNode()) {
+                    owner = &node->tree;
+                }
+                Object* obj = owner->heldObject();
+                if (obj and obj->structureTypeInfo() == StructureType::List and not static_cast<List&>(*obj).pairList_.empty()) {
+                    pending.emplace_back(owner->release());
+                }
+            });
+        }
+    }
+
+    List::Attachments& List::attachments() {
+        if (not attachments_) {
+            attachments_ = std::make_unique<Attachments>();
+        }
+        return *attachments_;
+    }
+
+    KeyFilter* List::getKeyFilter() const {
+        return attachments_ ? attachments_->keyFilter.get() : nullptr;
+    }
+
+    void List::setKeyFilter(std::unique_ptr<KeyFilter> filter) {
+        if (filter or attachments_) {
+            attachments().keyFilter = std::move(filter);
+        }
+    }
+
+    TriggerIndex* List::getTriggerIndex() const {
+        return attachments_ ? attachments_->triggerIndex.get() : nullptr;
+    }
+
+    void List::setTriggerIndex(std::unique_ptr<TriggerIndex> index) {
+        if (index or attachments_) {
+            attachments().triggerIndex = std::move(index);
+        }
+    }
+
+    AutoCompaction* List::getAutoCompaction() const {
+        return attachments_ ? attachments_->autoCompaction.get() : nullptr;
+    }
+
+    void List::setAutoCompaction(std::unique_ptr<AutoCompaction> autoCompaction) {
+        if (autoCompaction or attachments_) {
+            attachments().autoCompaction = std::move(autoCompaction);
+        }
+    }
+
+    UndoLog* List::getUndoLog() const {
+        return attachments_ ? attachments_->undoLog.get() : nullptr;
+    }
+
+    void List::setUndoLog(std::unique_ptr<UndoLog> undoLog) {
+        if (undoLog or attachments_) {
+            attachments().undoLog = std::move(undoLog);
+        }
+    }
 
     std::unique_ptr<Object> List::clone() const {
         return std::make_unique<List>(*this);
     }
 
     std::list<Pair>& List::get() {
+        assertMutable();
+        noteEscape();
         return pairList_;
     }
 
@@ -401,12 +1180,35 @@ namespace wseml {
         return StructureType::List;
     }
 
+    WSEML List::numberKey(std::size_t number) {
+        char digits[std::numeric_limits<std::size_t>::digits10 + 1];
+        std::string_view key(digits, std::to_chars(std::begin(digits), std::end(digits), number).ptr);
+        if (key.size() > INLINE_CAPACITY) {
+            return WSEML(std::string(key));
+        }
+        WSEML handle;
+        handle.word_.store(encodeInline(key), std::memory_order_relaxed);
+        return handle;
+    }
+
     WSEML List::genKey() {
-        WSEML key = WSEML(std::to_string(this->nextKey_));
-        this->nextKey_ += 2;
+        WSEML key = numberKey(this->nextKey_);
+        this->nextKey_ += KEY_STEP;
         return key;
     }
 
+    WSEML List::keyAt(std::size_t index) {
+        return numberKey(FIRST_KEY + KEY_STEP * index);
+    }
+
+    void List::setNextKeyAfter(std::size_t count) {
+        nextKey_ = static_cast<unsigned int>(FIRST_KEY + KEY_STEP * count);
+    }
+
+    std::size_t List::generatedKeyCount() const {
+        return (nextKey_ - FIRST_KEY) / KEY_STEP;
+    }
+
     unsigned int& List::getCurMaxKey() {
         return this->nextKey_;
     }
@@ -421,7 +1223,13 @@ namespace wseml {
 
     WSEML& List::find(const WSEML& key) {
         auto it = findPair(key);
-        return (it != pairList_.end()) ? it->getData() : NULLOBJ;
+        if (it != pairList_.end()) {
+            return it->getData();
+        }
+        /* a mutable reference to the shared NULLOBJ would let callers on any thread overwrite it */
+        thread_local WSEML missing;
+        missing = WSEML();
+        return missing;
     }
 
     const WSEML& List::find(const WSEML& key) const {
@@ -442,7 +1250,7 @@ namespace wseml {
     bool List::erase(const WSEML& key) {
         auto it = findPair(key);
         if (it != pairList_.end()) {
-            this->pairList_.erase(it);
+            erase(it);
             return true;
         }
         return false;
@@ -452,19 +1260,48 @@ namespace wseml {
         return erase(WSEML(key));
     }
 
+    List::iterator List::erase(iterator pos) {
+        noteModification();
+        return pairList_.erase(pos);
+    }
+
+    List::iterator List::erase(iterator first, iterator last) {
+        noteModification();
+        return pairList_.erase(first, last);
+    }
+
+    Pair& List::emplace_back(WSEML* listOwner, WSEML key, WSEML data, WSEML keyRole, WSEML dataRole) {
+        noteModification();
+        return pairList_.emplace_back(listOwner, std::move(key), std::move(data), std::move(keyRole), std::move(dataRole));
+    }
+
+    Pair& List::appendMoved(WSEML* listOwner, WSEML&& key, WSEML&& data) {
+        noteModification();
+        return pairList_.emplace_back(Pair::MovedIn{}, listOwner, std::move(key), std::move(data));
+    }
+
+    void List::splice(iterator pos, List& other) {
+        noteModification();
+        other.noteModification();
+        pairList_.splice(pos, other.pairList_);
+    }
+
     WSEML List::append(WSEML* listPtr, WSEML data, WSEML key, WSEML keyRole, WSEML dataRole) {
+        noteModification();
         WSEML finalKey = (key == NULLOBJ) ? genKey() : std::move(key);
         pairList_.emplace_back(listPtr, finalKey, std::move(data), std::move(keyRole), std::move(dataRole));
         return finalKey;
     }
 
     WSEML List::appendFront(WSEML* listOwner, WSEML data, WSEML key, WSEML keyRole, WSEML dataRole) {
+        noteModification();
         WSEML finalKey = (key == NULLOBJ) ? genKey() : std::move(key);
         pairList_.emplace_front(listOwner, finalKey, std::move(data), std::move(keyRole), std::move(dataRole));
         return finalKey;
     }
 
     void List::pop_back() {
+        noteModification();
         if (!pairList_.empty()) {
             pairList_.back().setListOwner(nullptr);
             pairList_.pop_back();
@@ -472,6 +1309,7 @@ namespace wseml {
     }
 
     WSEML List::insert(iterator pos, WSEML* listOwner, WSEML data, WSEML key, WSEML keyRole, WSEML dataRole) {
+        noteModification();
         WSEML finalKey = (key == NULLOBJ) ? genKey() : std::move(key);
         pairList_.emplace(pos, listOwner, finalKey, std::move(data), std::move(keyRole), std::move(dataRole));
         return finalKey;
@@ -580,63 +1418,102 @@ namespace wseml {
         }
     }
 
+    void List::updateLinks(Pair* p, WSEML* holder) {
+        setContainingPair(p);
+        for (auto& pair : pairList_) {
+            pair.setListOwner(holder);
+        }
+    }
+
     /* Pair implementation */
 
+    std::unique_ptr<Pair::Roles> Pair::makeRoles(WSEML keyRole, WSEML dataRole) {
+        if (not keyRole.hasObject() and not dataRole.hasObject()) {
+            return nullptr;
+        }
+        return std::make_unique<Roles>(std::move(keyRole), std::move(dataRole));
+    }
+
+    Pair::Roles* Pair::roles() const {
+        return (owner_ & ROLES_BIT) != 0 ? reinterpret_cast<Roles*>(owner_ & ~ROLES_BIT) : nullptr;
+    }
+
+    void Pair::setRoles(std::unique_ptr<Roles> roles) {
+        WSEML* listOwner = getListOwner();
+        delete this->roles();
+        if (roles) {
+            roles->listOwner = listOwner;
+            owner_ = reinterpret_cast<std::uintptr_t>(roles.release()) | ROLES_BIT;
+        } else {
+            owner_ = reinterpret_cast<std::uintptr_t>(listOwner);
+        }
+    }
+
     Pair::Pair(WSEML* listPtr, WSEML key, WSEML data, WSEML keyRole, WSEML dataRole)
         : key_(std::move(key))
         , data_(std::move(data))
-        , keyRole_(std::move(keyRole))
-        , dataRole_(std::move(dataRole))
-        , listOwner_(listPtr) {
-        this->updateLinksRecursively(listPtr);
+        , owner_(reinterpret_cast<std::uintptr_t>(listPtr)) {
+        setRoles(makeRoles(std::move(keyRole), std::move(dataRole)));
+        this->updateLinks(listPtr);
     }
 
-    Pair::Pair(const Pair& other) {
-        if (this != &other) {
-            key_ = other.key_;
-            data_ = other.data_;
-            keyRole_ = other.keyRole_;
-            dataRole_ = other.dataRole_;
-            listOwner_ = nullptr;
-            this->updateLinksRecursively(this->listOwner_);
+    Pair::Pair(MovedIn, WSEML* listPtr, WSEML&& key, WSEML&& data)
+        : owner_(reinterpret_cast<std::uintptr_t>(listPtr)) {
+        key_.adopt(key);
+        data_.adopt(data);
+        this->updateLinks(listPtr);
+    }
+
+    Pair::Pair(const Pair& other)
+        : key_(other.key_)
+        , data_(other.data_) {
+        if (const Roles* roles = other.roles()) {
+            setRoles(std::make_unique<Roles>(roles->keyRole, roles->dataRole));
         }
+        this->updateLinks(nullptr);
     }
 
     Pair::Pair(Pair&& other) noexcept
         : key_(std::move(other.key_))
         , data_(std::move(other.data_))
-        , keyRole_(std::move(other.keyRole_))
-        , dataRole_(std::move(other.dataRole_))
-        , listOwner_(other.listOwner_) {
-        other.listOwner_ = nullptr;
-        this->updateLinksRecursively(this->listOwner_);
+        , owner_(other.owner_) {
+        other.owner_ = 0;
+        this->updateLinks(getListOwner());
     }
 
     Pair& Pair::operator=(const Pair& other) {
         if (this != &other) {
+            noteModification();
             key_ = other.key_;
             data_ = other.data_;
-            keyRole_ = other.keyRole_;
-            dataRole_ = other.dataRole_;
-            listOwner_ = nullptr;
-            this->updateLinksRecursively(this->listOwner_);
+            delete roles();
+            owner_ = 0;
+            if (const Roles* roles = other.roles()) {
+                setRoles(std::make_unique<Roles>(roles->keyRole, roles->dataRole));
+            }
+            this->updateLinks(nullptr);
         }
         return *this;
     }
 
     Pair& Pair::operator=(Pair&& other) noexcept {
         if (this != &other) {
+            noteModification();
+            other.noteModification();
             key_ = std::move(other.key_);
             data_ = std::move(other.data_);
-            keyRole_ = std::move(other.keyRole_);
-            dataRole_ = std::move(other.dataRole_);
-            listOwner_ = other.listOwner_;
-            other.listOwner_ = nullptr;
-            this->updateLinksRecursively(this->listOwner_);
+            delete roles();
+            owner_ = other.owner_;
+            other.owner_ = 0;
+            this->updateLinks(getListOwner());
         }
         return *this;
     }
 
+    Pair::~Pair() {
+        delete roles();
+    }
+
     WSEML& Pair::getKey() {
         return key_;
     }
@@ -645,14 +1522,6 @@ namespace wseml {
         return data_;
     }
 
-    WSEML& Pair::getKeyRole() {
-        return keyRole_;
-    }
-
-    WSEML& Pair::getDataRole() {
-        return dataRole_;
-    }
-
     const WSEML& Pair::getKey() const {
         return key_;
     }
@@ -662,31 +1531,72 @@ namespace wseml {
     }
 
     const WSEML& Pair::getKeyRole() const {
-        return keyRole_;
+        const Roles* roles = this->roles();
+        return roles ? roles->keyRole : NULLOBJ;
     }
 
     const WSEML& Pair::getDataRole() const {
-        return dataRole_;
+        const Roles* roles = this->roles();
+        return roles ? roles->dataRole : NULLOBJ;
+    }
+
+    void Pair::setKeyRole(WSEML keyRole) {
+        noteModification();
+        Roles* roles = this->roles();
+        setRoles(makeRoles(std::move(keyRole), roles ? std::move(roles->dataRole) : WSEML()));
+        if ((roles = this->roles())) {
+            roles->keyRole.updateLinks(this);
+            roles->dataRole.updateLinks(this);
+        }
+    }
+
+    void Pair::setDataRole(WSEML dataRole) {
+        noteModification();
+        Roles* roles = this->roles();
+        setRoles(makeRoles(roles ? std::move(roles->keyRole) : WSEML(), std::move(dataRole)));
+        if ((roles = this->roles())) {
+            roles->keyRole.updateLinks(this);
+            roles->dataRole.updateLinks(this);
+        }
+    }
+
+    bool Pair::hasRoles() const {
+        return (owner_ & ROLES_BIT) != 0;
     }
 
     WSEML* Pair::getListOwner() const {
-        return listOwner_;
+        const Roles* roles = this->roles();
+        return roles ? roles->listOwner : reinterpret_cast<WSEML*>(owner_);
     }
 
     void Pair::setListOwner(WSEML* lst) {
-        listOwner_ = lst;
+        if (Roles* roles = this->roles()) {
+            roles->listOwner = lst;
+        } else {
+            owner_ = reinterpret_cast<std::uintptr_t>(lst);
+        }
+    }
+
+    void Pair::noteModification() {
+        WSEML* listOwner = getListOwner();
+        if (listOwner != nullptr and listOwner->heldObject()) {
+            listOwner->heldObject()->noteModification();
+        }
     }
 
     bool Pair::operator==(const Pair& p) const {
-        return (this->key_ == p.key_) && (this->data_ == p.data_) && (this->keyRole_ == p.keyRole_) && (this->dataRole_ == p.dataRole_);
+        return (this->key_ == p.key_) && (this->data_ == p.data_) && (this->getKeyRole() == p.getKeyRole()) &&
+               (this->getDataRole() == p.getDataRole());
     }
 
     void Pair::updateLinksRecursively(WSEML* holder) {
         setListOwner(holder);
-        key_.updateLinksRecursively(this);
-        data_.updateLinksRecursively(this);
-        keyRole_.updateLinksRecursively(this);
-        dataRole_.updateLinksRecursively(this);
+        forEachMember([this](WSEML& member) { member.updateLinksRecursively(this); });
+    }
+
+    void Pair::updateLinks(WSEML* holder) {
+        setListOwner(holder);
+        forEachMember([this](WSEML& member) { member.updateLinks(this); });
     }
 
     std::size_t hash_value(const Pair& p) {
@@ -704,6 +1614,8 @@ namespace wseml {
     }
 
     bool WSEML::one_step() {
+        ProgramFrame frame("one_step");
+        InstructionTimer timer("init", NULLOBJ);
         List* procList = dynamic_cast<List*>(this->getRawObject());
         WSEML& stck = procList->find("stck");
         if (stck == NULLOBJ) {
@@ -731,6 +1643,9 @@ namespace wseml {
             WSEML& curFrmKey = wfrm->front();
             WSEML& curFrm = curStackList->find(curFrmKey);
             WSEML curFrmType = curFrm.getSemanticType();
+            if (getActiveProfiler() != nullptr) {
+                timer.relabel(profileLabel(curFrmType), curFrmKey);
+            }
 
             List* tables = dynamic_cast<List*>(procList->find("tables").getRawObject());
             List* disp = dynamic_cast<List*>(tables->find("disp").getRawObject());
@@ -1,13 +1,24 @@
+#include <array>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <unordered_map>
+#include <vector>
 #include <dlfcn.h>
 #include <ranges>
 #include <iostream>
 #include <optional>
+#include <thread>
+#include <utility>
 #include "../include/WSEML.hpp"
 #include "../include/associativeArray.hpp"
+#include "../include/bindingStore.hpp"
+#include "../include/builder.hpp"
 #include "../include/executor.hpp"
+#include "../include/functionCache.hpp"
+#include "../include/triggerIndex.hpp"
+#include "../include/undoLog.hpp"
+#include "../include/workStealingPool.hpp"
 
 namespace ranges = std::ranges;
 namespace views = std::views;
@@ -20,7 +31,7 @@ namespace wseml {
     WSEML PLACEHOLDERTYPE = WSEML("@PLACEHOLDERTYPE@");
     WSEML ANPLACEHOLDER = createPlaceholder("ANPLACEHOLDER");
 
-    WSEML createFunctionalAssociation(const WSEML& triggerType, const WSEML& functionReference) {
+    WSEML createFunctionalAssociation(const WSEML& triggerType, const WSEML& functionReference, bool pure) {
         if (not isFunctionReference(functionReference)) {
             throw std::runtime_error("createFunctionalAssociation: functionReference is not a valid function reference");
         }
@@ -28,26 +39,66 @@ namespace wseml {
         WSEML funcAssoc = WSEML(std::list<Pair>(), FUNC_ASSOC_TYPE);
         funcAssoc.append(triggerType, WSEML("trigger_type"));
         funcAssoc.append(functionReference, WSEML("function_reference"));
+        if (pure) {
+            funcAssoc.append(WSEML("true"), WSEML("pure"));
+        }
         return funcAssoc;
     }
 
+    namespace {
+        /* List::find(std::string) without the temporary WSEML: the key must be an untyped string equal to name */
+        const WSEML* findField(const WSEML& obj, std::string_view name) {
+            std::string buffer;
+            for (const Pair& pair : obj.getInnerList()) {
+                const WSEML& key = pair.getKey();
+                if (key.structureTypeInfo() == StructureType::String and not key.getSemanticType().hasObject() and
+                    key.getStringView(buffer) == name) {
+                    return &pair.getData();
+                }
+            }
+            return nullptr;
+        }
+
+        bool hasField(const WSEML& obj, std::string_view name) {
+            const WSEML* field = findField(obj, name);
+            return field != nullptr and field->hasObject();
+        }
+    } // namespace
+
     bool isFunctionalAssociation(const WSEML& obj) {
-        return (obj.hasObject() and obj.getSemanticType() == FUNC_ASSOC_TYPE) and (obj.getRawObject()->structureTypeInfo() == StructureType::List) and
-               (obj.getList().find("trigger_type") != NULLOBJ) and (obj.getList().find("function_reference") != NULLOBJ);
+        return (obj.structureTypeInfo() == StructureType::List and obj.getSemanticType() == FUNC_ASSOC_TYPE) and
+               hasField(obj, "trigger_type") and hasField(obj, "function_reference");
     }
 
     const WSEML& getFuncAssocTriggerType(const WSEML& funcAssoc) {
         if (not isFunctionalAssociation(funcAssoc)) {
             throw std::runtime_error("getFuncAssocTriggerType: funcAssoc is not a valid functional association");
         }
-        return funcAssoc.getList().find("trigger_type");
+        return *findField(funcAssoc, "trigger_type");
     }
 
     const WSEML& getFuncAssocFunction(const WSEML& funcAssoc) {
         if (not isFunctionalAssociation(funcAssoc)) {
             throw std::runtime_error("getFuncAssocFunction: funcAssoc is not a valid functional association");
         }
-        return funcAssoc.getList().find("function_reference");
+        return *findField(funcAssoc, "function_reference");
+    }
+
+    bool isPureFunctionalAssociation(const WSEML& funcAssoc) {
+        if (not isFunctionalAssociation(funcAssoc)) {
+            throw std::runtime_error("isPureFunctionalAssociation: funcAssoc is not a valid functional association");
+        }
+        const WSEML* pure = findField(funcAssoc, "pure");
+        std::string buffer;
+        return pure != nullptr and pure->structureTypeInfo() == StructureType::String and not pure->getSemanticType().hasObject() and
+               pure->getStringView(buffer) == "true";
+    }
+
+    WSEML callFunctionalAssociation(const WSEML& funcAssoc, const WSEML& key) {
+        if (isPureFunctionalAssociation(funcAssoc)) {
+            return getFunctionResultCache().call(getFuncAssocFunction(funcAssoc), key);
+        }
+        return callFunction(getFuncAssocFunction(funcAssoc), key);
     }
 
     /* Functions */
@@ -68,7 +119,7 @@ namespace wseml {
     }
 
     bool isFunctionReference(const WSEML& obj) {
-        return obj.hasObject() and obj.getSemanticType() == FUNCTION_TYPE and obj.getRawObject()->structureTypeInfo() == StructureType::List and
+        return obj.hasObject() and obj.getSemanticType() == FUNCTION_TYPE and obj.structureTypeInfo() == StructureType::List and
                obj.getList().find("path") != NULLOBJ and obj.getList().find("funcName") != NULLOBJ and obj.getList().find("function_type") != NULLOBJ;
     }
 
@@ -122,7 +173,6 @@ namespace wseml {
 
             WsemlFuncPtr funcPtr = reinterpret_cast<WsemlFuncPtr>(sym);
             WSEML result = NULLOBJ;
-            std::cout << "Result: '" << result << "'" << std::endl;
 
             try {
                 const WSEML* retPtr = funcPtr(&args);
@@ -154,7 +204,7 @@ namespace wseml {
 
     WSEML createKeyValueAssociation(WSEML key, WSEML value) {
         WSEML keyValueAssociation(std::make_unique<List>(std::list<Pair>(), KV_ASSOC_TYPE));
-        keyValueAssociation.append(value, key);
+        keyValueAssociation.append(std::move(value), std::move(key));
         return keyValueAssociation;
     }
 
@@ -172,6 +222,38 @@ namespace wseml {
         return obj.hasObject() and obj.getSemanticType() == PLACEHOLDERTYPE;
     }
 
+    bool containsPlaceholder(const WSEML& obj) {
+        if (isPlaceholder(obj)) {
+            return true;
+        }
+        if (not obj.hasObject() or obj.structureTypeInfo() != StructureType::List) {
+            return false;
+        }
+        for (const Pair& pair : obj.getInnerList()) {
+            if (containsPlaceholder(pair.getKey()) or containsPlaceholder(pair.getData()) or containsPlaceholder(pair.getKeyRole()) or
+                containsPlaceholder(pair.getDataRole())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool containsAssociativeStructure(const WSEML& obj) {
+        if (not obj.hasObject() or obj.structureTypeInfo() != StructureType::List) {
+            return false;
+        }
+        if (isAssociativeArray(obj) or isBlock(obj)) {
+            return true;
+        }
+        for (const Pair& pair : obj.getInnerList()) {
+            if (containsAssociativeStructure(pair.getKey()) or containsAssociativeStructure(pair.getData()) or
+                containsAssociativeStructure(pair.getKeyRole()) or containsAssociativeStructure(pair.getDataRole())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     bool isKeyValueAssociation(const WSEML& obj) {
         return obj.hasObject() and obj.structureTypeInfo() == StructureType::List and obj.getSemanticType() == KV_ASSOC_TYPE and
                obj.getInnerList().size() == 1;
@@ -185,6 +267,136 @@ namespace wseml {
 
     /* Modifications */
 
+    namespace {
+        void autoCompact(WSEML& aa);
+
+        /* watches every object of a tree; false if one of them may have been edited without being counted. The
+           semantic types are covered by their owners, since they can only be edited through a mutable access to them */
+        bool watchTree(const WSEML& root) {
+            std::vector<const WSEML*> pending{&root};
+            while (not pending.empty()) {
+                const WSEML* current = pending.back();
+                pending.pop_back();
+                /* an inline string or a shared node changes only with the pair holding it, which counts against the
+                   watched List */
+                if (current->isInline() or current->isShared()) {
+                    continue;
+                }
+                const Object* obj = current->getRawObject();
+                /* the object assigned to an empty handle would not be counted */
+                if (obj == nullptr or not obj->watch()) {
+                    return false;
+                }
+                if (obj->structureTypeInfo() != StructureType::List) {
+                    continue;
+                }
+                for (const Pair& pair : current->getInnerList()) {
+                    pending.push_back(&pair.getKey());
+                    pending.push_back(&pair.getData());
+                }
+            }
+            return true;
+        }
+
+        /* watches what the key filter of a block reads of one of its associations */
+        bool watchForKeyFilter(const WSEML& assoc) {
+            if (assoc.isInline() or assoc.isShared()) {
+                return true;
+            }
+            const Object* obj = assoc.getRawObject();
+            if (obj == nullptr or not obj->watch()) {
+                return false;
+            }
+            return not isKeyValueAssociation(assoc) or watchTree(getKeyFromAssociation(assoc));
+        }
+
+        /* watches what the trigger index of an AA reads of one of its associations */
+        bool watchForTriggerIndex(const WSEML& assoc) {
+            if (assoc.isInline() or assoc.isShared()) {
+                return true;
+            }
+            const Object* obj = assoc.getRawObject();
+            if (obj == nullptr or not obj->watch()) {
+                return false;
+            }
+            return obj->getSemanticType() != FUNC_ASSOC_TYPE or watchTree(assoc);
+        }
+
+        /* the modifications of watched objects made during a change */
+        class ModificationWindow {
+        public:
+            ModificationWindow()
+                : start_(getModificationCount())
+                , ownStart_(getOwnModificationCount()) {
+            }
+
+            std::uint64_t start() const {
+                return start_;
+            }
+
+            /* the modification count at the end of the change, unless another thread modified watched objects meanwhile */
+            std::optional<std::uint64_t> ownEnd() const {
+                std::uint64_t end = getModificationCount();
+                if (end - start_ != getOwnModificationCount() - ownStart_) {
+                    return std::nullopt;
+                }
+                return end;
+            }
+
+        private:
+            std::uint64_t start_;
+            std::uint64_t ownStart_;
+        };
+
+        template <typename Cache>
+        Cache* currentCache(Cache* cache, const ModificationWindow& window) {
+            return cache != nullptr and cache->isCurrent(window.start()) ? cache : nullptr;
+        }
+
+        /* the trigger index of an AA if it is current at the start of a change */
+        TriggerIndex* currentTriggerIndex(const WSEML* aa, const ModificationWindow& window) {
+            if (aa == nullptr or not isAssociativeArray(*aa)) {
+                return nullptr;
+            }
+            return currentCache(aa->getList().getTriggerIndex(), window);
+        }
+
+        /* keeps a cache that was current at the start of a change current if the change preserved what it describes.
+           @p watchAdded watches what the change added, so that later edits of it are counted */
+        template <typename Cache, typename WatchAdded>
+        void followChange(Cache* cache, const ModificationWindow& window, WatchAdded&& watchAdded) {
+            if (cache == nullptr) {
+                return;
+            }
+            if (std::optional<std::uint64_t> end = window.ownEnd(); end and watchAdded()) {
+                cache->resync(*end);
+            } else {
+                cache->invalidate();
+            }
+        }
+
+        /* the undo log of the AA a block belongs to, present while a snapshot of the AA is open */
+        UndoLog* undoLogOf(WSEML& block) {
+            WSEML* aa = block.getContainingList();
+            return aa != nullptr and isAssociativeArray(*aa) ? aa->getList().getUndoLog() : nullptr;
+        }
+
+        void appendLogged(WSEML& owner, WSEML data, UndoLog* log) {
+            owner.append(std::move(data));
+            if (log != nullptr) {
+                log->recordInsertion(owner.getList(), std::prev(owner.getList().end()));
+            }
+        }
+
+        void eraseLogged(List& list, std::list<Pair>::iterator it, UndoLog* log) {
+            if (log != nullptr) {
+                log->recordRemoval(list, it, std::next(it));
+            } else {
+                list.erase(it);
+            }
+        }
+    } // namespace
+
     void appendBlock(WSEML& aa, const WSEML& block) {
         if (not isAssociativeArray(aa)) {
             throw std::runtime_error("appendBlock: aa is not an Associative Array");
@@ -192,15 +404,21 @@ namespace wseml {
         if (not isBlock(block)) {
             throw std::runtime_error("appendBlock: block is not a Block");
         }
-        aa.append(block);
+        appendLogged(aa, block, aa.getList().getUndoLog());
+        autoCompact(aa);
     }
 
     void popBlock(WSEML& aa) {
         if (not isAssociativeArray(aa)) {
             throw std::runtime_error("popBlock: aa is not an Associative Array");
         }
-        if (not aa.getInnerList().empty()) {
-            aa.getList().pop_back();
+        List& aaList = aa.getList();
+        if (not std::as_const(aa).getInnerList().empty()) {
+            if (UndoLog* log = aaList.getUndoLog()) {
+                eraseLogged(aaList, std::prev(aaList.end()), log);
+            } else {
+                aaList.pop_back();
+            }
         }
     }
 
@@ -209,8 +427,22 @@ namespace wseml {
             throw std::runtime_error("addKeyValueAssociationToBlock: Provided 'block' is not a Block");
         }
 
-        WSEML association = createKeyValueAssociation(std::move(key), std::move(value));
-        block.append(std::move(association));
+        ModificationWindow window;
+        const List& blockList = block.getList();
+        KeyFilter* filter = currentCache(blockList.getKeyFilter(), window);
+        std::size_t keyHash = filter != nullptr ? std::hash<WSEML>{}(key) : 0;
+        TriggerIndex* index = currentTriggerIndex(block.getContainingList(), window);
+
+        appendLogged(block, createKeyValueAssociation(std::move(key), std::move(value)), undoLogOf(block));
+        const WSEML& association = std::prev(blockList.end())->getData();
+        if (filter != nullptr) {
+            if (std::optional<std::uint64_t> end = window.ownEnd(); end and watchForKeyFilter(association)) {
+                filter->insert(keyHash, *end);
+            } else {
+                filter->invalidate();
+            }
+        }
+        followChange(index, window, [&] { return watchForTriggerIndex(association); });
     }
 
     void addFunctionalAssociationToBlock(WSEML& block, const WSEML& funcAssoc) {
@@ -220,7 +452,12 @@ namespace wseml {
         if (not isFunctionalAssociation(funcAssoc)) {
             throw std::runtime_error("addFunctionalAssociationToBlock: funcAssoc is not a Functional Association");
         }
-        block.append(funcAssoc);
+        ModificationWindow window;
+        const List& blockList = block.getList();
+        KeyFilter* filter = currentCache(blockList.getKeyFilter(), window);
+        appendLogged(block, funcAssoc, undoLogOf(block));
+        /* the trigger index of the AA is outdated by the count of the change */
+        followChange(filter, window, [&] { return watchForKeyFilter(std::prev(blockList.end())->getData()); });
     }
 
     void removeFunctionalAssociationFromBlock(WSEML& block, const WSEML& funcAssoc) {
@@ -236,7 +473,7 @@ namespace wseml {
             return isFunctionalAssociation(assoc) && assoc == funcAssoc;
         });
         if (it != block.getList().end()) {
-            blockList.get().erase(it);
+            eraseLogged(blockList, it, undoLogOf(block));
         }
     }
 
@@ -244,26 +481,60 @@ namespace wseml {
         if (not isBlock(block)) {
             throw std::runtime_error("removeKeyValueAssociationFromBlock: block is not a Block");
         }
+        ModificationWindow window;
         List& blockList = block.getList();
+        KeyFilter* filter = currentCache(blockList.getKeyFilter(), window);
+        TriggerIndex* index = currentTriggerIndex(block.getContainingList(), window);
         auto it = ranges::find_if(blockList.begin(), blockList.end(), [&](const Pair& blockPair) {
             const WSEML& assoc = blockPair.getData();
             return isKeyValueAssociation(assoc) && getKeyFromAssociation(assoc) == key;
         });
 
         if (it != block.getList().end()) {
-            blockList.get().erase(it);
+            eraseLogged(blockList, it, undoLogOf(block));
+            /* the filter keeps the hash of the removed key, which only costs a false positive */
+            followChange(filter, window, [] { return true; });
+            followChange(index, window, [] { return true; });
             return true;
         }
         return false;
     }
 
+    void enableKeyFilter(WSEML& block, std::size_t expectedKeys) {
+        if (not isBlock(block)) {
+            throw std::runtime_error("enableKeyFilter: block is not a Block");
+        }
+        block.getList().setKeyFilter(std::make_unique<KeyFilter>(expectedKeys));
+    }
+
+    void disableKeyFilter(WSEML& block) {
+        if (not isBlock(block)) {
+            throw std::runtime_error("disableKeyFilter: block is not a Block");
+        }
+        block.getList().setKeyFilter(nullptr);
+    }
+
+    bool hasKeyFilter(const WSEML& block) {
+        if (not isBlock(block)) {
+            throw std::runtime_error("hasKeyFilter: block is not a Block");
+        }
+        return block.getList().getKeyFilter() != nullptr;
+    }
+
+    KeyFilterStats getKeyFilterStats(const WSEML& block) {
+        if (not isBlock(block)) {
+            throw std::runtime_error("getKeyFilterStats: block is not a Block");
+        }
+        const KeyFilter* filter = block.getList().getKeyFilter();
+        return filter ? filter->getStats() : KeyFilterStats{};
+    }
+
     void addFunctionalAssociationToAA(WSEML& aa, const WSEML& funcAssoc) {
         if (not isAssociativeArray(aa)) {
             throw std::runtime_error("addFunctionalAssociationToAA: Provided 'aa' is not an Associative Array");
         }
-        if (aa.getInnerList().empty()) {
-            WSEML newBlock = createBlock();
-            aa.append(std::move(newBlock));
+        if (std::as_const(aa).getInnerList().empty()) {
+            appendLogged(aa, createBlock(), aa.getList().getUndoLog());
         }
         WSEML& lastBlockWSEML = aa.getList().back();
         addFunctionalAssociationToBlock(lastBlockWSEML, funcAssoc);
@@ -273,9 +544,11 @@ namespace wseml {
         if (not isAssociativeArray(aa)) {
             throw std::runtime_error("addKeyValueAssociationToAA: Provided 'aa' is not an Associative Array");
         }
-        if (aa.getInnerList().empty()) {
-            WSEML newBlock = createBlock();
-            aa.append(std::move(newBlock));
+        if (std::as_const(aa).getInnerList().empty()) {
+            ModificationWindow window;
+            TriggerIndex* index = currentTriggerIndex(&aa, window);
+            appendLogged(aa, createBlock(), aa.getList().getUndoLog());
+            followChange(index, window, [&] { return watchTree(std::as_const(aa).getInnerList().back().getData()); });
         }
 
         WSEML& lastBlockWSEML = aa.getList().back();
@@ -284,14 +557,14 @@ namespace wseml {
 
     /* Access */
 
-    WSEML getKeyFromAssociation(WSEML kvAssociation) {
+    const WSEML& getKeyFromAssociation(const WSEML& kvAssociation) {
         if (not isKeyValueAssociation(kvAssociation)) {
             throw std::runtime_error("getKeyFromAssociation: kvAssociation is not a valid key-value association");
         }
         return kvAssociation.getInnerList().front().getKey();
     }
 
-    WSEML getValueFromAssociation(WSEML kvAssociation) {
+    const WSEML& getValueFromAssociation(const WSEML& kvAssociation) {
         if (not isKeyValueAssociation(kvAssociation)) {
             throw std::runtime_error("getValueFromAssociation: kvAssociation is not a valid key-value association");
         }
@@ -328,25 +601,320 @@ namespace wseml {
         return false;
     }
 
+    namespace {
+        /* collects the key hashes of a block; false if the block is not fully watched */
+        bool collectKeyHashes(const List& blockList, std::vector<std::size_t>& keyHashes) {
+            if (not blockList.watch()) {
+                return false;
+            }
+            for (const Pair& association : blockList) {
+                const WSEML& assoc = association.getData();
+                if (not watchForKeyFilter(assoc)) {
+                    return false;
+                }
+                if (isKeyValueAssociation(assoc)) {
+                    keyHashes.push_back(std::hash<WSEML>{}(getKeyFromAssociation(assoc)));
+                }
+            }
+            return true;
+        }
+
+        /* returns the key filter of a block, rebuilt if a watched object changed since it was synchronized, or nullptr
+           if the block has no usable filter */
+        const KeyFilter* usableKeyFilter(const List& blockList) {
+            KeyFilter* filter = blockList.getKeyFilter();
+            if (filter == nullptr) {
+                return nullptr;
+            }
+            /* read before collecting, so that the changes made meanwhile outdate the rebuilt filter */
+            std::uint64_t modificationCount = getModificationCount();
+            if (not filter->isCurrent(modificationCount)) {
+                std::vector<std::size_t> keyHashes;
+                bool usable = collectKeyHashes(blockList, keyHashes);
+                filter->rebuild(keyHashes, modificationCount, usable, blockList.isFrozen());
+            }
+            return filter->isUsable() ? filter : nullptr;
+        }
+    } // namespace
+
+    const WSEML* findValuePtrInAA(const WSEML& aa, const WSEML& key) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("findValuePtrInAA: aa is not an Associative Array");
+        }
+        /* keys with nested AAs compare structurally, so their hashes cannot rule them out */
+        bool filterable = not containsAssociativeStructure(key);
+        std::size_t keyHash = 0;
+        bool hashed = false;
+        for (auto&& block : aa.getInnerList() | views::reverse) {
+            const List& blockList = block.getData().getList();
+            const KeyFilter* filter = filterable ? usableKeyFilter(blockList) : nullptr;
+            if (filter != nullptr) {
+                if (not hashed) {
+                    keyHash = std::hash<WSEML>{}(key);
+                    hashed = true;
+                }
+                bool negative = not filter->mayContain(keyHash);
+                filter->recordQuery(negative);
+                if (negative) {
+                    continue;
+                }
+            }
+            for (auto&& association : blockList) {
+                if (isKeyValueAssociation(association.getData()) and getKeyFromAssociation(association.getData()) == key) {
+                    return &getValueFromAssociation(association.getData());
+                }
+            }
+            if (filter != nullptr) {
+                filter->recordFalsePositive();
+            }
+        }
+        return nullptr;
+    }
+
     WSEML findValueInAA(const WSEML& aa, const WSEML& key) {
         if (not isAssociativeArray(aa)) {
             throw std::runtime_error("findValueInAA: aa is not an Associative Array");
         }
+        if (const WSEML* value = findValuePtrInAA(aa, key)) {
+            return *value;
+        }
+        if (const WSEML* funcAssoc = findFunctionalAssociationInAA(aa, key.getSemanticType())) {
+            return callFunctionalAssociation(*funcAssoc, key);
+        }
+        return NULLOBJ;
+    }
+
+    namespace {
+        /* the first functional association met in lookup order wins for each trigger type. Returns false if the AA is
+           not fully watched */
+        bool collectTriggers(const List& aaList, TriggerIndex::Entries& entries) {
+            if (not aaList.watch()) {
+                return false;
+            }
+            std::size_t depth = 0;
+            for (auto&& block : aaList | views::reverse) {
+                const Object* blockObj = block.getData().getRawObject();
+                if (blockObj == nullptr or not blockObj->watch()) {
+                    return false;
+                }
+                for (auto&& association : block.getData().getInnerList()) {
+                    const WSEML& assoc = association.getData();
+                    if (not watchForTriggerIndex(assoc)) {
+                        return false;
+                    }
+                    if (isFunctionalAssociation(assoc)) {
+                        entries.try_emplace(getFuncAssocTriggerType(assoc), TriggerIndex::Entry{depth, &assoc});
+                    }
+                }
+                depth++;
+            }
+            return true;
+        }
+
+        /* returns the trigger index of an AA, rebuilt if a watched object changed since it was synchronized, or
+           nullptr if the AA has no usable index */
+        const TriggerIndex* usableTriggerIndex(const List& aaList) {
+            TriggerIndex* index = aaList.getTriggerIndex();
+            if (index == nullptr) {
+                return nullptr;
+            }
+            /* read before collecting, so that the changes made meanwhile outdate the rebuilt index */
+            std::uint64_t modificationCount = getModificationCount();
+            if (not index->isCurrent(modificationCount)) {
+                TriggerIndex::Entries entries;
+                bool usable = collectTriggers(aaList, entries);
+                index->rebuild(std::move(entries), modificationCount, usable, aaList.isFrozen());
+            }
+            return index->isUsable() ? index : nullptr;
+        }
+    } // namespace
+
+    const WSEML* findFunctionalAssociationInAA(const WSEML& aa, const WSEML& triggerType) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("findFunctionalAssociationInAA: aa is not an Associative Array");
+        }
+        if (const TriggerIndex* index = usableTriggerIndex(aa.getList())) {
+            const TriggerIndex::Entry* entry = index->find(triggerType);
+            return entry != nullptr ? entry->funcAssoc : nullptr;
+        }
         for (auto&& block : aa.getInnerList() | views::reverse) {
-            for (auto&& association : (block.getData().getList())) {
-                if (isKeyValueAssociation(association.getData()) and getKeyFromAssociation(association.getData()) == key) {
-                    return getValueFromAssociation(association.getData());
+            for (auto&& association : block.getData().getInnerList()) {
+                const WSEML& assoc = association.getData();
+                if (isFunctionalAssociation(assoc) and getFuncAssocTriggerType(assoc) == triggerType) {
+                    return &assoc;
                 }
             }
         }
+        return nullptr;
+    }
+
+    void enableTriggerIndex(WSEML& aa) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("enableTriggerIndex: aa is not an Associative Array");
+        }
+        aa.getList().setTriggerIndex(std::make_unique<TriggerIndex>());
+    }
+
+    void disableTriggerIndex(WSEML& aa) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("disableTriggerIndex: aa is not an Associative Array");
+        }
+        aa.getList().setTriggerIndex(nullptr);
+    }
+
+    bool hasTriggerIndex(const WSEML& aa) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("hasTriggerIndex: aa is not an Associative Array");
+        }
+        return aa.getList().getTriggerIndex() != nullptr;
+    }
+
+    void syncLookupCaches(const WSEML& aa) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("syncLookupCaches: aa is not an Associative Array");
+        }
+        const List& aaList = aa.getList();
+        usableTriggerIndex(aaList);
+        for (auto&& block : aaList) {
+            usableKeyFilter(block.getData().getList());
+        }
+    }
+
+    std::vector<std::pair<const WSEML*, const WSEML*>> getEffectiveAssociations(const WSEML& aa) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("getEffectiveAssociations: aa is not an Associative Array");
+        }
+        std::vector<std::pair<const WSEML*, const WSEML*>> result;
+        std::unordered_set<const WSEML*, WSEMLPtrHash, WSEMLPtrEqual> seenKeys;
         for (auto&& block : aa.getInnerList() | views::reverse) {
-            for (auto&& association : (block.getData().getList())) {
-                if (isFunctionalAssociation(association.getData()) and getFuncAssocTriggerType(association.getData()) == key.getSemanticType()) {
-                    return callFunction(getFuncAssocFunction(association.getData()), key);
+            for (auto&& association : block.getData().getInnerList()) {
+                const WSEML& assoc = association.getData();
+                if (not isKeyValueAssociation(assoc)) {
+                    continue;
+                }
+                const Pair& kvPair = assoc.getInnerList().front();
+                if (seenKeys.insert(&kvPair.getKey()).second) {
+                    result.emplace_back(&kvPair.getKey(), &kvPair.getData());
                 }
             }
         }
-        return NULLOBJ;
+        return result;
+    }
+
+    namespace {
+        /* maps each distinct key of a batch to the positions it occupies in the batch */
+        using PendingKeys = std::unordered_map<const WSEML*, std::vector<size_t>, WSEMLPtrHash, WSEMLPtrEqual>;
+
+        PendingKeys collectPendingKeys(std::span<const WSEML> keys) {
+            PendingKeys pending;
+            pending.reserve(keys.size());
+            for (size_t i = 0; i < keys.size(); i++) {
+                pending[&keys[i]].push_back(i);
+            }
+            return pending;
+        }
+
+        /* resolves key-value associations, removing resolved keys from pending */
+        template <typename OnFound>
+        void resolveKeyValueAssociations(const WSEML& aa, PendingKeys& pending, OnFound onFound) {
+            for (auto&& block : aa.getInnerList() | views::reverse) {
+                for (auto&& association : block.getData().getInnerList()) {
+                    if (pending.empty()) {
+                        return;
+                    }
+                    const WSEML& assoc = association.getData();
+                    if (not isKeyValueAssociation(assoc)) {
+                        continue;
+                    }
+                    const Pair& kvPair = assoc.getInnerList().front();
+                    auto it = pending.find(&kvPair.getKey());
+                    if (it != pending.end()) {
+                        onFound(it->second, kvPair.getData());
+                        pending.erase(it);
+                    }
+                }
+            }
+        }
+
+        void findValuesInAAChunk(const WSEML& aa, std::span<const WSEML> keys, std::span<WSEML> out) {
+            PendingKeys pending = collectPendingKeys(keys);
+            resolveKeyValueAssociations(aa, pending, [&](const std::vector<size_t>& indices, const WSEML& value) {
+                for (size_t index : indices) {
+                    out[index] = value;
+                }
+            });
+            if (pending.empty()) {
+                return;
+            }
+
+            for (auto&& [key, indices] : pending) {
+                const WSEML* funcAssoc = findFunctionalAssociationInAA(aa, key->getSemanticType());
+                WSEML value = funcAssoc != nullptr ? callFunctionalAssociation(*funcAssoc, *key) : NULLOBJ;
+                for (size_t index : indices) {
+                    out[index] = value;
+                }
+            }
+        }
+    } // namespace
+
+    void findValuesInAA(const WSEML& aa, std::span<const WSEML> keys, std::span<WSEML> out, std::size_t threads) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("findValuesInAA: aa is not an Associative Array");
+        }
+        if (out.size() < keys.size()) {
+            throw std::runtime_error("findValuesInAA: out is smaller than keys");
+        }
+        threads = std::max<std::size_t>(1, std::min(threads, keys.size()));
+        if (threads == 1) {
+            findValuesInAAChunk(aa, keys, out);
+            return;
+        }
+
+        size_t chunkSize = (keys.size() + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> errors(threads);
+        for (size_t t = 0; t < threads; t++) {
+            size_t begin = t * chunkSize;
+            size_t count = std::min(chunkSize, keys.size() - std::min(begin, keys.size()));
+            if (count == 0) {
+                break;
+            }
+            workers.emplace_back([&, t, begin, count]() {
+                try {
+                    findValuesInAAChunk(aa, keys.subspan(begin, count), out.subspan(begin, count));
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto&& worker : workers) {
+            worker.join();
+        }
+        for (auto&& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    std::vector<WSEML> findValuesInAA(const WSEML& aa, std::span<const WSEML> keys, std::size_t threads) {
+        std::vector<WSEML> result(keys.size());
+        findValuesInAA(aa, keys, result, threads);
+        return result;
+    }
+
+    std::vector<const WSEML*> findValueRefsInAA(const WSEML& aa, std::span<const WSEML> keys) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("findValueRefsInAA: aa is not an Associative Array");
+        }
+        std::vector<const WSEML*> result(keys.size(), nullptr);
+        PendingKeys pending = collectPendingKeys(keys);
+        resolveKeyValueAssociations(aa, pending, [&](const std::vector<size_t>& indices, const WSEML& value) {
+            for (size_t index : indices) {
+                result[index] = &value;
+            }
+        });
+        return result;
     }
 
     WSEML merge(const WSEML& aa) {
@@ -355,29 +923,362 @@ namespace wseml {
         }
 
         WSEML mergedAA = createAssociativeArray();
-
-        std::unordered_set<size_t> seenKeysHashes;
+        BlockBuilder mergedBlock;
+        std::unordered_set<const WSEML*, WSEMLPtrHash, WSEMLPtrEqual> seenKeys;
 
         for (auto&& block : aa.getInnerList() | views::reverse) {
-            for (auto&& association : (block.getData().getList())) {
-                auto assoc = association.getData();
+            for (auto&& association : block.getData().getInnerList()) {
+                const WSEML& assoc = association.getData();
                 if (isKeyValueAssociation(assoc)) {
-                    WSEML key = getKeyFromAssociation(assoc);
-                    size_t keyHash = std::hash<WSEML>{}(key);
-                    if (seenKeysHashes.contains(keyHash)) {
-                        continue;
+                    const WSEML& key = getKeyFromAssociation(assoc);
+                    if (seenKeys.insert(&key).second) {
+                        mergedBlock.add(key, getValueFromAssociation(assoc));
                     }
-                    addKeyValueAssociationToAA(mergedAA, key, getValueFromAssociation(assoc));
-                    seenKeysHashes.insert(keyHash);
+                } else if (isFunctionalAssociation(assoc)) {
+                    mergedBlock.addFunctional(assoc);
                 }
-                if (isFunctionalAssociation(assoc)) {
-                    addFunctionalAssociationToAA(mergedAA, assoc);
+            }
+        }
+        if (mergedBlock.size() != 0) {
+            mergedAA.append(mergedBlock.finish());
+        }
+        return mergedAA;
+    }
+
+    namespace {
+        /* the associations of a merge, in lookup order, with the hashes of their keys (0 for functional ones) */
+        struct MergeInput {
+            std::vector<const WSEML*> associations;
+            std::vector<std::size_t> keyHashes;
+        };
+
+        constexpr std::size_t MERGE_GRAIN = 1024;
+
+        struct MergeKeyHash {
+            const MergeInput* input;
+            std::size_t operator()(std::size_t index) const {
+                return input->keyHashes[index];
+            }
+        };
+
+        struct MergeKeyEqual {
+            const MergeInput* input;
+            bool operator()(std::size_t lhs, std::size_t rhs) const {
+                return getKeyFromAssociation(*input->associations[lhs]) == getKeyFromAssociation(*input->associations[rhs]);
+            }
+        };
+    } // namespace
+
+    WSEML merge(const WSEML& aa, WorkStealingPool& pool) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("merge: aa is not an Associative Array");
+        }
+
+        MergeInput input;
+        std::vector<char> keyValue;
+        for (auto&& block : aa.getInnerList() | views::reverse) {
+            for (auto&& association : block.getData().getInnerList()) {
+                const WSEML& assoc = association.getData();
+                if (isKeyValueAssociation(assoc) or isFunctionalAssociation(assoc)) {
+                    input.associations.push_back(&assoc);
+                    keyValue.push_back(isKeyValueAssociation(assoc));
                 }
             }
         }
+        std::size_t count = input.associations.size();
+        WSEML mergedAA = createAssociativeArray();
+        if (count == 0) {
+            return mergedAA;
+        }
+
+        pool.run([&]() {
+            input.keyHashes.assign(count, 0);
+            pool.parallelFor(0, count, MERGE_GRAIN, [&](std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; i++) {
+                    if (keyValue[i]) {
+                        input.keyHashes[i] = std::hash<WSEML>{}(getKeyFromAssociation(*input.associations[i]));
+                    }
+                }
+            });
+
+            /* each partition keeps the lookup order, so the first occurrence of a key in it is the effective one */
+            std::vector<std::vector<std::size_t>> partitions(pool.size() * 4);
+            for (std::size_t i = 0; i < count; i++) {
+                if (keyValue[i]) {
+                    partitions[input.keyHashes[i] % partitions.size()].push_back(i);
+                }
+            }
+            std::vector<char> kept(keyValue.size());
+            for (std::size_t i = 0; i < count; i++) {
+                kept[i] = not keyValue[i];
+            }
+            pool.parallelFor(0, partitions.size(), 1, [&](std::size_t first, std::size_t last) {
+                for (std::size_t p = first; p < last; p++) {
+                    std::unordered_set<std::size_t, MergeKeyHash, MergeKeyEqual> seenKeys(partitions[p].size(), MergeKeyHash{&input},
+                                                                                         MergeKeyEqual{&input});
+                    for (std::size_t index : partitions[p]) {
+                        kept[index] = seenKeys.insert(index).second;
+                    }
+                }
+            });
+
+            std::vector<std::size_t> survivors;
+            for (std::size_t i = 0; i < count; i++) {
+                if (kept[i]) {
+                    survivors.push_back(i);
+                }
+            }
+
+            /* the pairs get the keys List::append would generate, so the result is identical to the sequential merge. Each
+               chunk is filled into a Block of its own, continuing the keys of the chunks before it */
+            mergedAA.append(createBlock());
+            WSEML& mergedBlock = mergedAA.getList().back();
+            std::size_t chunkCount = (survivors.size() + MERGE_GRAIN - 1) / MERGE_GRAIN;
+            std::vector<WSEML> chunks(chunkCount);
+            pool.parallelFor(0, chunkCount, 1, [&](std::size_t first, std::size_t last) {
+                for (std::size_t chunk = first; chunk < last; chunk++) {
+                    std::size_t begin = chunk * MERGE_GRAIN;
+                    std::size_t end = std::min(survivors.size(), begin + MERGE_GRAIN);
+                    BlockBuilder builder;
+                    builder.reserve(end - begin);
+                    for (std::size_t j = begin; j < end; j++) {
+                        const WSEML& assoc = *input.associations[survivors[j]];
+                        if (keyValue[survivors[j]]) {
+                            builder.add(getKeyFromAssociation(assoc), getValueFromAssociation(assoc));
+                        } else {
+                            builder.addFunctional(assoc);
+                        }
+                    }
+                    chunks[chunk] = createBlock();
+                    chunks[chunk].getList().setNextKeyAfter(begin);
+                    builder.fill(chunks[chunk]);
+                    for (Pair& pair : chunks[chunk].getList()) {
+                        pair.setListOwner(&mergedBlock);
+                    }
+                }
+            });
+            List& pairs = mergedBlock.getList();
+            for (WSEML& chunk : chunks) {
+                pairs.splice(pairs.end(), chunk.getList());
+            }
+            pairs.setNextKeyAfter(survivors.size());
+        });
         return mergedAA;
     }
 
+    /* Compaction */
+
+    namespace {
+        struct Shadowing {
+            std::size_t associations = 0;
+            std::size_t shadowed = 0;
+        };
+
+        /* counts the key-value associations of the blocks below last that a later block below last shadows */
+        Shadowing countShadowing(const WSEML& aa, std::size_t last) {
+            Shadowing shadowing;
+            std::unordered_set<const WSEML*, WSEMLPtrHash, WSEMLPtrEqual> seenKeys;
+            const std::list<Pair>& blocks = aa.getInnerList();
+            for (auto it = std::make_reverse_iterator(std::next(blocks.begin(), last)); it != blocks.rend(); ++it) {
+                for (const Pair& association : it->getData().getInnerList()) {
+                    const WSEML& assoc = association.getData();
+                    if (isKeyValueAssociation(assoc)) {
+                        shadowing.associations++;
+                        if (not seenKeys.insert(&getKeyFromAssociation(assoc)).second) {
+                            shadowing.shadowed++;
+                        }
+                    }
+                }
+            }
+            return shadowing;
+        }
+
+        std::size_t compactedRangeEnd(const WSEML& aa, std::size_t keepTop) {
+            std::size_t blockCount = std::as_const(aa).getInnerList().size();
+            return blockCount > keepTop ? blockCount - keepTop : 0;
+        }
+
+        void autoCompact(WSEML& aa) {
+            AutoCompaction* autoCompaction = aa.getList().getAutoCompaction();
+            std::size_t blockCount = std::as_const(aa).getInnerList().size();
+            if (autoCompaction == nullptr or blockCount < autoCompaction->nextCheck) {
+                return;
+            }
+            const CompactionPolicy& policy = autoCompaction->policy;
+            double ratio = getShadowingRatio(aa, policy.keepTop);
+            if (ratio == 0 or ratio < policy.shadowRatio) {
+                autoCompaction->nextCheck = blockCount * 2;
+                return;
+            }
+            CompactionStats stats = compactAA(aa, policy.keepTop);
+            CompactionStats& total = autoCompaction->stats;
+            total.compactions += stats.compactions;
+            total.blocksRemoved += stats.blocksRemoved;
+            total.associationsRemoved += stats.associationsRemoved;
+            total.bytesReclaimed += stats.bytesReclaimed;
+            autoCompaction->nextCheck = std::as_const(aa).getInnerList().size() + policy.minBlocks;
+        }
+    } // namespace
+
+    CompactionStats compactBlocks(WSEML& aa, std::size_t first, std::size_t last) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("compactBlocks: aa is not an Associative Array");
+        }
+        List& blocks = aa.getList();
+        if (first > last or last > std::as_const(aa).getInnerList().size()) {
+            throw std::runtime_error("compactBlocks: block range is out of bounds");
+        }
+        CompactionStats stats;
+        if (last - first < 2) {
+            return stats;
+        }
+        auto begin = std::next(blocks.begin(), first);
+        auto end = std::next(begin, last - first);
+
+        std::size_t bytesBefore = 0;
+        bool filtered = false;
+        for (auto it = begin; it != end; ++it) {
+            bytesBefore += footprint(it->getData());
+            filtered = filtered or it->getData().getList().getKeyFilter() != nullptr;
+        }
+
+        /* the first association of a key in lookup order wins; moving an association keeps its key in place. An open
+           snapshot keeps the original blocks, so the associations are copied then */
+        UndoLog* log = aa.getList().getUndoLog();
+        WSEML compacted = createBlock();
+        std::unordered_set<const WSEML*, WSEMLPtrHash, WSEMLPtrEqual> seenKeys;
+        for (auto it = std::make_reverse_iterator(end); it != std::make_reverse_iterator(begin); ++it) {
+            for (Pair& association : it->getData().getList()) {
+                WSEML& assoc = association.getData();
+                if (isKeyValueAssociation(assoc) and not seenKeys.insert(&getKeyFromAssociation(assoc)).second) {
+                    stats.associationsRemoved++;
+                    continue;
+                }
+                compacted.append(log != nullptr ? WSEML(assoc) : std::move(assoc));
+            }
+        }
+        std::size_t bytesAfter = footprint(compacted);
+        if (filtered) {
+            enableKeyFilter(compacted, seenKeys.size());
+        }
+
+        if (log != nullptr) {
+            log->recordRemoval(aa.getList(), begin, end);
+        } else {
+            blocks.erase(begin, end);
+        }
+        aa.getList().insert(end, &aa, std::move(compacted));
+        if (log != nullptr) {
+            log->recordInsertion(aa.getList(), std::prev(end));
+        }
+
+        stats.compactions = 1;
+        stats.blocksRemoved = last - first - 1;
+        stats.bytesReclaimed = bytesBefore > bytesAfter ? bytesBefore - bytesAfter : 0;
+        return stats;
+    }
+
+    CompactionStats compactAA(WSEML& aa, std::size_t keepTop) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("compactAA: aa is not an Associative Array");
+        }
+        return compactBlocks(aa, 0, compactedRangeEnd(aa, keepTop));
+    }
+
+    double getShadowingRatio(const WSEML& aa, std::size_t keepTop) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("getShadowingRatio: aa is not an Associative Array");
+        }
+        Shadowing shadowing = countShadowing(aa, compactedRangeEnd(aa, keepTop));
+        return shadowing.associations == 0 ? 0.0 : static_cast<double>(shadowing.shadowed) / static_cast<double>(shadowing.associations);
+    }
+
+    void enableAutoCompaction(WSEML& aa, CompactionPolicy policy) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("enableAutoCompaction: aa is not an Associative Array");
+        }
+        if (not(policy.shadowRatio >= 0.0 and policy.shadowRatio <= 1.0) or policy.minBlocks == 0) {
+            throw std::runtime_error("enableAutoCompaction: shadowRatio must be in [0, 1] and minBlocks positive");
+        }
+        auto autoCompaction = std::make_unique<AutoCompaction>();
+        autoCompaction->policy = policy;
+        autoCompaction->nextCheck = policy.minBlocks;
+        aa.getList().setAutoCompaction(std::move(autoCompaction));
+    }
+
+    void disableAutoCompaction(WSEML& aa) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("disableAutoCompaction: aa is not an Associative Array");
+        }
+        aa.getList().setAutoCompaction(nullptr);
+    }
+
+    bool hasAutoCompaction(const WSEML& aa) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("hasAutoCompaction: aa is not an Associative Array");
+        }
+        return aa.getList().getAutoCompaction() != nullptr;
+    }
+
+    CompactionStats getAutoCompactionStats(const WSEML& aa) {
+        if (not hasAutoCompaction(aa)) {
+            throw std::runtime_error("getAutoCompactionStats: aa has no automatic compaction");
+        }
+        return aa.getList().getAutoCompaction()->stats;
+    }
+
+    /* Snapshots */
+
+    AASnapshot takeSnapshot(WSEML& aa) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("takeSnapshot: aa is not an Associative Array");
+        }
+        List& aaList = aa.getList();
+        if (aaList.getUndoLog() == nullptr) {
+            aaList.setUndoLog(std::make_unique<UndoLog>());
+        }
+        return AASnapshot{aaList.getUndoLog()->pushMark()};
+    }
+
+    namespace {
+        UndoLog& innermostUndoLog(WSEML& aa, AASnapshot snapshot, const char* caller) {
+            if (not isAssociativeArray(aa)) {
+                throw std::runtime_error(std::string(caller) + ": aa is not an Associative Array");
+            }
+            UndoLog* log = aa.getList().getUndoLog();
+            if (log == nullptr or snapshot.depth + 1 != log->getDepth()) {
+                throw std::runtime_error(std::string(caller) + ": snapshot is not the innermost open snapshot of aa");
+            }
+            return *log;
+        }
+
+        void closeSnapshot(WSEML& aa, UndoLog& log) {
+            if (log.getDepth() == 0) {
+                aa.getList().setUndoLog(nullptr);
+            }
+        }
+    } // namespace
+
+    void commitSnapshot(WSEML& aa, AASnapshot snapshot) {
+        UndoLog& log = innermostUndoLog(aa, snapshot, "commitSnapshot");
+        log.popMark();
+        closeSnapshot(aa, log);
+    }
+
+    void rollbackToSnapshot(WSEML& aa, AASnapshot snapshot) {
+        UndoLog& log = innermostUndoLog(aa, snapshot, "rollbackToSnapshot");
+        log.rollback(aa);
+        closeSnapshot(aa, log);
+    }
+
+    std::size_t getOpenSnapshotCount(const WSEML& aa) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("getOpenSnapshotCount: aa is not an Associative Array");
+        }
+        const UndoLog* log = aa.getList().getUndoLog();
+        return log != nullptr ? log->getDepth() : 0;
+    }
+
     bool compareAssociativeArrays(const WSEML& aa1, const WSEML& aa2) {
         auto merged1 = merge(aa1);
         auto merged2 = merge(aa2);
@@ -399,22 +1300,22 @@ namespace wseml {
         }
 
         // Create data views for both blocks
-        auto dataView1 = innerList1 | std::ranges::views::transform([](const auto& pair) { return pair.getData(); });
-        auto dataView2 = innerList2 | std::ranges::views::transform([](const auto& pair) { return pair.getData(); });
+        auto dataView1 = innerList1 | std::ranges::views::transform([](const auto& pair) { return &pair.getData(); });
+        auto dataView2 = innerList2 | std::ranges::views::transform([](const auto& pair) { return &pair.getData(); });
 
         // Use counting approach with running non-zero counter
-        std::unordered_map<decltype(dataView1.front()), int> counter;
+        std::unordered_map<const WSEML*, int, WSEMLPtrHash, WSEMLPtrEqual> counter;
         int nonZeroEntries = 0;
 
         // Count elements in the first block
-        for (const auto& data : dataView1) {
+        for (const WSEML* data : dataView1) {
             if (++counter[data] == 1) {
                 nonZeroEntries++;
             }
         }
 
         // Decrement counts for elements in the second block
-        for (const auto& data : dataView2) {
+        for (const WSEML* data : dataView2) {
             auto it = counter.find(data);
             if (it == counter.end() || it->second == 0) {
                 return false;
@@ -431,12 +1332,12 @@ namespace wseml {
 
     /* Forward declaration for unification */
 
-    WSEML unifyValues(const WSEML& value1, const WSEML& value2, std::unordered_map<WSEML, WSEML>& placeholderValues);
-    WSEML unifyAAHelper(const WSEML& aa1, const WSEML& aa2, std::unordered_map<WSEML, WSEML>& placeholderValues);
-    WSEML unifyBlocks(const WSEML& block1, const WSEML& block2, std::unordered_map<WSEML, WSEML>& placeholderValues);
-    std::optional<Pair> unifyPairs(const Pair& pair1, const Pair& pair2, std::unordered_map<WSEML, WSEML>& placeholderValues);
+    WSEML unifyValues(const WSEML& value1, const WSEML& value2, BindingStore& bindings);
+    WSEML unifyAAHelper(const WSEML& aa1, const WSEML& aa2, BindingStore& bindings);
+    WSEML unifyBlocks(const WSEML& block1, const WSEML& block2, BindingStore& bindings);
+    std::optional<Pair> unifyPairs(const Pair& pair1, const Pair& pair2, BindingStore& bindings);
 
-    WSEML unifyValues(const WSEML& value1, const WSEML& value2, std::unordered_map<WSEML, WSEML>& placeholderValues) {
+    WSEML unifyValues(const WSEML& value1, const WSEML& value2, BindingStore& bindings) {
         if (value1 == value2) {
             return value1;
         }
@@ -454,31 +1355,33 @@ namespace wseml {
         if (isPlaceholder(value1)) {
             if (value1 == ANPLACEHOLDER) {
                 return value2;
-            } else if (placeholderValues.contains(value1)) {
-                return unifyValues(placeholderValues[value1], value2, placeholderValues);
-            } else {
-                placeholderValues[value1] = value2;
-                return value2;
             }
+            BindingStore::PlaceholderId id = bindings.intern(value1);
+            if (const WSEML* bound = bindings.getValue(id)) {
+                return unifyValues(*bound, value2, bindings);
+            }
+            bindings.bind(id, value2);
+            return value2;
         }
 
         if (isPlaceholder(value2)) {
             if (value2 == ANPLACEHOLDER) {
                 return value1;
-            } else if (placeholderValues.contains(value2)) {
-                return unifyValues(value1, placeholderValues[value2], placeholderValues);
-            } else {
-                placeholderValues[value2] = value1;
-                return value1;
             }
+            BindingStore::PlaceholderId id = bindings.intern(value2);
+            if (const WSEML* bound = bindings.getValue(id)) {
+                return unifyValues(value1, *bound, bindings);
+            }
+            bindings.bind(id, value1);
+            return value1;
         }
 
         if (isAssociativeArray(value1) and isAssociativeArray(value2)) {
-            return unifyAAHelper(value1, value2, placeholderValues);
+            return unifyAAHelper(value1, value2, bindings);
         }
 
         if (isBlock(value1) and isBlock(value2)) {
-            return unifyBlocks(value1, value2, placeholderValues);
+            return unifyBlocks(value1, value2, bindings);
         }
 
         if (value1.getSemanticType() != value2.getSemanticType()) {
@@ -487,7 +1390,7 @@ namespace wseml {
 
         WSEML type = value1.getSemanticType();
 
-        if (value1.getRawObject()->structureTypeInfo() == StructureType::List and value2.getRawObject()->structureTypeInfo() == StructureType::List) {
+        if (value1.structureTypeInfo() == StructureType::List and value2.structureTypeInfo() == StructureType::List) {
             const std::list<Pair>& list1 = value1.getInnerList();
             const std::list<Pair>& list2 = value2.getInnerList();
             if (list1.size() != list2.size()) {
@@ -498,7 +1401,7 @@ namespace wseml {
             auto it1 = list1.begin();
             auto it2 = list2.begin();
             while (it1 != list1.end() and it2 != list2.end()) {
-                auto unifiedPair = unifyPairs(*it1, *it2, placeholderValues);
+                auto unifiedPair = unifyPairs(*it1, *it2, bindings);
                 it1++;
                 it2++;
                 if (!unifiedPair.has_value()) {
@@ -513,7 +1416,7 @@ namespace wseml {
         return NULLOBJ;
     }
 
-    std::optional<Pair> unifyPairs(const Pair& pair1, const Pair& pair2, std::unordered_map<WSEML, WSEML>& placeholderValues) {
+    std::optional<Pair> unifyPairs(const Pair& pair1, const Pair& pair2, BindingStore& bindings) {
         const WSEML& key1 = pair1.getKey();
         const WSEML& key2 = pair2.getKey();
         const WSEML& data1 = pair1.getData();
@@ -525,7 +1428,7 @@ namespace wseml {
 
         WSEML unifiedKey = NULLOBJ;
         if (key1 != NULLOBJ or key2 != NULLOBJ) {
-            unifiedKey = unifyValues(key1, key2, placeholderValues);
+            unifiedKey = unifyValues(key1, key2, bindings);
             if (unifiedKey == NULLOBJ) {
                 return std::nullopt;
             }
@@ -533,7 +1436,7 @@ namespace wseml {
 
         WSEML unifiedData = NULLOBJ;
         if (data1 != NULLOBJ or data2 != NULLOBJ) {
-            unifiedData = unifyValues(data1, data2, placeholderValues);
+            unifiedData = unifyValues(data1, data2, bindings);
             if (unifiedData == NULLOBJ) {
                 return std::nullopt;
             }
@@ -541,7 +1444,7 @@ namespace wseml {
 
         WSEML unifiedKeyRole = NULLOBJ;
         if (keyRole1 != NULLOBJ or keyRole2 != NULLOBJ) {
-            unifiedKeyRole = unifyValues(keyRole1, keyRole2, placeholderValues);
+            unifiedKeyRole = unifyValues(keyRole1, keyRole2, bindings);
             if (unifiedKeyRole == NULLOBJ) {
                 return std::nullopt;
             }
@@ -549,7 +1452,7 @@ namespace wseml {
 
         WSEML unifiedDataRole = NULLOBJ;
         if (dataRole1 != NULLOBJ or dataRole2 != NULLOBJ) {
-            unifiedDataRole = unifyValues(dataRole1, dataRole2, placeholderValues);
+            unifiedDataRole = unifyValues(dataRole1, dataRole2, bindings);
             if (unifiedDataRole == NULLOBJ) {
                 return std::nullopt;
             }
@@ -558,7 +1461,16 @@ namespace wseml {
         return Pair(nullptr, unifiedKey, unifiedData, unifiedKeyRole, unifiedDataRole);
     }
 
-    WSEML unifyBlocks(const WSEML& block1, const WSEML& block2, std::unordered_map<WSEML, WSEML>& placeholderValues) {
+    /* a top-level placeholder of a block must be bound to exactly the value it is matched with */
+    bool bindBlockPlaceholder(const WSEML& placeholder, const WSEML& value, BindingStore& bindings) {
+        BindingStore::PlaceholderId id = bindings.intern(placeholder);
+        if (const WSEML* bound = bindings.getValue(id)) {
+            return *bound == value;
+        }
+        return bindings.bind(id, value);
+    }
+
+    WSEML unifyBlocks(const WSEML& block1, const WSEML& block2, BindingStore& bindings) {
         std::unordered_map<WSEML, WSEML> map1;
         std::unordered_map<WSEML, WSEML> map2;
         /* at most one of funcAssoc1 and funcAssoc2 will be populated according to current requirements */
@@ -567,7 +1479,7 @@ namespace wseml {
         std::unordered_set<WSEML> keysUnion;
 
         for (auto&& assoc : block1.getList()) {
-            WSEML assocObject = assoc.getData();
+            const WSEML& assocObject = assoc.getData();
             if (isKeyValueAssociation(assocObject)) {
                 WSEML key = getKeyFromAssociation(assocObject);
                 WSEML value = getValueFromAssociation(assocObject);
@@ -575,25 +1487,20 @@ namespace wseml {
                 keysUnion.insert(key);
             }
             if (isFunctionalAssociation(assocObject)) {
-                WSEML triggerType = getFuncAssocTriggerType(assocObject);
-                WSEML function = getFuncAssocFunction(assocObject);
-                funcAssoc1[triggerType] = function;
+                funcAssoc1[getFuncAssocTriggerType(assocObject)] = assocObject;
             }
         }
 
         for (auto&& assoc : block2.getList()) {
-            WSEML assocObject = assoc.getData();
+            const WSEML& assocObject = assoc.getData();
             if (isKeyValueAssociation(assocObject)) {
-                WSEML assocObject = assoc.getData();
                 WSEML key = getKeyFromAssociation(assocObject);
                 WSEML value = getValueFromAssociation(assocObject);
                 map2[key] = value;
                 keysUnion.insert(key);
             }
             if (isFunctionalAssociation(assocObject)) {
-                WSEML triggerType = getFuncAssocTriggerType(assocObject);
-                WSEML function = getFuncAssocFunction(assocObject);
-                funcAssoc2[triggerType] = function;
+                funcAssoc2[getFuncAssocTriggerType(assocObject)] = assocObject;
             }
         }
 
@@ -611,33 +1518,17 @@ namespace wseml {
                         return NULLOBJ;
                     }
                 } else if (isPlaceholder(value1)) {
-                    if (value1 == ANPLACEHOLDER) {
-                        addKeyValueAssociationToBlock(unifiedBlock, key, value2);
-                    } else if (placeholderValues.contains(value1)) {
-                        if (placeholderValues[value1] == value2) {
-                            addKeyValueAssociationToBlock(unifiedBlock, key, value2);
-                        } else {
-                            return NULLOBJ;
-                        }
-                    } else {
-                        placeholderValues[value1] = value2;
-                        addKeyValueAssociationToBlock(unifiedBlock, key, value2);
+                    if (value1 != ANPLACEHOLDER and not bindBlockPlaceholder(value1, value2, bindings)) {
+                        return NULLOBJ;
                     }
+                    addKeyValueAssociationToBlock(unifiedBlock, key, value2);
                 } else if (isPlaceholder(value2)) {
-                    if (value2 == ANPLACEHOLDER) {
-                        addKeyValueAssociationToBlock(unifiedBlock, key, value1);
-                    } else if (placeholderValues.contains(value2)) {
-                        if (placeholderValues[value2] == value1) {
-                            addKeyValueAssociationToBlock(unifiedBlock, key, value1);
-                        } else {
-                            return NULLOBJ;
-                        }
-                    } else {
-                        placeholderValues[value2] = value1;
-                        addKeyValueAssociationToBlock(unifiedBlock, key, value1);
+                    if (value2 != ANPLACEHOLDER and not bindBlockPlaceholder(value2, value1, bindings)) {
+                        return NULLOBJ;
                     }
+                    addKeyValueAssociationToBlock(unifiedBlock, key, value1);
                 } else {
-                    WSEML unifiedValue = unifyValues(value1, value2, placeholderValues);
+                    WSEML unifiedValue = unifyValues(value1, value2, bindings);
                     if (unifiedValue == NULLOBJ) {
                         return NULLOBJ;
                     }
@@ -647,8 +1538,8 @@ namespace wseml {
                 const WSEML& value1 = map1[key];
                 const WSEML& keyType = key.getSemanticType();
                 if (funcAssoc2.contains(keyType)) {
-                    WSEML value2 = callFunction(funcAssoc2[keyType], key);
-                    WSEML unificationResult = unifyValues(value1, value2, placeholderValues);
+                    WSEML value2 = callFunctionalAssociation(funcAssoc2[keyType], key);
+                    WSEML unificationResult = unifyValues(value1, value2, bindings);
                     if (unificationResult == NULLOBJ) {
                         return NULLOBJ;
                     }
@@ -660,8 +1551,8 @@ namespace wseml {
                 const WSEML& value2 = map2[key];
                 const WSEML& keyType = key.getSemanticType();
                 if (funcAssoc1.contains(keyType)) {
-                    WSEML value1 = callFunction(funcAssoc1[keyType], key);
-                    WSEML unificationResult = unifyValues(value1, value2, placeholderValues);
+                    WSEML value1 = callFunctionalAssociation(funcAssoc1[keyType], key);
+                    WSEML unificationResult = unifyValues(value1, value2, bindings);
                     if (unificationResult == NULLOBJ) {
                         return NULLOBJ;
                     }
@@ -674,23 +1565,23 @@ namespace wseml {
         }
 
         /* at most one of loop will be executed */
-        for (auto&& [type, function] : funcAssoc1) {
-            addFunctionalAssociationToBlock(unifiedBlock, createFunctionalAssociation(type, function));
+        for (auto&& [type, funcAssoc] : funcAssoc1) {
+            addFunctionalAssociationToBlock(unifiedBlock, funcAssoc);
         }
-        for (auto&& [type, function] : funcAssoc2) {
-            addFunctionalAssociationToBlock(unifiedBlock, createFunctionalAssociation(type, function));
+        for (auto&& [type, funcAssoc] : funcAssoc2) {
+            addFunctionalAssociationToBlock(unifiedBlock, funcAssoc);
         }
 
         return unifiedBlock;
     }
 
-    WSEML unifyAAHelper(const WSEML& aa1, const WSEML& aa2, std::unordered_map<WSEML, WSEML>& placeholderValues) {
+    WSEML unifyAAHelper(const WSEML& aa1, const WSEML& aa2, BindingStore& bindings) {
         WSEML merged1 = merge(aa1);
         WSEML merged2 = merge(aa2);
         WSEML block1 = merged1.getList().front();
         WSEML block2 = merged2.getList().front();
 
-        WSEML unifiedBlock = unifyBlocks(block1, block2, placeholderValues);
+        WSEML unifiedBlock = unifyBlocks(block1, block2, bindings);
 
         if (unifiedBlock == NULLOBJ) {
             return NULLOBJ;
@@ -703,20 +1594,14 @@ namespace wseml {
     }
 
     std::pair<WSEML, WSEML> unify(const WSEML& aa1, const WSEML& aa2) {
-        std::unordered_map<WSEML, WSEML> placeholderValues;
-        WSEML result = unifyAAHelper(aa1, aa2, placeholderValues);
+        BindingStore bindings;
+        WSEML result = unifyAAHelper(aa1, aa2, bindings);
 
         if (result == NULLOBJ) {
             return {NULLOBJ, NULLOBJ};
         };
 
-        WSEML resultPlaceholders = createAssociativeArray();
-        WSEML block = createBlock();
-        appendBlock(resultPlaceholders, block);
-        for (const auto& [key, value] : placeholderValues) {
-            addKeyValueAssociationToAA(resultPlaceholders, key, value);
-        }
-        return {result, resultPlaceholders};
+        return {result, bindings.toAA()};
     }
 
     WSEML substitutePlaceholdersRecursive(const std::unordered_map<WSEML, WSEML>& bindings, const WSEML& currentTemplateObj);
@@ -741,8 +1626,8 @@ namespace wseml {
         for (const auto& pair : getAssociationsFromBlock(block)) {
             const WSEML& assoc = pair.getData();
             if (isKeyValueAssociation(assoc)) {
-                WSEML key = getKeyFromAssociation(assoc);
-                WSEML value = getValueFromAssociation(assoc);
+                const WSEML& key = getKeyFromAssociation(assoc);
+                const WSEML& value = getValueFromAssociation(assoc);
                 if (isPlaceholder(key)) {
                     bindingsMap[key] = value;
                 } else {
@@ -756,54 +1641,86 @@ namespace wseml {
         return bindingsMap;
     }
 
-    WSEML substitutePlaceholdersRecursive(const std::unordered_map<WSEML, WSEML>& bindingsMap, const WSEML& currentTemplateObj) {
-        if (!currentTemplateObj.hasObject()) {
-            return NULLOBJ;
-        }
-
-        if (isPlaceholder(currentTemplateObj)) {
-            auto it = bindingsMap.find(currentTemplateObj);
-            if (it != bindingsMap.end()) {
-                return substitutePlaceholdersRecursive(bindingsMap, it->second);
-            } else {
-                return WSEML(currentTemplateObj);
+    namespace {
+        /* a non-empty List of the template whose pairs are being substituted */
+        struct SubstitutionFrame {
+            SubstitutionFrame(const std::list<Pair>& source, const WSEML& type)
+                : next(source.begin()), end(source.end()), type(type) {
             }
-        }
-
-        StructureType structureType = currentTemplateObj.structureTypeInfo();
-        WSEML currentType = currentTemplateObj.getSemanticType(); // Preserve semantic type
-
-        if (structureType == StructureType::String) {
-            return WSEML(currentTemplateObj);
-        }
 
-        if (structureType == StructureType::List) {
-            const std::list<Pair>& originalList = currentTemplateObj.getInnerList();
-            if (originalList.empty()) {
-                return WSEML(currentTemplateObj);
+            std::list<Pair>::const_iterator next;
+            std::list<Pair>::const_iterator end;
+            WSEML type;
+            std::list<Pair> pairs;
+            /* the substituted key, data, key role and data role of the current pair */
+            std::array<WSEML, 4> members;
+            std::size_t field = 0;
+
+            const WSEML& nextMember() const {
+                switch (field) {
+                    case 0:
+                        return next->getKey();
+                    case 1:
+                        return next->getData();
+                    case 2:
+                        return next->getKeyRole();
+                    default:
+                        return next->getDataRole();
+                }
             }
 
-            std::list<Pair> substitutedPairs;
-
-            for (const Pair& originalPair : originalList) {
-                WSEML substitutedKey = substitutePlaceholdersRecursive(bindingsMap, originalPair.getKey());
-                WSEML substitutedData = substitutePlaceholdersRecursive(bindingsMap, originalPair.getData());
-                WSEML substitutedKeyRole = substitutePlaceholdersRecursive(bindingsMap, originalPair.getKeyRole());
-                WSEML substitutedDataRole = substitutePlaceholdersRecursive(bindingsMap, originalPair.getDataRole());
+            void consume(WSEML substituted) {
+                members[field] = std::move(substituted);
+                if (++field == members.size()) {
+                    pairs.emplace_back(nullptr, std::move(members[0]), std::move(members[1]), std::move(members[2]),
+                                       std::move(members[3]));
+                    field = 0;
+                    ++next;
+                }
+            }
+        };
 
-                substitutedPairs.emplace_back(
-                    nullptr,
-                    std::move(substitutedKey),
-                    std::move(substitutedData),
-                    std::move(substitutedKeyRole),
-                    std::move(substitutedDataRole)
-                );
+        /* returns the substitution of a leaf, or pushes the frame of a non-empty List and returns nothing */
+        std::optional<WSEML> startSubstitution(const std::unordered_map<WSEML, WSEML>& bindingsMap, const WSEML& templateObj,
+                                               std::vector<SubstitutionFrame>& stack) {
+            const WSEML* current = &templateObj;
+            while (current->hasObject() and isPlaceholder(*current)) {
+                auto it = bindingsMap.find(*current);
+                if (it == bindingsMap.end()) {
+                    return WSEML(*current);
+                }
+                current = &it->second;
             }
 
-            return WSEML(std::move(substitutedPairs), currentType);
+            if (not current->hasObject()) {
+                return NULLOBJ;
+            }
+            if (current->structureTypeInfo() != StructureType::List or current->getInnerList().empty()) {
+                return WSEML(*current);
+            }
+            stack.emplace_back(current->getInnerList(), current->getSemanticType());
+            return std::nullopt;
         }
+    } // namespace
 
-        return WSEML(currentTemplateObj);
+    WSEML substitutePlaceholdersRecursive(const std::unordered_map<WSEML, WSEML>& bindingsMap, const WSEML& currentTemplateObj) {
+        /* an explicit stack, so that the depth of the template is not limited by the call stack */
+        std::vector<SubstitutionFrame> stack;
+        std::optional<WSEML> result = startSubstitution(bindingsMap, currentTemplateObj, stack);
+        while (not stack.empty()) {
+            if (result) {
+                stack.back().consume(std::move(*result));
+                result.reset();
+            }
+            SubstitutionFrame& frame = stack.back();
+            if (frame.next == frame.end) {
+                result.emplace(std::move(frame.pairs), frame.type);
+                stack.pop_back();
+                continue;
+            }
+            result = startSubstitution(bindingsMap, frame.nextMember(), stack);
+        }
+        return std::move(*result);
     }
 
     WSEML substitutePlaceholders(const WSEML& bindingsAA, const WSEML& templateObj) {
@@ -0,0 +1,115 @@
+#include "../include/associativeArray.hpp"
+#include "../include/bindingStore.hpp"
+
+namespace wseml {
+
+    BindingStore::PlaceholderId BindingStore::intern(const WSEML& placeholder) {
+        if (not isPlaceholder(placeholder) or placeholder == ANPLACEHOLDER) {
+            throw std::runtime_error("BindingStore::intern: not a named placeholder");
+        }
+        std::string buffer;
+        auto [it, inserted] = ids_.try_emplace(std::string(placeholder.getStringView(buffer)), nodes_.size());
+        if (inserted) {
+            placeholders_.push_back(placeholder);
+            nodes_.push_back({it->second});
+        }
+        return it->second;
+    }
+
+    BindingStore::PlaceholderId BindingStore::find(PlaceholderId id) {
+        PlaceholderId root = id;
+        while (nodes_[root].parent != root) {
+            root = nodes_[root].parent;
+        }
+        while (nodes_[id].parent != root) {
+            PlaceholderId next = nodes_[id].parent;
+            record(id);
+            nodes_[id].parent = root;
+            id = next;
+        }
+        return root;
+    }
+
+    const WSEML* BindingStore::getValue(PlaceholderId id) {
+        std::size_t value = nodes_[find(id)].value;
+        return value == UNBOUND ? nullptr : &values_[value];
+    }
+
+    bool BindingStore::bind(PlaceholderId id, WSEML value) {
+        PlaceholderId root = find(id);
+        if (nodes_[root].value != UNBOUND) {
+            return false;
+        }
+        record(root);
+        values_.push_back(std::move(value));
+        nodes_[root].value = values_.size() - 1;
+        return true;
+    }
+
+    bool BindingStore::unite(PlaceholderId first, PlaceholderId second) {
+        PlaceholderId firstRoot = find(first);
+        PlaceholderId secondRoot = find(second);
+        if (firstRoot == secondRoot) {
+            return true;
+        }
+        std::size_t firstValue = nodes_[firstRoot].value;
+        std::size_t secondValue = nodes_[secondRoot].value;
+        if (firstValue != UNBOUND and secondValue != UNBOUND and values_[firstValue] != values_[secondValue]) {
+            return false;
+        }
+
+        if (nodes_[firstRoot].rank < nodes_[secondRoot].rank) {
+            std::swap(firstRoot, secondRoot);
+        }
+        record(firstRoot);
+        record(secondRoot);
+        nodes_[secondRoot].parent = firstRoot;
+        if (nodes_[firstRoot].rank == nodes_[secondRoot].rank) {
+            nodes_[firstRoot].rank++;
+        }
+        if (nodes_[firstRoot].value == UNBOUND) {
+            nodes_[firstRoot].value = nodes_[secondRoot].value;
+        }
+        return true;
+    }
+
+    BindingStore::Mark BindingStore::mark() const {
+        return {trail_.size(), values_.size()};
+    }
+
+    void BindingStore::undo(Mark mark) {
+        while (trail_.size() > mark.trail) {
+            const TrailEntry& entry = trail_.back();
+            nodes_[entry.id] = entry.node;
+            trail_.pop_back();
+        }
+        values_.resize(mark.values);
+    }
+
+    std::size_t BindingStore::size() const {
+        return nodes_.size();
+    }
+
+    const WSEML& BindingStore::getPlaceholder(PlaceholderId id) const {
+        return placeholders_.at(id);
+    }
+
+    WSEML BindingStore::toAA() {
+        WSEML result = createAssociativeArray();
+        appendBlock(result, createBlock());
+        for (PlaceholderId id = 0; id < nodes_.size(); id++) {
+            PlaceholderId root = find(id);
+            if (const WSEML* value = getValue(root)) {
+                addKeyValueAssociationToAA(result, placeholders_[id], *value);
+            } else if (root != id) {
+                addKeyValueAssociationToAA(result, placeholders_[id], placeholders_[root]);
+            }
+        }
+        return result;
+    }
+
+    void BindingStore::record(PlaceholderId id) {
+        trail_.push_back({id, nodes_[id]});
+    }
+
+} // namespace wseml
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include "../include/associativeArray.hpp"
+#include "../include/builder.hpp"
+#include "../include/hashCons.hpp"
+#include "../include/hashUtils.hpp"
+
+namespace wseml {
+
+    /* ListBuilder */
+
+    ListBuilder::ListBuilder(WSEML type)
+        : type_(std::move(type)) {
+    }
+
+    void ListBuilder::reserve(std::size_t pairs) {
+        entries_.reserve(pairs);
+    }
+
+    void ListBuilder::append(WSEML data, WSEML key, WSEML keyRole, WSEML dataRole) {
+        entries_.push_back({std::move(data), std::move(key), std::move(keyRole), std::move(dataRole)});
+    }
+
+    std::size_t ListBuilder::size() const {
+        return entries_.size();
+    }
+
+    WSEML ListBuilder::finish() {
+        WSEML list = WSEML(std::list<Pair>(), type_);
+        List& pairs = list.getList();
+        for (Entry& entry : entries_) {
+            WSEML key = entry.key.hasObject() ? std::move(entry.key) : pairs.genKey();
+            pairs.emplace_back(&list, std::move(key), std::move(entry.data), std::move(entry.keyRole), std::move(entry.dataRole));
+        }
+        entries_.clear();
+        return list;
+    }
+
+    FrozenWSEML ListBuilder::finish(HashConsTable& table) {
+        return table.intern(finish());
+    }
+
+    /* BlockBuilder */
+
+    BlockBuilder::BlockBuilder()
+        : block_(createBlock())
+        , type_(WSEML::share(KV_ASSOC_TYPE)) {
+    }
+
+    void BlockBuilder::reserve(std::size_t associations) {
+        positions_.reserve(associations);
+    }
+
+    void BlockBuilder::add(WSEML key, WSEML value) {
+        addAssociation(std::move(key), std::move(value));
+    }
+
+    const WSEML& BlockBuilder::addAssociation(WSEML&& key, WSEML&& value) {
+        /* the pairs are created in place, linked from the start, and the handles are moved into them once; the
+           association refers to the shared type rather than holding a copy of it */
+        List& associations = block_.getList();
+        auto association = std::make_unique<List>(std::list<Pair>(), type_);
+        List& pairs = *association;
+        WSEML& holder = associations.appendMoved(&block_, associations.genKey(), WSEML(std::move(association))).getData();
+        positions_.push_back(std::prev(associations.end()));
+        /* the key createKeyValueAssociation generates */
+        return pairs.appendMoved(&holder, key.hasObject() ? std::move(key) : List::keyAt(0), std::move(value)).getKey();
+    }
+
+    void BlockBuilder::addFunctional(WSEML funcAssoc) {
+        if (not isFunctionalAssociation(funcAssoc)) {
+            throw std::runtime_error("addFunctional: funcAssoc is not a Functional Association");
+        }
+        List& associations = block_.getList();
+        associations.appendMoved(&block_, associations.genKey(), std::move(funcAssoc));
+        positions_.push_back(std::prev(associations.end()));
+    }
+
+    std::size_t BlockBuilder::size() const {
+        return positions_.size();
+    }
+
+    WSEML BlockBuilder::finish() {
+        WSEML block = createBlock();
+        fill(block);
+        return block;
+    }
+
+    FrozenWSEML BlockBuilder::finish(HashConsTable& table) {
+        return table.intern(finish());
+    }
+
+    void BlockBuilder::fill(WSEML& block) {
+        /* the pairs are reached through their positions, which are independent loads, rather than by walking the
+           List, where every load waits for the one before. Their keys are those of a Block filled from the start and
+           are only generated again for a Block that continues other keys */
+        List& built = block_.getList();
+        List& associations = block.getList();
+        bool continuesKeys = associations.generatedKeyCount() != 0;
+        for (List::iterator position : positions_) {
+            if (continuesKeys) {
+                position->getKey() = associations.genKey();
+            }
+            position->setListOwner(&block);
+        }
+        if (not continuesKeys) {
+            associations.setNextKeyAfter(positions_.size());
+        }
+        associations.splice(associations.end(), built);
+        built.setNextKeyAfter(0);
+        positions_.clear();
+    }
+
+    /* AABuilder */
+
+    AABuilder::AABuilder(KeyOrder order)
+        : order_(order) {
+    }
+
+    void AABuilder::reserve(std::size_t associations) {
+        BlockBuilder::reserve(associations);
+        if (order_ == KeyOrder::Unsorted) {
+            added_.reserve(associations);
+        }
+    }
+
+    void AABuilder::add(WSEML key, WSEML value) {
+        /* the key is compared or hashed here, while it is in the cache */
+        if (not key.hasObject()) {
+            key = List::keyAt(0);
+        }
+        if (order_ == KeyOrder::Sorted) {
+            if (previousKey_ == nullptr or *previousKey_ != key) {
+                previousKey_ = &addAssociation(std::move(key), std::move(value));
+            }
+            return;
+        }
+        std::size_t keyHash = std::hash<WSEML>{}(key);
+        added_.push_back({positions_.size(), keyHash, &addAssociation(std::move(key), std::move(value))});
+    }
+
+    void AABuilder::removeShadowed() {
+        /* the associations are partitioned by the hash of their keys, so that every partition is deduplicated in an
+           open-addressing table small enough for the cache; a table of all the keys would be probed at random */
+        constexpr std::size_t EMPTY = std::numeric_limits<std::size_t>::max();
+        constexpr std::size_t PARTITION_ENTRIES = 4096;
+        std::size_t partitions = std::bit_ceil(added_.size() / PARTITION_ENTRIES + 1);
+        int partitionBits = std::countr_zero(partitions);
+        auto partitionOf = [&](std::size_t keyHash) { return hash::hash_mix(keyHash) & (partitions - 1); };
+
+        std::vector<std::size_t> bounds(partitions + 1);
+        for (const Added& association : added_) {
+            bounds[partitionOf(association.keyHash) + 1]++;
+        }
+        std::partial_sum(bounds.begin(), bounds.end(), bounds.begin());
+        /* the associations of every partition in the order they were added, so that the first of a key is kept */
+        std::vector<std::size_t> partitioned(added_.size());
+        std::vector<std::size_t> next(bounds.begin(), bounds.end() - 1);
+        for (std::size_t i = 0; i < added_.size(); i++) {
+            partitioned[next[partitionOf(added_[i].keyHash)]++] = i;
+        }
+        std::size_t largest = 0;
+        for (std::size_t p = 0; p < partitions; p++) {
+            largest = std::max(largest, bounds[p + 1] - bounds[p]);
+        }
+
+        /* the associations are marked before any is erased, so that the keys stay in place for the comparisons */
+        std::vector<bool> keep(positions_.size(), true);
+        bool shadowed = false;
+        std::vector<std::size_t> slots(std::bit_ceil(largest * 2 + 1));
+        for (std::size_t p = 0; p < partitions; p++) {
+            std::size_t mask = std::bit_ceil((bounds[p + 1] - bounds[p]) * 2 + 1) - 1;
+            std::fill_n(slots.begin(), mask + 1, EMPTY);
+            for (std::size_t j = bounds[p]; j < bounds[p + 1]; j++) {
+                const Added& association = added_[partitioned[j]];
+                for (std::size_t slot = (hash::hash_mix(association.keyHash) >> partitionBits) & mask;; slot = (slot + 1) & mask) {
+                    if (slots[slot] == EMPTY) {
+                        slots[slot] = partitioned[j];
+                        break;
+                    }
+                    const Added& first = added_[slots[slot]];
+                    if (first.keyHash == association.keyHash and *first.key == *association.key) {
+                        keep[association.position] = false;
+                        shadowed = true;
+                        break;
+                    }
+                }
+            }
+        }
+        if (not shadowed) {
+            return;
+        }
+
+        /* the kept associations get the keys they would have been generated without the shadowed ones */
+        List& associations = block_.getList();
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < positions_.size(); i++) {
+            if (not keep[i]) {
+                associations.erase(positions_[i]);
+                continue;
+            }
+            if (kept != i) {
+                positions_[kept] = positions_[i];
+                positions_[kept]->getKey() = List::keyAt(kept);
+            }
+            kept++;
+        }
+        positions_.resize(kept);
+        associations.setNextKeyAfter(kept);
+    }
+
+    WSEML AABuilder::finish() {
+        removeShadowed();
+        added_.clear();
+        previousKey_ = nullptr;
+        WSEML aa = createAssociativeArray();
+        if (size() != 0) {
+            aa.append(createBlock());
+            fill(aa.getList().back());
+        }
+        return aa;
+    }
+
+    FrozenWSEML AABuilder::finish(HashConsTable& table) {
+        return table.intern(finish());
+    }
+
+} // namespace wseml
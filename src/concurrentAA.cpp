@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <string>
+#include "../include/concurrentAA.hpp"
+#include "../include/associativeArray.hpp"
+
+namespace wseml {
+
+    namespace {
+        template <typename Stack>
+        auto blockPosition(Stack& stack, std::size_t block) {
+            return std::lower_bound(stack.begin(), stack.end(), block, [](const auto& binding, std::size_t b) { return binding.block < b; });
+        }
+    } // namespace
+
+    ConcurrentAA::ConcurrentAA(std::size_t shards)
+        : shardMask_(std::bit_ceil(std::max<std::size_t>(shards, 1)) - 1)
+        , shards_(std::make_unique<Shard[]>(shardMask_ + 1)) {
+    }
+
+    ConcurrentAA::ConcurrentAA(const WSEML& aa, std::size_t shards)
+        : ConcurrentAA(shards) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("ConcurrentAA: aa is not an Associative Array");
+        }
+        for (const Pair& blockPair : aa.getInnerList()) {
+            std::size_t block = pushBlock();
+            for (const Pair& association : blockPair.getData().getInnerList()) {
+                const WSEML& assoc = association.getData();
+                if (isKeyValueAssociation(assoc)) {
+                    /* the first association of a key in a Block wins */
+                    bind(block, getKeyFromAssociation(assoc), getValueFromAssociation(assoc), false);
+                } else if (isFunctionalAssociation(assoc)) {
+                    addFunctionalAssociationToBlock(block, assoc);
+                }
+            }
+        }
+    }
+
+    std::size_t ConcurrentAA::pushBlock() {
+        std::unique_lock lock(structureMutex_);
+        blocks_.emplace_back();
+        return blocks_.size() - 1;
+    }
+
+    void ConcurrentAA::popBlock() {
+        std::unique_lock lock(structureMutex_);
+        if (blocks_.empty()) {
+            return;
+        }
+        std::size_t top = blocks_.size() - 1;
+        Block& block = blocks_.back();
+        for (const WSEML& key : block.keys) {
+            Shard& shard = shardOf(key);
+            std::unique_lock shardLock(shard.mutex);
+            unbindTop(shard.bindings, key, top);
+        }
+        if (not block.triggers.empty()) {
+            std::unique_lock funcAssocLock(funcAssocMutex_);
+            for (const WSEML& trigger : block.triggers) {
+                unbindTop(funcAssocs_, trigger, top);
+            }
+        }
+        blocks_.pop_back();
+    }
+
+    std::size_t ConcurrentAA::getBlockCount() const {
+        std::shared_lock lock(structureMutex_);
+        return blocks_.size();
+    }
+
+    void ConcurrentAA::insert(WSEML key, WSEML value) {
+        std::shared_lock lock(structureMutex_);
+        bind(topBlockCreatingOne(lock), std::move(key), std::move(value), true);
+    }
+
+    void ConcurrentAA::insertIntoBlock(std::size_t block, WSEML key, WSEML value) {
+        std::shared_lock lock(structureMutex_);
+        checkBlock(block, "ConcurrentAA::insertIntoBlock");
+        bind(block, std::move(key), std::move(value), true);
+    }
+
+    bool ConcurrentAA::erase(std::size_t block, const WSEML& key) {
+        std::shared_lock lock(structureMutex_);
+        checkBlock(block, "ConcurrentAA::erase");
+        Shard& shard = shardOf(key);
+        std::unique_lock shardLock(shard.mutex);
+        auto it = shard.bindings.find(key);
+        if (it == shard.bindings.end()) {
+            return false;
+        }
+        std::vector<Binding>& stack = it->second;
+        auto position = blockPosition(stack, block);
+        if (position == stack.end() or position->block != block) {
+            return false;
+        }
+        stack.erase(position);
+        if (stack.empty()) {
+            shard.bindings.erase(it);
+        }
+        /* the key stays in the block record; popBlock skips keys the block no longer binds */
+        return true;
+    }
+
+    void ConcurrentAA::addFunctionalAssociation(const WSEML& funcAssoc) {
+        if (not isFunctionalAssociation(funcAssoc)) {
+            throw std::runtime_error("ConcurrentAA::addFunctionalAssociation: funcAssoc is not a Functional Association");
+        }
+        std::shared_lock lock(structureMutex_);
+        addFunctionalAssociationToBlock(topBlockCreatingOne(lock), funcAssoc);
+    }
+
+    std::shared_ptr<const WSEML> ConcurrentAA::findValuePtr(const WSEML& key) const {
+        const Shard& shard = shardOf(key);
+        std::shared_lock lock(shard.mutex);
+        auto it = shard.bindings.find(key);
+        return it != shard.bindings.end() ? it->second.back().value : nullptr;
+    }
+
+    WSEML ConcurrentAA::findValue(const WSEML& key) const {
+        if (std::shared_ptr<const WSEML> value = findValuePtr(key)) {
+            return *value;
+        }
+        std::shared_ptr<const WSEML> funcAssoc;
+        {
+            std::shared_lock lock(funcAssocMutex_);
+            auto it = funcAssocs_.find(key.getSemanticType());
+            if (it != funcAssocs_.end()) {
+                funcAssoc = it->second.back().value;
+            }
+        }
+        /* the function runs without holding any lock */
+        return funcAssoc != nullptr ? callFunctionalAssociation(*funcAssoc, key) : NULLOBJ;
+    }
+
+    WSEML ConcurrentAA::toAA() const {
+        std::unique_lock lock(structureMutex_);
+        std::vector<WSEML> blocks(blocks_.size());
+        for (WSEML& block : blocks) {
+            block = createBlock();
+        }
+        for (std::size_t i = 0; i <= shardMask_; i++) {
+            std::shared_lock shardLock(shards_[i].mutex);
+            for (const auto& [key, stack] : shards_[i].bindings) {
+                for (const Binding& binding : stack) {
+                    addKeyValueAssociationToBlock(blocks[binding.block], key, *binding.value);
+                }
+            }
+        }
+        {
+            std::shared_lock funcAssocLock(funcAssocMutex_);
+            for (const auto& [trigger, stack] : funcAssocs_) {
+                /* within a block, the stack holds later associations deeper */
+                for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+                    wseml::addFunctionalAssociationToBlock(blocks[it->block], *it->value);
+                }
+            }
+        }
+        WSEML aa = createAssociativeArray();
+        for (const WSEML& block : blocks) {
+            appendBlock(aa, block);
+        }
+        return aa;
+    }
+
+    ConcurrentAA::Shard& ConcurrentAA::shardOf(const WSEML& key) const {
+        return shards_[std::hash<WSEML>{}(key) & shardMask_];
+    }
+
+    std::size_t ConcurrentAA::topBlockCreatingOne(std::shared_lock<std::shared_mutex>& structureLock) {
+        while (blocks_.empty()) {
+            structureLock.unlock();
+            {
+                std::unique_lock lock(structureMutex_);
+                if (blocks_.empty()) {
+                    blocks_.emplace_back();
+                }
+            }
+            structureLock.lock();
+        }
+        return blocks_.size() - 1;
+    }
+
+    void ConcurrentAA::checkBlock(std::size_t block, const char* caller) const {
+        if (block >= blocks_.size()) {
+            throw std::runtime_error(std::string(caller) + ": block " + std::to_string(block) + " does not exist");
+        }
+    }
+
+    /* the caller holds the structure lock, shared or exclusive */
+    void ConcurrentAA::bind(std::size_t block, WSEML key, WSEML value, bool replace) {
+        auto shared = std::make_shared<const WSEML>(std::move(value));
+        bool added = false;
+        {
+            Shard& shard = shardOf(key);
+            std::unique_lock shardLock(shard.mutex);
+            std::vector<Binding>& stack = shard.bindings[key];
+            auto position = blockPosition(stack, block);
+            if (position != stack.end() and position->block == block) {
+                if (replace) {
+                    position->value = std::move(shared);
+                }
+            } else {
+                stack.insert(position, Binding{block, std::move(shared)});
+                added = true;
+            }
+        }
+        if (added) {
+            Block& record = blocks_[block];
+            std::lock_guard recordLock(record.mutex);
+            record.keys.insert(std::move(key));
+        }
+    }
+
+    void ConcurrentAA::addFunctionalAssociationToBlock(std::size_t block, const WSEML& funcAssoc) {
+        const WSEML& trigger = getFuncAssocTriggerType(funcAssoc);
+        {
+            std::unique_lock lock(funcAssocMutex_);
+            std::vector<Binding>& stack = funcAssocs_[trigger];
+            /* the first association of a block wins, so later ones go below the ones already in the block */
+            stack.insert(blockPosition(stack, block), Binding{block, std::make_shared<const WSEML>(funcAssoc)});
+        }
+        Block& record = blocks_[block];
+        std::lock_guard recordLock(record.mutex);
+        record.triggers.insert(trigger);
+    }
+
+    void ConcurrentAA::unbindTop(BindingStacks& stacks, const WSEML& key, std::size_t block) {
+        auto it = stacks.find(key);
+        if (it == stacks.end()) {
+            return;
+        }
+        std::vector<Binding>& stack = it->second;
+        while (not stack.empty() and stack.back().block == block) {
+            stack.pop_back();
+        }
+        if (stack.empty()) {
+            stacks.erase(it);
+        }
+    }
+
+} // namespace wseml
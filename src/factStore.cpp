@@ -0,0 +1,163 @@
+#include <algorithm>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/factStore.hpp"
+
+namespace wseml {
+
+    namespace {
+        /* values that unify with another ground value only if they are equal */
+        bool isIndexable(const WSEML& value) {
+            return not containsPlaceholder(value) and not containsAssociativeStructure(value);
+        }
+    } // namespace
+
+    FactStore::FactId FactStore::add(WSEML fact) {
+        if (not isAssociativeArray(fact)) {
+            throw std::runtime_error("FactStore::add: fact is not an Associative Array");
+        }
+        FactId id = nextId_++;
+        const WSEML& stored = facts_.emplace(id, std::move(fact)).first->second;
+        for (const auto& [key, value] : getEffectiveAssociations(stored)) {
+            KeyPostings& postings = index_[*key];
+            if (isIndexable(*value)) {
+                std::size_t valueHash = std::hash<WSEML>{}(*value);
+                postings.groundHashes.emplace(id, valueHash);
+                postings.byHash[valueHash].insert(id);
+            } else {
+                postings.nonGround.insert(id);
+            }
+        }
+        return id;
+    }
+
+    bool FactStore::remove(FactId id) {
+        auto factIt = facts_.find(id);
+        if (factIt == facts_.end()) {
+            return false;
+        }
+        for (const auto& [key, value] : getEffectiveAssociations(factIt->second)) {
+            auto postingsIt = index_.find(*key);
+            KeyPostings& postings = postingsIt->second;
+            auto groundIt = postings.groundHashes.find(id);
+            if (groundIt != postings.groundHashes.end()) {
+                auto hashIt = postings.byHash.find(groundIt->second);
+                hashIt->second.erase(id);
+                if (hashIt->second.empty()) {
+                    postings.byHash.erase(hashIt);
+                }
+                postings.groundHashes.erase(groundIt);
+            } else {
+                postings.nonGround.erase(id);
+            }
+            if (postings.factCount() == 0) {
+                index_.erase(postingsIt);
+            }
+        }
+        facts_.erase(factIt);
+        return true;
+    }
+
+    const WSEML& FactStore::get(FactId id) const {
+        auto it = facts_.find(id);
+        if (it == facts_.end()) {
+            throw std::runtime_error("FactStore::get: no fact with the given id");
+        }
+        return it->second;
+    }
+
+    bool FactStore::contains(FactId id) const {
+        return facts_.contains(id);
+    }
+
+    std::size_t FactStore::size() const {
+        return facts_.size();
+    }
+
+    bool FactStore::admits(FactId id, const KeyPostings& postings, std::size_t valueHash) const {
+        auto it = postings.groundHashes.find(id);
+        return it == postings.groundHashes.end() or it->second == valueHash;
+    }
+
+    std::vector<FactStore::FactId> FactStore::candidates(const WSEML& pattern) const {
+        if (not isAssociativeArray(pattern)) {
+            throw std::runtime_error("FactStore::candidates: pattern is not an Associative Array");
+        }
+
+        struct Constraint {
+            const KeyPostings* postings;
+            std::size_t valueHash;
+            std::size_t estimate;
+        };
+
+        std::vector<Constraint> constraints;
+        for (const auto& [key, value] : getEffectiveAssociations(pattern)) {
+            if (not isIndexable(*value)) {
+                continue;
+            }
+            auto postingsIt = index_.find(*key);
+            if (postingsIt == index_.end()) {
+                continue;
+            }
+            const KeyPostings& postings = postingsIt->second;
+            std::size_t valueHash = std::hash<WSEML>{}(*value);
+            auto hashIt = postings.byHash.find(valueHash);
+            std::size_t matching = hashIt == postings.byHash.end() ? 0 : hashIt->second.size();
+            std::size_t estimate = matching + postings.nonGround.size() + (facts_.size() - postings.factCount());
+            constraints.push_back({&postings, valueHash, estimate});
+        }
+
+        std::vector<FactId> result;
+        if (constraints.empty()) {
+            result.reserve(facts_.size());
+            for (const auto& [id, fact] : facts_) {
+                result.push_back(id);
+            }
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+        auto best = std::min_element(constraints.begin(), constraints.end(), [](const Constraint& lhs, const Constraint& rhs) {
+            return lhs.estimate < rhs.estimate;
+        });
+        const KeyPostings& bestPostings = *best->postings;
+
+        auto accept = [&](FactId id) {
+            for (const Constraint& constraint : constraints) {
+                if (&constraint != &*best and not admits(id, *constraint.postings, constraint.valueHash)) {
+                    return;
+                }
+            }
+            result.push_back(id);
+        };
+
+        if (bestPostings.factCount() == facts_.size()) {
+            /* every fact has the key: only facts with an equal or a non-ground value remain */
+            auto hashIt = bestPostings.byHash.find(best->valueHash);
+            if (hashIt != bestPostings.byHash.end()) {
+                std::for_each(hashIt->second.begin(), hashIt->second.end(), accept);
+            }
+            std::for_each(bestPostings.nonGround.begin(), bestPostings.nonGround.end(), accept);
+        } else {
+            for (const auto& [id, fact] : facts_) {
+                if (admits(id, bestPostings, best->valueHash)) {
+                    accept(id);
+                }
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<FactMatch> FactStore::query(const WSEML& pattern) const {
+        std::vector<FactMatch> result;
+        for (FactId id : candidates(pattern)) {
+            auto [unified, bindings] = unify(facts_.at(id), pattern);
+            if (unified != NULLOBJ) {
+                result.push_back({id, std::move(unified), std::move(bindings)});
+            }
+        }
+        return result;
+    }
+
+} // namespace wseml
@@ -0,0 +1,105 @@
+#include <utility>
+#include <vector>
+#include "../include/frozen.hpp"
+#include "../include/associativeArray.hpp"
+
+namespace wseml {
+
+    FrozenWSEML::FrozenWSEML()
+        : FrozenWSEML(freeze(WSEML())) {
+    }
+
+    FrozenWSEML::FrozenWSEML(WSEML node)
+        : node_(std::move(node)) {
+    }
+
+    const SharedNode& FrozenWSEML::node() const {
+        return *node_.getSharedNode();
+    }
+
+    const WSEML& FrozenWSEML::get() const {
+        return node().tree;
+    }
+
+    const WSEML& FrozenWSEML::operator*() const {
+        return node().tree;
+    }
+
+    const WSEML* FrozenWSEML::operator->() const {
+        return &node().tree;
+    }
+
+    std::size_t FrozenWSEML::hash() const {
+        return node().hash;
+    }
+
+    bool FrozenWSEML::sharesWith(const FrozenWSEML& other) const {
+        return &node() == &other.node();
+    }
+
+    WSEML FrozenWSEML::thaw() const {
+        return node().tree;
+    }
+
+    bool FrozenWSEML::operator==(const FrozenWSEML& other) const {
+        if (sharesWith(other)) {
+            return true;
+        }
+        /* a table holds a single node per value */
+        if (node().table != 0 and node().table == other.node().table) {
+            return false;
+        }
+        return hash() == other.hash() and get() == other.get();
+    }
+
+    FrozenWSEML freeze(WSEML tree) {
+        if (tree.isShared()) {
+            return FrozenWSEML(std::move(tree));
+        }
+        WSEML node = WSEML::share(std::move(tree));
+        /* nobody else holds the node yet */
+        WSEML* root = const_cast<WSEML*>(&node.getSharedNode()->tree);
+
+        /* collect first: the mutating accessors used by the walk assert once an object is frozen */
+        std::vector<WSEML*> objects;
+        std::vector<WSEML*> pending{root};
+        while (not pending.empty()) {
+            WSEML* current = pending.back();
+            pending.pop_back();
+            /* an inline string takes the frozen flag of the List holding it when it is promoted; only the root has none.
+               A shared node is frozen already */
+            if ((current->isInline() and current != root) or current->isShared()) {
+                continue;
+            }
+            Object* obj = current->getRawObject();
+            if (obj == nullptr) {
+                continue;
+            }
+            objects.push_back(current);
+            /* the const accessor does not hand out the type for editing, which would keep the lookup caches from
+               relying on the object (see Object::watch) */
+            pending.push_back(const_cast<WSEML*>(&std::as_const(*obj).getSemanticType()));
+            if (current->structureTypeInfo() == StructureType::List) {
+                for (Pair& pair : current->getList()) {
+                    pair.forEachMember([&](WSEML& member) { pending.push_back(&member); });
+                }
+            }
+        }
+        for (WSEML* obj : objects) {
+            obj->getRawObject()->setFrozen();
+        }
+        /* caches synchronized over a frozen AA stay current */
+        for (WSEML* obj : objects) {
+            if (isAssociativeArray(*obj)) {
+                syncLookupCaches(*obj);
+            }
+        }
+        return FrozenWSEML(std::move(node));
+    }
+
+    bool isFrozen(const WSEML& obj) {
+        const Object* raw = obj.getRawObject();
+        return raw != nullptr and raw->isFrozen();
+    }
+
+} // namespace wseml
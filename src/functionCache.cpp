@@ -0,0 +1,118 @@
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/functionCache.hpp"
+
+namespace wseml {
+
+    FunctionResultCache::FunctionResultCache(std::size_t capacity)
+        : capacity_(capacity) {}
+
+    std::optional<WSEML> FunctionResultCache::lookup(const WSEML& funcRef, const WSEML& key) {
+        std::lock_guard lock(mutex_);
+        auto functionIt = functions_.find(funcRef);
+        if (functionIt == functions_.end()) {
+            stats_.misses++;
+            return std::nullopt;
+        }
+        FunctionEntries& entries = functionIt->second;
+        auto entryIt = entries.index.find(key);
+        if (entryIt == entries.index.end()) {
+            stats_.misses++;
+            return std::nullopt;
+        }
+        stats_.hits++;
+        entries.lru.splice(entries.lru.begin(), entries.lru, entryIt->second);
+        return entryIt->second->second;
+    }
+
+    void FunctionResultCache::store(const WSEML& funcRef, const WSEML& key, WSEML result) {
+        std::lock_guard lock(mutex_);
+        if (capacity_ == 0) {
+            return;
+        }
+        FunctionEntries& entries = functions_[funcRef];
+        auto entryIt = entries.index.find(key);
+        if (entryIt != entries.index.end()) {
+            entryIt->second->second = std::move(result);
+            entries.lru.splice(entries.lru.begin(), entries.lru, entryIt->second);
+            return;
+        }
+        entries.lru.emplace_front(key, std::move(result));
+        entries.index.emplace(key, entries.lru.begin());
+        evictOverflow(entries);
+    }
+
+    WSEML FunctionResultCache::call(const WSEML& funcRef, const WSEML& key) {
+        if (auto cached = lookup(funcRef, key)) {
+            return std::move(*cached);
+        }
+        WSEML result = callFunction(funcRef, key);
+        if (result != NULLOBJ) {
+            store(funcRef, key, result);
+        }
+        return result;
+    }
+
+    void FunctionResultCache::invalidate(const WSEML& funcRef) {
+        std::lock_guard lock(mutex_);
+        auto functionIt = functions_.find(funcRef);
+        if (functionIt != functions_.end()) {
+            stats_.invalidations += functionIt->second.lru.size();
+            functions_.erase(functionIt);
+        }
+    }
+
+    void FunctionResultCache::invalidateAll() {
+        std::lock_guard lock(mutex_);
+        for (const auto& [funcRef, entries] : functions_) {
+            stats_.invalidations += entries.lru.size();
+        }
+        functions_.clear();
+    }
+
+    void FunctionResultCache::setCapacity(std::size_t capacity) {
+        std::lock_guard lock(mutex_);
+        capacity_ = capacity;
+        for (auto& [funcRef, entries] : functions_) {
+            evictOverflow(entries);
+        }
+    }
+
+    std::size_t FunctionResultCache::getCapacity() const {
+        std::lock_guard lock(mutex_);
+        return capacity_;
+    }
+
+    std::size_t FunctionResultCache::size() const {
+        std::lock_guard lock(mutex_);
+        std::size_t result = 0;
+        for (const auto& [funcRef, entries] : functions_) {
+            result += entries.lru.size();
+        }
+        return result;
+    }
+
+    FunctionCacheStats FunctionResultCache::getStats() const {
+        std::lock_guard lock(mutex_);
+        return stats_;
+    }
+
+    void FunctionResultCache::resetStats() {
+        std::lock_guard lock(mutex_);
+        stats_ = FunctionCacheStats();
+    }
+
+    void FunctionResultCache::evictOverflow(FunctionEntries& entries) {
+        while (entries.lru.size() > capacity_) {
+            entries.index.erase(entries.lru.back().first);
+            entries.lru.pop_back();
+            stats_.evictions++;
+        }
+    }
+
+    FunctionResultCache& getFunctionResultCache() {
+        static FunctionResultCache cache;
+        return cache;
+    }
+
+} // namespace wseml
@@ -0,0 +1,132 @@
+#include <atomic>
+#include <iterator>
+#include <utility>
+#include "../include/hashCons.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/parser.hpp"
+
+namespace wseml {
+
+    namespace {
+        /* ids are never reused, so nodes outliving their table cannot match those of a later table */
+        std::uint64_t nextTableId() {
+            static std::atomic<std::uint64_t> lastId{0};
+            return ++lastId;
+        }
+    } // namespace
+
+    HashConsTable::HashConsTable()
+        : id_(nextTableId()) {
+    }
+
+    FrozenWSEML HashConsTable::intern(WSEML tree) {
+        /* post-order with an explicit stack: the subtrees of a handle are interned before the handle itself */
+        std::vector<std::pair<WSEML*, bool>> pending{{&tree, false}};
+        while (not pending.empty()) {
+            auto [handle, expanded] = pending.back();
+            if (expanded) {
+                pending.pop_back();
+                Pair* pair = handle->getContainingPair();
+                *handle = internNode(std::move(*handle));
+                /* the emptied handle has no link to pass on to the node */
+                handle->updateLinksRecursively(pair);
+                continue;
+            }
+            /* the handles with nothing to share but the root */
+            bool leaf = not handle->hasObject() or handle->isInline();
+            const SharedNode* node = handle->getSharedNode();
+            if ((node != nullptr and node->table == id_) or (leaf and handle != &tree)) {
+                pending.pop_back();
+                continue;
+            }
+            pending.back().second = true;
+            if (leaf) {
+                continue;
+            }
+            /* copies the root of a node this table does not hold */
+            Object* obj = handle->getRawObject();
+            /* the const accessor does not hand out the type for editing (see freeze) */
+            pending.emplace_back(const_cast<WSEML*>(&std::as_const(*obj).getSemanticType()), false);
+            if (obj->structureTypeInfo() == StructureType::List) {
+                for (Pair& pair : static_cast<List&>(*obj)) {
+                    pair.forEachMember([&](WSEML& member) { pending.emplace_back(&member, false); });
+                }
+            }
+        }
+        return FrozenWSEML(std::move(tree));
+    }
+
+    FrozenWSEML HashConsTable::intern(const FrozenWSEML& tree) {
+        if (tree.node().table == id_) {
+            return tree;
+        }
+        return intern(tree.thaw());
+    }
+
+    WSEML HashConsTable::internNode(WSEML tree) {
+        stats_.interned++;
+        WSEML node = WSEML::share(std::move(tree));
+        if (const WSEML* held = find(node)) {
+            stats_.reused++;
+            /* the subtrees of the copy were counted as they were replaced */
+            stats_.bytesSaved += footprint(node.getSharedNode()->tree, false);
+            return *held;
+        }
+        /* nobody else holds the node yet */
+        auto& added = const_cast<SharedNode&>(*node.getSharedNode());
+        if (Object* root = added.tree.getRawObject()) {
+            root->setFrozen();
+        }
+        /* caches synchronized over a frozen AA stay current; its Blocks are nodes of their own */
+        if (isAssociativeArray(added.tree)) {
+            syncLookupCaches(added.tree);
+        }
+        added.table = id_;
+        buckets_[added.hash].push_back(node);
+        stats_.distinct++;
+        stats_.overheadBytes += sizeof(SharedNode);
+        return node;
+    }
+
+    std::size_t HashConsTable::size() const {
+        return stats_.distinct;
+    }
+
+    HashConsStats HashConsTable::stats() const {
+        return stats_;
+    }
+
+    std::size_t HashConsTable::purge() {
+        std::size_t dropped = 0;
+        /* dropping a node releases its subtrees, which may leave them unreferenced in turn */
+        for (std::size_t before = dropped + 1; before != dropped;) {
+            before = dropped;
+            for (auto bucket = buckets_.begin(); bucket != buckets_.end();) {
+                std::vector<WSEML>& nodes = bucket->second;
+                dropped += std::erase_if(nodes, [](const WSEML& node) { return node.getSharedNode()->references.load(std::memory_order_acquire) == 1; });
+                bucket = nodes.empty() ? buckets_.erase(bucket) : std::next(bucket);
+            }
+        }
+        stats_.distinct -= dropped;
+        stats_.overheadBytes -= dropped * sizeof(SharedNode);
+        return dropped;
+    }
+
+    const WSEML* HashConsTable::find(const WSEML& node) const {
+        auto bucket = buckets_.find(node.getSharedNode()->hash);
+        if (bucket == buckets_.end()) {
+            return nullptr;
+        }
+        for (const WSEML& held : bucket->second) {
+            if (held == node) {
+                return &held;
+            }
+        }
+        return nullptr;
+    }
+
+    FrozenWSEML parse(const std::string& text, HashConsTable& table) {
+        return table.intern(parse(text));
+    }
+
+} // namespace wseml
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include "../include/hashUtils.hpp"
+#include "../include/keyFilter.hpp"
+
+namespace wseml {
+
+    KeyFilter::KeyFilter(std::size_t capacity) {
+        reset(capacity);
+    }
+
+    KeyFilter::KeyFilter(const KeyFilter& other)
+        : bits_(other.bits_),
+          capacity_(other.capacity_),
+          inserted_(other.inserted_) {
+        /* the copy describes another Block, which has not been watched yet */
+    }
+
+    bool KeyFilter::isCurrent(std::uint64_t modificationCount) const {
+        if (not valid_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        return frozen_.load(std::memory_order_relaxed) or syncedCount_.load(std::memory_order_relaxed) == modificationCount;
+    }
+
+    bool KeyFilter::isUsable() const {
+        return usable_.load(std::memory_order_relaxed);
+    }
+
+    void KeyFilter::insert(std::size_t keyHash, std::uint64_t modificationCount) {
+        if (inserted_ >= capacity_) {
+            invalidate();
+            return;
+        }
+        set(bits_, keyHash);
+        inserted_++;
+        syncedCount_.store(modificationCount, std::memory_order_relaxed);
+        valid_.store(true, std::memory_order_release);
+    }
+
+    void KeyFilter::resync(std::uint64_t modificationCount) {
+        syncedCount_.store(modificationCount, std::memory_order_relaxed);
+        valid_.store(true, std::memory_order_release);
+    }
+
+    void KeyFilter::invalidate() {
+        valid_.store(false, std::memory_order_release);
+    }
+
+    void KeyFilter::rebuild(std::span<const std::size_t> keyHashes, std::uint64_t modificationCount, bool usable, bool frozen) {
+        std::lock_guard lock(rebuildMutex_);
+        if (isCurrent(modificationCount)) {
+            return;
+        }
+        if (usable) {
+            /* leave room for the keys added after the rebuild */
+            std::size_t capacity = std::max<std::size_t>(std::max(capacity_, keyHashes.size() * 2), 1);
+            std::vector<std::uint64_t> bits((capacity * BITS_PER_KEY + 63) / 64, 0);
+            for (std::size_t keyHash : keyHashes) {
+                set(bits, keyHash);
+            }
+            if (bits != bits_ or not usable_.load(std::memory_order_relaxed)) {
+                valid_.store(false, std::memory_order_relaxed);
+                bits_ = std::move(bits);
+                capacity_ = capacity;
+            }
+            inserted_ = keyHashes.size();
+        }
+        usable_.store(usable, std::memory_order_relaxed);
+        frozen_.store(frozen, std::memory_order_relaxed);
+        syncedCount_.store(modificationCount, std::memory_order_relaxed);
+        rebuilds_.fetch_add(1, std::memory_order_relaxed);
+        valid_.store(true, std::memory_order_release);
+    }
+
+    bool KeyFilter::mayContain(std::size_t keyHash) const {
+        std::size_t bitCount = bits_.size() * 64;
+        std::size_t h1 = hash::hash_mix(keyHash);
+        std::size_t h2 = hash::hash_mix(h1) | 1;
+        for (std::size_t i = 0; i < PROBES; i++) {
+            std::size_t bit = (h1 + i * h2) % bitCount;
+            if ((bits_[bit / 64] & (std::uint64_t{1} << (bit % 64))) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::size_t KeyFilter::getCapacity() const {
+        return capacity_;
+    }
+
+    KeyFilterStats KeyFilter::getStats() const {
+        return {
+            queries_.load(std::memory_order_relaxed),
+            negatives_.load(std::memory_order_relaxed),
+            falsePositives_.load(std::memory_order_relaxed),
+            rebuilds_.load(std::memory_order_relaxed),
+        };
+    }
+
+    void KeyFilter::recordQuery(bool negative) const {
+        queries_.fetch_add(1, std::memory_order_relaxed);
+        if (negative) {
+            negatives_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void KeyFilter::recordFalsePositive() const {
+        falsePositives_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void KeyFilter::reset(std::size_t capacity) {
+        capacity_ = std::max<std::size_t>(capacity, 1);
+        bits_.assign((capacity_ * BITS_PER_KEY + 63) / 64, 0);
+        inserted_ = 0;
+    }
+
+    void KeyFilter::set(std::vector<std::uint64_t>& bits, std::size_t keyHash) {
+        std::size_t bitCount = bits.size() * 64;
+        std::size_t h1 = hash::hash_mix(keyHash);
+        std::size_t h2 = hash::hash_mix(h1) | 1;
+        for (std::size_t i = 0; i < PROBES; i++) {
+            std::size_t bit = (h1 + i * h2) % bitCount;
+            bits[bit / 64] |= std::uint64_t{1} << (bit % 64);
+        }
+    }
+
+} // namespace wseml
@@ -0,0 +1,257 @@
+#include <algorithm>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/matchNetwork.hpp"
+
+namespace wseml {
+
+    namespace {
+        /* adds source to target; fails if a placeholder is bound to different values */
+        template <typename Bindings>
+        bool joinBindings(Bindings& target, const Bindings& source) {
+            for (const auto& [placeholder, value] : source) {
+                auto [it, inserted] = target.try_emplace(placeholder, value);
+                if (not inserted and it->second != value) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    } // namespace
+
+    std::size_t MatchNetwork::internAlphaTest(const WSEML& key, const WSEML& value) {
+        auto& tests = alphaTestIndex_[key];
+        auto it = tests.find(value);
+        if (it != tests.end()) {
+            return it->second;
+        }
+        alphaTests_.push_back({key, value});
+        tests.emplace(value, alphaTests_.size() - 1);
+        return alphaTests_.size() - 1;
+    }
+
+    std::size_t MatchNetwork::internAlphaMemory(const WSEML& pattern) {
+        auto it = alphaMemoryIndex_.find(pattern);
+        if (it != alphaMemoryIndex_.end()) {
+            return it->second;
+        }
+
+        AlphaMemory memory;
+        memory.pattern = pattern;
+        for (const auto& [key, value] : getEffectiveAssociations(pattern)) {
+            if (not containsPlaceholder(*value) and not containsAssociativeStructure(*value)) {
+                memory.tests.push_back(internAlphaTest(*key, *value));
+            }
+        }
+        alphaMemories_.push_back(std::move(memory));
+        std::size_t index = alphaMemories_.size() - 1;
+        alphaMemoryIndex_.emplace(pattern, index);
+
+        for (const auto& [id, fact] : facts_) {
+            std::vector<char> testResults = evaluateAlphaTests(fact);
+            AlphaMemory& added = alphaMemories_[index];
+            if (passesAlphaTests(added, testResults)) {
+                auto [unified, bindingsAA] = unify(fact, added.pattern);
+                if (unified != NULLOBJ) {
+                    Bindings bindings;
+                    for (const auto& [placeholder, value] : getEffectiveAssociations(bindingsAA)) {
+                        bindings.emplace(*placeholder, *value);
+                    }
+                    added.facts.emplace(id, std::move(bindings));
+                }
+            }
+        }
+        return index;
+    }
+
+    std::vector<char> MatchNetwork::evaluateAlphaTests(const WSEML& fact) const {
+        /* a ground pattern entry can only be contradicted by a ground value of the same key */
+        std::vector<char> results(alphaTests_.size(), 1);
+        for (const auto& [key, value] : getEffectiveAssociations(fact)) {
+            auto testsIt = alphaTestIndex_.find(*key);
+            if (testsIt == alphaTestIndex_.end() or containsPlaceholder(*value) or containsAssociativeStructure(*value)) {
+                continue;
+            }
+            for (const auto& [testValue, test] : testsIt->second) {
+                if (testValue != *value) {
+                    results[test] = 0;
+                }
+            }
+        }
+        return results;
+    }
+
+    bool MatchNetwork::passesAlphaTests(const AlphaMemory& memory, const std::vector<char>& testResults) const {
+        return std::all_of(memory.tests.begin(), memory.tests.end(), [&](std::size_t test) { return testResults[test] != 0; });
+    }
+
+    MatchNetwork::RuleId MatchNetwork::addRule(const std::vector<WSEML>& patterns) {
+        if (patterns.empty()) {
+            throw std::runtime_error("MatchNetwork::addRule: a rule needs at least one pattern");
+        }
+        for (const WSEML& pattern : patterns) {
+            if (not isAssociativeArray(pattern)) {
+                throw std::runtime_error("MatchNetwork::addRule: pattern is not an Associative Array");
+            }
+        }
+
+        RuleId ruleId = rules_.size();
+        Rule rule;
+        for (std::size_t position = 0; position < patterns.size(); position++) {
+            std::size_t memory = internAlphaMemory(patterns[position]);
+            rule.memories.push_back(memory);
+            alphaMemories_[memory].successors.emplace_back(ruleId, position);
+        }
+        rule.levels.resize(patterns.size());
+
+        std::vector<Activation> activations;
+        for (const auto& [id, bindings] : alphaMemories_[rule.memories.front()].facts) {
+            propagate(rule, ruleId, 0, Token{{id}, bindings}, id, {}, activations);
+        }
+        rules_.push_back(std::move(rule));
+        return ruleId;
+    }
+
+    std::vector<Activation> MatchNetwork::addFact(WSEML fact, FactId* id) {
+        if (not isAssociativeArray(fact)) {
+            throw std::runtime_error("MatchNetwork::addFact: fact is not an Associative Array");
+        }
+        FactId factId = nextFactId_++;
+        if (id != nullptr) {
+            *id = factId;
+        }
+        const WSEML& stored = facts_.emplace(factId, std::move(fact)).first->second;
+
+        /* alpha network: every shared test is evaluated once, unify confirms the surviving patterns */
+        std::vector<char> testResults = evaluateAlphaTests(stored);
+        std::unordered_map<RuleId, std::vector<std::size_t>> positions;
+        for (AlphaMemory& memory : alphaMemories_) {
+            if (not passesAlphaTests(memory, testResults)) {
+                continue;
+            }
+            auto [unified, bindingsAA] = unify(stored, memory.pattern);
+            if (unified == NULLOBJ) {
+                continue;
+            }
+            Bindings bindings;
+            for (const auto& [placeholder, value] : getEffectiveAssociations(bindingsAA)) {
+                bindings.emplace(*placeholder, *value);
+            }
+            memory.facts.emplace(factId, std::move(bindings));
+            for (const auto& [rule, position] : memory.successors) {
+                positions[rule].push_back(position);
+            }
+        }
+
+        /* beta network: join the new fact with the partial matches preceding each position it entered */
+        std::vector<Activation> activations;
+        for (auto& [ruleId, rulePositions] : positions) {
+            Rule& rule = rules_[ruleId];
+            std::sort(rulePositions.begin(), rulePositions.end());
+            for (std::size_t position : rulePositions) {
+                const Bindings& factBindings = alphaMemories_[rule.memories[position]].facts.at(factId);
+                if (position == 0) {
+                    propagate(rule, ruleId, 0, Token{{factId}, factBindings}, factId, rulePositions, activations);
+                    continue;
+                }
+                std::size_t leftCount = rule.levels[position - 1].size();
+                for (std::size_t i = 0; i < leftCount; i++) {
+                    Token token = rule.levels[position - 1][i];
+                    if (joinBindings(token.bindings, factBindings)) {
+                        token.facts.push_back(factId);
+                        propagate(rule, ruleId, position, std::move(token), factId, rulePositions, activations);
+                    }
+                }
+            }
+        }
+        return activations;
+    }
+
+    void MatchNetwork::propagate(Rule& rule, RuleId ruleId, std::size_t level, Token token, FactId newFact,
+                                 const std::vector<std::size_t>& pendingPositions, std::vector<Activation>& activations) {
+        std::size_t next = level + 1;
+        if (next == rule.memories.size()) {
+            activations.push_back(makeActivation(ruleId, token));
+            rule.levels[level].push_back(std::move(token));
+            return;
+        }
+        rule.levels[level].push_back(token);
+
+        /* the new fact is joined at later positions it entered when those positions are processed */
+        bool skipNewFact = std::binary_search(pendingPositions.begin(), pendingPositions.end(), next);
+        for (const auto& [id, bindings] : alphaMemories_[rule.memories[next]].facts) {
+            if (skipNewFact and id == newFact) {
+                continue;
+            }
+            Token joined = token;
+            if (joinBindings(joined.bindings, bindings)) {
+                joined.facts.push_back(id);
+                propagate(rule, ruleId, next, std::move(joined), newFact, pendingPositions, activations);
+            }
+        }
+    }
+
+    std::vector<Activation> MatchNetwork::removeFact(FactId id) {
+        std::vector<Activation> retracted;
+        if (facts_.erase(id) == 0) {
+            return retracted;
+        }
+        for (AlphaMemory& memory : alphaMemories_) {
+            memory.facts.erase(id);
+        }
+        for (RuleId ruleId = 0; ruleId < rules_.size(); ruleId++) {
+            Rule& rule = rules_[ruleId];
+            for (std::size_t level = 0; level < rule.levels.size(); level++) {
+                std::vector<Token>& tokens = rule.levels[level];
+                auto removed = std::stable_partition(tokens.begin(), tokens.end(), [&](const Token& token) {
+                    return std::find(token.facts.begin(), token.facts.end(), id) == token.facts.end();
+                });
+                if (level + 1 == rule.levels.size()) {
+                    for (auto it = removed; it != tokens.end(); ++it) {
+                        retracted.push_back(makeActivation(ruleId, *it));
+                    }
+                }
+                tokens.erase(removed, tokens.end());
+            }
+        }
+        return retracted;
+    }
+
+    std::vector<Activation> MatchNetwork::getActivations(RuleId rule) const {
+        if (rule >= rules_.size()) {
+            throw std::runtime_error("MatchNetwork::getActivations: no such rule");
+        }
+        std::vector<Activation> result;
+        for (const Token& token : rules_[rule].levels.back()) {
+            result.push_back(makeActivation(rule, token));
+        }
+        return result;
+    }
+
+    const WSEML& MatchNetwork::getFact(FactId id) const {
+        auto it = facts_.find(id);
+        if (it == facts_.end()) {
+            throw std::runtime_error("MatchNetwork::getFact: no fact with the given id");
+        }
+        return it->second;
+    }
+
+    std::size_t MatchNetwork::getAlphaTestCount() const {
+        return alphaTests_.size();
+    }
+
+    std::size_t MatchNetwork::getAlphaMemoryCount() const {
+        return alphaMemories_.size();
+    }
+
+    Activation MatchNetwork::makeActivation(RuleId ruleId, const Token& token) const {
+        WSEML bindings = createAssociativeArray();
+        WSEML block = createBlock();
+        appendBlock(bindings, block);
+        for (const auto& [placeholder, value] : token.bindings) {
+            addKeyValueAssociationToAA(bindings, placeholder, value);
+        }
+        return {ruleId, token.facts, std::move(bindings)};
+    }
+
+} // namespace wseml
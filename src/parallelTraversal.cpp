@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <vector>
+#include "../include/parallelTraversal.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/hashUtils.hpp"
+
+namespace wseml {
+
+    namespace {
+        struct Traversal {
+            WorkStealingPool& pool;
+            std::size_t threshold;
+        };
+
+        /* calls body(i) for every index below count, in chunks of threshold indices when there are enough of them */
+        template <typename Body>
+        void forEachIndex(std::size_t count, const Traversal& traversal, const Body& body) {
+            if (count < traversal.threshold) {
+                for (std::size_t i = 0; i < count; i++) {
+                    body(i);
+                }
+                return;
+            }
+            traversal.pool.parallelFor(0, count, traversal.threshold, [&](std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; i++) {
+                    body(i);
+                }
+            });
+        }
+
+        std::vector<const Pair*> pairPointers(const std::list<Pair>& pairs) {
+            std::vector<const Pair*> result;
+            result.reserve(pairs.size());
+            for (const Pair& pair : pairs) {
+                result.push_back(&pair);
+            }
+            return result;
+        }
+
+        std::size_t hashOf(const WSEML& obj, const Traversal& traversal);
+
+        std::size_t hashOf(const Pair& pair, const Traversal& traversal) {
+            std::size_t seed = 0;
+            hash::hash_combine_hashed(seed, hashOf(pair.getKey(), traversal));
+            hash::hash_combine_hashed(seed, hashOf(pair.getData(), traversal));
+            hash::hash_combine_hashed(seed, hashOf(pair.getKeyRole(), traversal));
+            hash::hash_combine_hashed(seed, hashOf(pair.getDataRole(), traversal));
+            return seed;
+        }
+
+        /* mirrors hash_value */
+        std::size_t hashOf(const WSEML& obj, const Traversal& traversal) {
+            if (not obj.hasObject()) {
+                return 0;
+            }
+            const WSEML& objType = obj.getSemanticType();
+            std::size_t seed = 0;
+            hash::hash_combine(seed, objType);
+
+            if (obj.structureTypeInfo() == StructureType::String) {
+                std::string buffer;
+                hash::hash_combine(seed, obj.getStringView(buffer));
+                return seed;
+            }
+
+            if (objType == AATYPE) {
+                WSEML merged = merge(obj);
+                if (not merged.getInnerList().empty()) {
+                    hash::hash_combine_hashed(seed, hashOf(merged.getList().front(), traversal));
+                }
+                return seed;
+            }
+
+            std::vector<const Pair*> pairs = pairPointers(obj.getInnerList());
+            std::vector<std::size_t> hashes(pairs.size());
+            if (objType == BLOCKTYPE) {
+                forEachIndex(pairs.size(), traversal, [&](std::size_t i) { hashes[i] = hashOf(pairs[i]->getData(), traversal); });
+                std::size_t accumulation = 0;
+                for (std::size_t dataHash : hashes) {
+                    std::size_t elementSeed = 0;
+                    hash::hash_combine_hashed(elementSeed, dataHash);
+                    accumulation += elementSeed;
+                }
+                hash::hash_combine(seed, accumulation);
+                return seed;
+            }
+
+            forEachIndex(pairs.size(), traversal, [&](std::size_t i) { hashes[i] = hashOf(*pairs[i], traversal); });
+            std::size_t rangeSeed = 0;
+            for (std::size_t pairHash : hashes) {
+                hash::hash_combine_hashed(rangeSeed, pairHash);
+            }
+            hash::hash_combine(seed, rangeSeed);
+            return seed;
+        }
+
+        bool equalOf(const WSEML& first, const WSEML& second, const Traversal& traversal);
+
+        bool equalOf(const Pair& first, const Pair& second, const Traversal& traversal) {
+            return equalOf(first.getKey(), second.getKey(), traversal) and equalOf(first.getData(), second.getData(), traversal) and
+                   equalOf(first.getKeyRole(), second.getKeyRole(), traversal) and
+                   equalOf(first.getDataRole(), second.getDataRole(), traversal);
+        }
+
+        /* sorts the indices of the data of a block by their hashes */
+        std::vector<std::size_t> sortByHash(const std::vector<const Pair*>& pairs, std::vector<std::size_t>& hashes,
+                                            const Traversal& traversal) {
+            hashes.resize(pairs.size());
+            forEachIndex(pairs.size(), traversal, [&](std::size_t i) { hashes[i] = hashOf(pairs[i]->getData(), traversal); });
+            std::vector<std::size_t> order(pairs.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return hashes[a] < hashes[b]; });
+            return order;
+        }
+
+        /* mirrors compareBlocks: equal data have equal hashes, so only data within a run of equal hashes are matched */
+        bool blocksEqual(const WSEML& first, const WSEML& second, const Traversal& traversal) {
+            std::vector<const Pair*> pairs1 = pairPointers(first.getInnerList());
+            std::vector<const Pair*> pairs2 = pairPointers(second.getInnerList());
+            if (pairs1.size() != pairs2.size()) {
+                return false;
+            }
+            std::vector<std::size_t> hashes1;
+            std::vector<std::size_t> hashes2;
+            std::vector<std::size_t> order1;
+            std::vector<std::size_t> order2;
+            traversal.pool.invoke([&]() { order1 = sortByHash(pairs1, hashes1, traversal); },
+                                  [&]() { order2 = sortByHash(pairs2, hashes2, traversal); });
+            std::vector<std::size_t> runStarts;
+            for (std::size_t i = 0; i < order1.size(); i++) {
+                if (hashes1[order1[i]] != hashes2[order2[i]]) {
+                    return false;
+                }
+                if (i == 0 or hashes1[order1[i]] != hashes1[order1[i - 1]]) {
+                    runStarts.push_back(i);
+                }
+            }
+            runStarts.push_back(order1.size());
+
+            std::atomic<bool> mismatch = false;
+            forEachIndex(runStarts.size() - 1, traversal, [&](std::size_t run) {
+                if (mismatch.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                std::size_t begin = runStarts[run];
+                std::size_t end = runStarts[run + 1];
+                std::vector<bool> matched(end - begin, false);
+                for (std::size_t i = begin; i < end; i++) {
+                    bool found = false;
+                    for (std::size_t j = begin; j < end and not found; j++) {
+                        if (not matched[j - begin] and equalOf(pairs1[order1[i]]->getData(), pairs2[order2[j]]->getData(), traversal)) {
+                            matched[j - begin] = true;
+                            found = true;
+                        }
+                    }
+                    if (not found) {
+                        mismatch.store(true, std::memory_order_relaxed);
+                        return;
+                    }
+                }
+            });
+            return not mismatch.load();
+        }
+
+        /* mirrors equal */
+        bool equalOf(const WSEML& first, const WSEML& second, const Traversal& traversal) {
+            if (first.structureTypeInfo() != second.structureTypeInfo()) {
+                return false;
+            }
+            if (not first.hasObject()) {
+                return true;
+            }
+            if (first.getSemanticType() != second.getSemanticType()) {
+                return false;
+            }
+            if (first.structureTypeInfo() == StructureType::String) {
+                std::string firstBuffer;
+                std::string secondBuffer;
+                return first.getStringView(firstBuffer) == second.getStringView(secondBuffer);
+            }
+
+            if (isAssociativeArray(first) and isAssociativeArray(second)) {
+                WSEML merged1;
+                WSEML merged2;
+                traversal.pool.invoke([&]() { merged1 = merge(first); }, [&]() { merged2 = merge(second); });
+                if (merged1.getInnerList().empty() or merged2.getInnerList().empty()) {
+                    return merged1.getInnerList().empty() == merged2.getInnerList().empty();
+                }
+                return equalOf(merged1.getList().front(), merged2.getList().front(), traversal);
+            }
+
+            if (isBlock(first) and isBlock(second)) {
+                if (first.getInnerList().size() < traversal.threshold) {
+                    return compareBlocks(first, second);
+                }
+                return blocksEqual(first, second, traversal);
+            }
+
+            std::vector<const Pair*> pairs1 = pairPointers(first.getInnerList());
+            std::vector<const Pair*> pairs2 = pairPointers(second.getInnerList());
+            if (pairs1.size() != pairs2.size()) {
+                return false;
+            }
+            std::atomic<bool> mismatch = false;
+            forEachIndex(pairs1.size(), traversal, [&](std::size_t i) {
+                if (not mismatch.load(std::memory_order_relaxed) and not equalOf(*pairs1[i], *pairs2[i], traversal)) {
+                    mismatch.store(true, std::memory_order_relaxed);
+                }
+            });
+            return not mismatch.load();
+        }
+    } // namespace
+
+    bool parallelEqual(const WSEML& first, const WSEML& second, WorkStealingPool& pool, std::size_t threshold) {
+        Traversal traversal{pool, std::max<std::size_t>(threshold, 1)};
+        return pool.run([&]() { return equalOf(first, second, traversal); });
+    }
+
+    std::size_t parallelHashValue(const WSEML& obj, WorkStealingPool& pool, std::size_t threshold) {
+        Traversal traversal{pool, std::max<std::size_t>(threshold, 1)};
+        return pool.run([&]() { return hashOf(obj, traversal); });
+    }
+
+} // namespace wseml
@@ -2,6 +2,8 @@
 #include "../include/parser.hpp"
 #include <unordered_map>
 #include <fstream>
+#include <iterator>
+#include <vector>
 
 namespace wseml {
     WSEML parseHelper(const std::string& text, size_t& curPos);
@@ -62,7 +64,7 @@ namespace wseml {
     WSEML parseList(const std::string& text, size_t& curPos) {
         std::list<Pair> l;
         WSEML ListObj = WSEML(l);
-        std::list<Pair>& curList = dynamic_cast<List*>(const_cast<Object*>(ListObj.getRawObject()))->get();
+        List& curList = ListObj.getList();
         while (text[curPos] != '}' && text[curPos] != ']') {
             if (text[curPos] == ',') {
                 curPos++;
@@ -277,56 +279,130 @@ namespace wseml {
         return parseHelper(text, curPos);
     }
 
-    std::string pack(const WSEML& wseml) {
-        std::string wsemlString;
-        if (wseml.getRawObject() == nullptr)
-            return "$";
-        if (wseml.structureTypeInfo() == StructureType::String) {
-            wsemlString = dynamic_cast<ByteString*>(const_cast<Object*>(wseml.getRawObject()))->get();
-            bool isBytes = false;
+    namespace {
+        /* a step of pack: a literal, a node to write (optionally without its outer braces) or the rest of a list */
+        struct PackTask {
+            enum class Kind { Text, Node, Pairs };
+
+            Kind kind;
+            const char* text = nullptr;
+            const WSEML* node = nullptr;
+            bool strip = false;
+            std::list<Pair>::const_iterator next;
+            std::list<Pair>::const_iterator end;
+
+            static PackTask literal(const char* text) {
+                PackTask task(Kind::Text);
+                task.text = text;
+                return task;
+            }
+
+            static PackTask object(const WSEML& node, bool strip) {
+                PackTask task(Kind::Node);
+                task.node = &node;
+                task.strip = strip;
+                return task;
+            }
+
+            static PackTask pairs(std::list<Pair>::const_iterator next, std::list<Pair>::const_iterator end) {
+                PackTask task(Kind::Pairs);
+                task.next = next;
+                task.end = end;
+                return task;
+            }
+
+        private:
+            explicit PackTask(Kind taskKind) : kind(taskKind) {
+            }
+        };
+
+        std::string packString(std::string_view str) {
+            std::string wsemlString(str);
             for (char c : wsemlString) {
                 if (c < 32) {
-                    isBytes = true;
-                    break;
+                    return packBytes(wsemlString);
                 }
             }
-            if (isBytes)
-                wsemlString = packBytes(wsemlString);
             return wsemlString;
-        } else {
-            std::list<Pair> list = dynamic_cast<List*>(const_cast<Object*>(wseml.getRawObject()))->get();
-            size_t i = 0;
-            wsemlString += "{";
-            for (auto it = list.begin(); it != list.end(); ++it) {
-                i++;
-                std::string keyStr = pack(it->getKey());
-                if (keyStr != "$" && (!equal(it->getKeyRole(), NULLOBJ) || !equal(it->getKey().getSemanticType(), NULLOBJ))) {
-                    std::string keyRoleStr = pack(it->getKeyRole());
-                    std::string keyTypeStr = pack(it->getKey().getSemanticType());
-                    if (keyStr[0] == '{') {
-                        keyStr.pop_back();
-                        keyStr.erase(0, 1);
+        }
+
+        /* a key or data is written with its role and type unless it packs to "$" or has neither */
+        bool packsWithRole(const WSEML& node, const WSEML& role) {
+            StructureType structure = node.structureTypeInfo();
+            if (structure == StructureType::None) {
+                return false;
+            }
+            std::string buffer;
+            if (structure == StructureType::String and node.getStringView(buffer) == "$") {
+                return false;
+            }
+            return not equal(role, NULLOBJ) or not equal(node.getSemanticType(), NULLOBJ);
+        }
+
+        /* pushes the tasks of a key or data, in reverse */
+        void pushMember(std::vector<PackTask>& tasks, const WSEML& node, const WSEML& role) {
+            if (not packsWithRole(node, role)) {
+                tasks.push_back(PackTask::object(node, false));
+                return;
+            }
+            tasks.push_back(PackTask::object(node.getSemanticType(), false));
+            tasks.push_back(PackTask::literal("]"));
+            tasks.push_back(PackTask::object(node, true));
+            tasks.push_back(PackTask::literal("["));
+            tasks.push_back(PackTask::object(role, false));
+        }
+    } // namespace
+
+    std::string pack(const WSEML& wseml) {
+        std::string wsemlString;
+        std::vector<PackTask> tasks{PackTask::object(wseml, false)};
+        while (not tasks.empty()) {
+            PackTask task = tasks.back();
+            tasks.pop_back();
+            switch (task.kind) {
+                case PackTask::Kind::Text:
+                    wsemlString += task.text;
+                    break;
+                case PackTask::Kind::Pairs: {
+                    if (task.next == task.end) {
+                        break;
+                    }
+                    const Pair& pair = *task.next;
+                    auto following = std::next(task.next);
+                    tasks.push_back(PackTask::pairs(following, task.end));
+                    if (following != task.end) {
+                        tasks.push_back(PackTask::literal(", "));
                     }
-                    keyStr = keyRoleStr + "[" + keyStr + "]" + keyTypeStr;
+                    pushMember(tasks, pair.getData(), pair.getDataRole());
+                    tasks.push_back(PackTask::literal(":"));
+                    pushMember(tasks, pair.getKey(), pair.getKeyRole());
+                    break;
                 }
-                std::string dataStr = pack(it->getData());
-                if (dataStr != "$" && (!equal(it->getDataRole(), NULLOBJ) || !equal(it->getData().getSemanticType(), NULLOBJ))) {
-                    std::string dataRoleStr = pack(it->getDataRole());
-                    std::string dataTypeStr = pack(it->getData().getSemanticType());
-                    if (dataStr[0] == '{') {
-                        dataStr.pop_back();
-                        dataStr.erase(0, 1);
+                case PackTask::Kind::Node: {
+                    StructureType structure = task.node->structureTypeInfo();
+                    if (structure == StructureType::None) {
+                        wsemlString += "$";
+                        break;
+                    }
+                    if (structure == StructureType::String) {
+                        std::string buffer;
+                        std::string packed = packString(task.node->getStringView(buffer));
+                        if (task.strip and not packed.empty() and packed[0] == '{') {
+                            packed.pop_back();
+                            packed.erase(0, 1);
+                        }
+                        wsemlString += packed;
+                        break;
+                    }
+                    const std::list<Pair>& list = task.node->getInnerList();
+                    if (not task.strip) {
+                        wsemlString += "{";
+                        tasks.push_back(PackTask::literal("}"));
                     }
-                    dataStr = dataRoleStr + "[" + dataStr + "]" + dataTypeStr;
+                    tasks.push_back(PackTask::pairs(list.begin(), list.end()));
+                    break;
                 }
-
-                wsemlString += keyStr;
-                wsemlString += ":";
-                wsemlString += dataStr;
-                if (i != list.size())
-                    wsemlString += ", ";
             }
-            wsemlString += "}";
         }
         return wsemlString;
     }
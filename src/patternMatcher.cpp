@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <ranges>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/patternMatcher.hpp"
+
+namespace views = std::views;
+
+namespace wseml {
+
+    namespace {
+        thread_local PatternMatcher::Scratch defaultScratch;
+
+        /* runs matchChunk(begin, end, scratch) over contiguous chunks of storages and rethrows the first failure */
+        template <typename MatchChunk>
+        void forEachChunk(std::span<const WSEML> storages, ThreadPool& pool, MatchChunk matchChunk) {
+            std::size_t chunkCount = std::min(storages.size(), pool.size() * 4);
+            std::vector<std::future<void>> chunks;
+            chunks.reserve(chunkCount);
+            for (std::size_t chunk = 0; chunk < chunkCount; chunk++) {
+                std::size_t begin = storages.size() * chunk / chunkCount;
+                std::size_t end = storages.size() * (chunk + 1) / chunkCount;
+                chunks.push_back(pool.submit([&matchChunk, begin, end]() {
+                    PatternMatcher::Scratch scratch;
+                    matchChunk(begin, end, scratch);
+                }));
+            }
+
+            /* every chunk must finish before returning: they reference the caller's data */
+            std::exception_ptr error;
+            for (std::future<void>& chunk : chunks) {
+                try {
+                    chunk.get();
+                } catch (...) {
+                    if (not error) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    } // namespace
+
+    PatternMatcher::PatternMatcher(const WSEML& patternAA)
+        : output_(patternAA) {
+        const WSEML& pattern = output_.getTemplate();
+        if (not isAssociativeArray(pattern)) {
+            throw std::runtime_error("PatternMatcher: patternAA is not an Associative Array");
+        }
+
+        /* effective entries: the first association of a key in lookup order wins */
+        for (auto&& block : pattern.getInnerList() | views::reverse) {
+            for (auto&& association : block.getData().getInnerList()) {
+                const WSEML& assoc = association.getData();
+                if (isFunctionalAssociation(assoc)) {
+                    fallback_ = true;
+                }
+                if (not isKeyValueAssociation(assoc)) {
+                    continue;
+                }
+                const Pair& kvPair = assoc.getInnerList().front();
+                if (keyIndex_.try_emplace(&kvPair.getKey(), entries_.size()).second) {
+                    entries_.push_back({&kvPair.getKey(), compileNode(kvPair.getData())});
+                }
+            }
+        }
+    }
+
+    PatternMatcher::Node PatternMatcher::compileNode(const WSEML& value) {
+        Node node;
+        node.value = &value;
+        if (isPlaceholder(value)) {
+            if (value == ANPLACEHOLDER) {
+                node.kind = NodeKind::Anonymous;
+            } else {
+                node.kind = NodeKind::Slot;
+                /* slots are numbered as the holes of the output template */
+                node.slot = *output_.findHole(value);
+                slotIndex_.emplace(&value, node.slot);
+            }
+            return node;
+        }
+        if (not containsPlaceholder(value)) {
+            node.kind = NodeKind::Ground;
+            node.structural = containsAssociativeStructure(value);
+            return node;
+        }
+        if (isAssociativeArray(value) or isBlock(value)) {
+            /* placeholders inside nested AAs are unified after merging, which is not compiled */
+            fallback_ = true;
+            return node;
+        }
+        node.kind = NodeKind::Nested;
+        for (const Pair& pair : value.getInnerList()) {
+            node.children.push_back(compileNode(pair.getKey()));
+            node.children.push_back(compileNode(pair.getData()));
+            node.children.push_back(compileNode(pair.getKeyRole()));
+            node.children.push_back(compileNode(pair.getDataRole()));
+        }
+        return node;
+    }
+
+    WSEML PatternMatcher::match(const WSEML& storageAA) const {
+        return match(storageAA, defaultScratch);
+    }
+
+    WSEML PatternMatcher::match(const WSEML& storageAA, Scratch& scratch) const {
+        if (not isAssociativeArray(storageAA)) {
+            throw std::runtime_error("PatternMatcher::match: storageAA is not an Associative Array");
+        }
+        if (fallback_) {
+            return matchAndSubstitute(storageAA, output_.getTemplate());
+        }
+
+        scratch.storageValues.assign(entries_.size(), nullptr);
+        scratch.slots.assign(output_.getHoleCount(), nullptr);
+
+        std::size_t found = 0;
+        for (auto&& block : storageAA.getInnerList() | views::reverse) {
+            if (found == entries_.size()) {
+                break;
+            }
+            for (auto&& association : block.getData().getInnerList()) {
+                const WSEML& assoc = association.getData();
+                if (not isKeyValueAssociation(assoc)) {
+                    continue;
+                }
+                const Pair& kvPair = assoc.getInnerList().front();
+                auto it = keyIndex_.find(&kvPair.getKey());
+                if (it != keyIndex_.end() and scratch.storageValues[it->second] == nullptr) {
+                    scratch.storageValues[it->second] = &kvPair.getData();
+                    found++;
+                }
+            }
+        }
+
+        if (found != entries_.size()) {
+            /* keys missing from the storage may still be computed by its functional associations */
+            for (auto&& block : storageAA.getInnerList()) {
+                for (auto&& association : block.getData().getInnerList()) {
+                    const WSEML& assoc = association.getData();
+                    if (not isFunctionalAssociation(assoc)) {
+                        continue;
+                    }
+                    const WSEML& triggerType = getFuncAssocTriggerType(assoc);
+                    for (std::size_t i = 0; i < entries_.size(); i++) {
+                        if (scratch.storageValues[i] == nullptr and entries_[i].key->getSemanticType() == triggerType) {
+                            return matchAndSubstitute(storageAA, output_.getTemplate());
+                        }
+                    }
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < entries_.size(); i++) {
+            if (scratch.storageValues[i] == nullptr) {
+                continue;
+            }
+            switch (matchEntry(entries_[i].value, *scratch.storageValues[i], scratch)) {
+                case MatchResult::Success:
+                    break;
+                case MatchResult::Failure:
+                    return NULLOBJ;
+                case MatchResult::Fallback:
+                    return matchAndSubstitute(storageAA, output_.getTemplate());
+            }
+        }
+
+        return output_.instantiate(scratch.slots);
+    }
+
+    const WSEML& PatternMatcher::getPattern() const {
+        return output_.getTemplate();
+    }
+
+    std::size_t PatternMatcher::getSlotCount() const {
+        return slotIndex_.size();
+    }
+
+    bool PatternMatcher::alwaysFallsBack() const {
+        return fallback_;
+    }
+
+    PatternMatcher::MatchResult PatternMatcher::matchEntry(const Node& node, const WSEML& value, Scratch& scratch) const {
+        /* top-level values are compared by unifyBlocks, which treats two placeholders differently from unifyValues */
+        if (isPlaceholder(value)) {
+            return *node.value == value ? MatchResult::Success : MatchResult::Fallback;
+        }
+        if (node.kind == NodeKind::Anonymous) {
+            return MatchResult::Success;
+        }
+        if (node.kind == NodeKind::Slot and not value.hasObject()) {
+            const WSEML*& bound = scratch.slots[node.slot];
+            if (bound == nullptr) {
+                bound = &value;
+            }
+            return *bound == value ? MatchResult::Success : MatchResult::Failure;
+        }
+        return matchNode(node, value, scratch);
+    }
+
+    PatternMatcher::MatchResult PatternMatcher::matchNode(const Node& node, const WSEML& value, Scratch& scratch) const {
+        switch (node.kind) {
+            case NodeKind::Ground:
+                if (*node.value == value) {
+                    return MatchResult::Success;
+                }
+                if (not node.value->hasObject() or not value.hasObject()) {
+                    return MatchResult::Failure;
+                }
+                return (node.structural or containsPlaceholder(value)) ? MatchResult::Fallback : MatchResult::Failure;
+
+            case NodeKind::Anonymous:
+                return value.hasObject() ? MatchResult::Success : MatchResult::Failure;
+
+            case NodeKind::Slot: {
+                if (not value.hasObject()) {
+                    return MatchResult::Failure;
+                }
+                if (containsPlaceholder(value)) {
+                    return MatchResult::Fallback;
+                }
+                const WSEML*& bound = scratch.slots[node.slot];
+                if (bound == nullptr) {
+                    bound = &value;
+                    return MatchResult::Success;
+                }
+                if (*bound == value) {
+                    return MatchResult::Success;
+                }
+                return (containsAssociativeStructure(*bound) or containsAssociativeStructure(value)) ? MatchResult::Fallback : MatchResult::Failure;
+            }
+
+            case NodeKind::Nested: {
+                if (not value.hasObject()) {
+                    return MatchResult::Failure;
+                }
+                if (isPlaceholder(value)) {
+                    return MatchResult::Fallback;
+                }
+                if (value.structureTypeInfo() != StructureType::List or value.getSemanticType() != node.value->getSemanticType()) {
+                    return MatchResult::Failure;
+                }
+                const std::list<Pair>& pairs = value.getInnerList();
+                if (pairs.size() * 4 != node.children.size()) {
+                    return MatchResult::Failure;
+                }
+                auto child = node.children.begin();
+                for (const Pair& pair : pairs) {
+                    for (const WSEML* component : {&pair.getKey(), &pair.getData(), &pair.getKeyRole(), &pair.getDataRole()}) {
+                        const Node& childNode = *child++;
+                        if (not childNode.value->hasObject() and not component->hasObject()) {
+                            continue;
+                        }
+                        MatchResult result = matchNode(childNode, *component, scratch);
+                        if (result != MatchResult::Success) {
+                            return result;
+                        }
+                    }
+                }
+                return MatchResult::Success;
+            }
+        }
+        return MatchResult::Fallback;
+    }
+
+    std::vector<WSEML> matchAll(const WSEML& patternAA, std::span<const WSEML> storages, ThreadPool& pool) {
+        PatternMatcher matcher(patternAA);
+        std::vector<WSEML> results(storages.size());
+        forEachChunk(storages, pool, [&](std::size_t begin, std::size_t end, PatternMatcher::Scratch& scratch) {
+            for (std::size_t i = begin; i < end; i++) {
+                results[i] = matcher.match(storages[i], scratch);
+            }
+        });
+        return results;
+    }
+
+    void matchAll(const WSEML& patternAA, std::span<const WSEML> storages, ThreadPool& pool,
+                  const std::function<void(std::size_t, WSEML)>& onResult) {
+        PatternMatcher matcher(patternAA);
+        std::mutex callbackMutex;
+        forEachChunk(storages, pool, [&](std::size_t begin, std::size_t end, PatternMatcher::Scratch& scratch) {
+            for (std::size_t i = begin; i < end; i++) {
+                WSEML result = matcher.match(storages[i], scratch);
+                std::lock_guard lock(callbackMutex);
+                onResult(i, std::move(result));
+            }
+        });
+    }
+
+} // namespace wseml
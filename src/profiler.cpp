@@ -0,0 +1,191 @@
+#include <string>
+#include "../include/WSEML.hpp"
+#include "../include/parser.hpp"
+#include "../include/profiler.hpp"
+
+namespace wseml {
+
+    namespace {
+        thread_local Profiler* activeProfiler = nullptr;
+
+        std::string joinFrames(const std::vector<std::string>& frames) {
+            std::string result;
+            for (const auto& frame : frames) {
+                if (not result.empty()) {
+                    result += ';';
+                }
+                result += frame;
+            }
+            return result;
+        }
+
+        WSEML statsToWSEML(const ProfileStats& stats) {
+            WSEML result = WSEML(std::list<Pair>());
+            result.append(WSEML(std::to_string(stats.count)), WSEML("count"));
+            result.append(WSEML(std::to_string(stats.totalTime.count())), WSEML("total_ns"));
+            result.append(WSEML(std::to_string(stats.maxTime.count())), WSEML("max_ns"));
+            result.append(WSEML(std::to_string(stats.allocations)), WSEML("allocations"));
+            return result;
+        }
+    } // namespace
+
+    /* ProfileStats implementation */
+
+    void ProfileStats::record(std::chrono::nanoseconds elapsed, std::size_t allocs) {
+        count++;
+        totalTime += elapsed;
+        if (elapsed > maxTime) {
+            maxTime = elapsed;
+        }
+        allocations += allocs;
+    }
+
+    /* Profiler implementation */
+
+    const std::map<std::string, ProfileStats>& Profiler::getOpcodeStats() const {
+        return opcodes_;
+    }
+
+    const std::map<Profiler::InstructionId, ProfileStats>& Profiler::getInstructionStats() const {
+        return instructions_;
+    }
+
+    const std::map<std::string, ProfileStats>& Profiler::getStackStats() const {
+        return stacks_;
+    }
+
+    void Profiler::reset() {
+        opcodes_.clear();
+        instructions_.clear();
+        stacks_.clear();
+    }
+
+    WSEML Profiler::toWSEML() const {
+        WSEML opcodes = WSEML(std::list<Pair>());
+        for (const auto& [opcode, stats] : opcodes_) {
+            opcodes.append(statsToWSEML(stats), WSEML(opcode));
+        }
+
+        WSEML instructions = WSEML(std::list<Pair>());
+        for (const auto& [id, stats] : instructions_) {
+            WSEML entry = statsToWSEML(stats);
+            entry.appendFront(WSEML(id.second), WSEML("index"));
+            entry.appendFront(WSEML(id.first), WSEML("program"));
+            instructions.append(std::move(entry));
+        }
+
+        WSEML report = WSEML(std::list<Pair>());
+        report.append(std::move(opcodes), WSEML("opcodes"));
+        report.append(std::move(instructions), WSEML("instructions"));
+        return report;
+    }
+
+    std::string Profiler::toCollapsedStacks() const {
+        std::string result;
+        for (const auto& [stack, stats] : stacks_) {
+            result += stack;
+            result += ' ';
+            result += std::to_string(stats.totalTime.count());
+            result += '\n';
+        }
+        return result;
+    }
+
+    Profiler* getActiveProfiler() {
+        return activeProfiler;
+    }
+
+    /* ProfilerScope implementation */
+
+    ProfilerScope::ProfilerScope(Profiler& profiler)
+        : previous_(activeProfiler) {
+        activeProfiler = &profiler;
+    }
+
+    ProfilerScope::~ProfilerScope() {
+        activeProfiler = previous_;
+    }
+
+    /* ProgramFrame implementation */
+
+    ProgramFrame::ProgramFrame(const WSEML& program)
+        : profiler_(activeProfiler) {
+        if (profiler_ == nullptr) {
+            return;
+        }
+        const Pair* containingPair = program.getContainingPair();
+        std::string programKey = containingPair ? profileLabel(containingPair->getKey()) : std::string("<anonymous>");
+        profiler_->programs_.push_back(programKey);
+        profiler_->frames_.push_back(std::move(programKey));
+    }
+
+    ProgramFrame::ProgramFrame(std::string programKey)
+        : profiler_(activeProfiler) {
+        if (profiler_ == nullptr) {
+            return;
+        }
+        profiler_->programs_.push_back(programKey);
+        profiler_->frames_.push_back(std::move(programKey));
+    }
+
+    ProgramFrame::~ProgramFrame() {
+        if (profiler_ == nullptr) {
+            return;
+        }
+        profiler_->programs_.pop_back();
+        profiler_->frames_.pop_back();
+    }
+
+    /* InstructionTimer implementation */
+
+    InstructionTimer::InstructionTimer(const std::string& opcode, const WSEML& index)
+        : profiler_(activeProfiler) {
+        if (profiler_ == nullptr) {
+            return;
+        }
+        opcode_ = opcode;
+        index_ = profileLabel(index);
+        profiler_->frames_.push_back(index_ + ":" + opcode_);
+        profiler_->childTimes_.emplace_back(0);
+        startAllocations_ = getObjectAllocationCount();
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    InstructionTimer::~InstructionTimer() {
+        if (profiler_ == nullptr) {
+            return;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+        std::size_t allocations = getObjectAllocationCount() - startAllocations_;
+
+        const std::string program = profiler_->programs_.empty() ? std::string("<root>") : profiler_->programs_.back();
+        profiler_->opcodes_[opcode_].record(elapsed, allocations);
+        profiler_->instructions_[{program, index_}].record(elapsed, allocations);
+
+        std::chrono::nanoseconds selfTime = elapsed - profiler_->childTimes_.back();
+        profiler_->stacks_[joinFrames(profiler_->frames_)].record(selfTime, allocations);
+
+        profiler_->frames_.pop_back();
+        profiler_->childTimes_.pop_back();
+        if (not profiler_->childTimes_.empty()) {
+            profiler_->childTimes_.back() += elapsed;
+        }
+    }
+
+    void InstructionTimer::relabel(const std::string& opcode, const WSEML& index) {
+        if (profiler_ != nullptr) {
+            opcode_ = opcode;
+            index_ = profileLabel(index);
+            profiler_->frames_.back() = index_ + ":" + opcode_;
+        }
+    }
+
+    std::string profileLabel(const WSEML& obj) {
+        if (obj.structureTypeInfo() == StructureType::String) {
+            std::string buffer;
+            return std::string(obj.getStringView(buffer));
+        }
+        return pack(obj);
+    }
+
+} // namespace wseml
@@ -0,0 +1,125 @@
+#include <unordered_map>
+#include "../include/associativeArray.hpp"
+#include "../include/substitutionTemplate.hpp"
+
+namespace wseml {
+
+    std::unordered_map<WSEML, WSEML> parseBindings(const WSEML& bindingsAA);
+    WSEML substitutePlaceholdersRecursive(const std::unordered_map<WSEML, WSEML>& bindingsMap, const WSEML& currentTemplateObj);
+
+    SubstitutionTemplate::SubstitutionTemplate(const WSEML& templateObj)
+        : template_(std::make_unique<const WSEML>(templateObj)) {
+        root_ = compile(*template_);
+    }
+
+    SubstitutionTemplate::Node SubstitutionTemplate::compile(const WSEML& value) {
+        Node node;
+        node.value = &value;
+        if (isPlaceholder(value)) {
+            node.kind = NodeKind::Hole;
+            auto [it, inserted] = holeIndex_.try_emplace(&value, holes_.size());
+            if (inserted) {
+                holes_.push_back(&value);
+            }
+            node.hole = it->second;
+            return node;
+        }
+        if (not containsPlaceholder(value)) {
+            return node;
+        }
+        node.kind = NodeKind::List;
+        for (const Pair& pair : value.getInnerList()) {
+            node.children.push_back(compile(pair.getKey()));
+            node.children.push_back(compile(pair.getData()));
+            node.children.push_back(compile(pair.getKeyRole()));
+            node.children.push_back(compile(pair.getDataRole()));
+        }
+        return node;
+    }
+
+    WSEML SubstitutionTemplate::substitute(const WSEML& bindingsAA) const {
+        std::vector<const WSEML*> values(holes_.size(), nullptr);
+        if (not isAssociativeArray(bindingsAA)) {
+            if (bindingsAA == NULLOBJ or (bindingsAA.structureTypeInfo() == StructureType::List and bindingsAA.getInnerList().empty())) {
+                return instantiate(values);
+            }
+            throw std::runtime_error("substitutePlaceholders: bindingsAA must be an Associative Array or NULLOBJ");
+        }
+
+        /* like parseBindings: the first block is used and later entries override earlier ones */
+        const auto& blocks = getBlocksFromAA(bindingsAA);
+        if (blocks.empty()) {
+            return instantiate(values);
+        }
+        bool chained = false;
+        for (const Pair& pair : getAssociationsFromBlock(blocks.front().getData())) {
+            const WSEML& assoc = pair.getData();
+            if (not isKeyValueAssociation(assoc)) {
+                throw std::runtime_error("substitutePlaceholders: association is not a key-value association");
+            }
+            const WSEML& key = getKeyFromAssociation(assoc);
+            if (not isPlaceholder(key)) {
+                throw std::runtime_error("substitutePlaceholders: key is not a placeholder");
+            }
+            auto it = holeIndex_.find(&key);
+            if (it != holeIndex_.end()) {
+                const WSEML& value = getValueFromAssociation(assoc);
+                values[it->second] = &value;
+                chained = chained or containsPlaceholder(value);
+            }
+        }
+
+        /* bound values containing placeholders are substituted recursively, which is not compiled */
+        if (chained) {
+            return substitutePlaceholdersRecursive(parseBindings(bindingsAA), *template_);
+        }
+        return instantiate(values);
+    }
+
+    WSEML SubstitutionTemplate::instantiate(std::span<const WSEML* const> values) const {
+        if (values.size() != holes_.size()) {
+            throw std::runtime_error("SubstitutionTemplate::instantiate: expected one value per hole");
+        }
+        return build(root_, values);
+    }
+
+    WSEML SubstitutionTemplate::build(const Node& node, std::span<const WSEML* const> values) const {
+        switch (node.kind) {
+            case NodeKind::Copy:
+                return *node.value;
+            case NodeKind::Hole:
+                return values[node.hole] ? *values[node.hole] : *node.value;
+            case NodeKind::List: {
+                std::list<Pair> pairs;
+                for (auto child = node.children.begin(); child != node.children.end(); child += 4) {
+                    pairs.emplace_back(
+                        nullptr, build(child[0], values), build(child[1], values), build(child[2], values), build(child[3], values)
+                    );
+                }
+                return WSEML(std::move(pairs), node.value->getSemanticType());
+            }
+        }
+        return NULLOBJ;
+    }
+
+    std::size_t SubstitutionTemplate::getHoleCount() const {
+        return holes_.size();
+    }
+
+    std::optional<std::size_t> SubstitutionTemplate::findHole(const WSEML& placeholder) const {
+        auto it = holeIndex_.find(&placeholder);
+        if (it == holeIndex_.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    const WSEML& SubstitutionTemplate::getHole(std::size_t hole) const {
+        return *holes_.at(hole);
+    }
+
+    const WSEML& SubstitutionTemplate::getTemplate() const {
+        return *template_;
+    }
+
+} // namespace wseml
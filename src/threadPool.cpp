@@ -0,0 +1,58 @@
+#include <algorithm>
+#include "../include/threadPool.hpp"
+
+namespace wseml {
+
+    ThreadPool::ThreadPool(std::size_t threads) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        workers_.reserve(threads);
+        for (std::size_t i = 0; i < threads; i++) {
+            workers_.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        condition_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    std::size_t ThreadPool::size() const {
+        return workers_.size();
+    }
+
+    void ThreadPool::enqueue(std::function<void()> task) {
+        {
+            std::lock_guard lock(mutex_);
+            if (stopping_) {
+                throw std::runtime_error("ThreadPool::submit: the pool is shutting down");
+            }
+            tasks_.push(std::move(task));
+        }
+        condition_.notify_one();
+    }
+
+    void ThreadPool::workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mutex_);
+                condition_.wait(lock, [this]() { return stopping_ or not tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+} // namespace wseml
@@ -0,0 +1,48 @@
+#include "../include/triggerIndex.hpp"
+
+namespace wseml {
+
+    bool TriggerIndex::isCurrent(std::uint64_t modificationCount) const {
+        if (not valid_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        return frozen_.load(std::memory_order_relaxed) or syncedCount_.load(std::memory_order_relaxed) == modificationCount;
+    }
+
+    bool TriggerIndex::isUsable() const {
+        return usable_.load(std::memory_order_relaxed);
+    }
+
+    void TriggerIndex::invalidate() {
+        valid_.store(false, std::memory_order_release);
+    }
+
+    void TriggerIndex::resync(std::uint64_t modificationCount) {
+        syncedCount_.store(modificationCount, std::memory_order_relaxed);
+        valid_.store(true, std::memory_order_release);
+    }
+
+    void TriggerIndex::rebuild(Entries entries, std::uint64_t modificationCount, bool usable, bool frozen) {
+        std::lock_guard lock(rebuildMutex_);
+        if (isCurrent(modificationCount)) {
+            return;
+        }
+        if (not usable) {
+            entries.clear();
+        }
+        if (entries != entries_) {
+            valid_.store(false, std::memory_order_relaxed);
+            entries_ = std::move(entries);
+        }
+        usable_.store(usable, std::memory_order_relaxed);
+        frozen_.store(frozen, std::memory_order_relaxed);
+        syncedCount_.store(modificationCount, std::memory_order_relaxed);
+        valid_.store(true, std::memory_order_release);
+    }
+
+    const TriggerIndex::Entry* TriggerIndex::find(const WSEML& triggerType) const {
+        auto it = entries_.find(triggerType);
+        return it == entries_.end() ? nullptr : &it->second;
+    }
+
+} // namespace wseml
@@ -0,0 +1,65 @@
+#include <stdexcept>
+#include "../include/undoLog.hpp"
+
+namespace wseml {
+
+    void UndoLog::recordInsertion(List& list, std::list<Pair>::iterator position) {
+        changes_.push_back({&list, position, true, {}});
+    }
+
+    void UndoLog::recordRemoval(List& list, std::list<Pair>::iterator first, std::list<Pair>::iterator last) {
+        Change change{&list, last, false, {}};
+        list.noteModification();
+        change.removed.splice(change.removed.end(), list.pairList_, first, last);
+        changes_.push_back(std::move(change));
+    }
+
+    std::size_t UndoLog::pushMark() {
+        marks_.push_back(changes_.size());
+        return marks_.size() - 1;
+    }
+
+    void UndoLog::popMark() {
+        if (marks_.empty()) {
+            throw std::runtime_error("UndoLog::popMark: no open snapshot");
+        }
+        marks_.pop_back();
+        if (marks_.empty()) {
+            changes_.clear();
+        }
+    }
+
+    void UndoLog::rollback(WSEML& holder) {
+        if (marks_.empty()) {
+            throw std::runtime_error("UndoLog::rollback: no open snapshot");
+        }
+        List* holderList = &holder.getList();
+        while (changes_.size() > marks_.back()) {
+            Change& change = changes_.back();
+            std::list<Pair>& pairs = change.list->pairList_;
+            change.list->noteModification();
+            if (change.insertion) {
+                pairs.erase(change.position);
+            } else {
+                /* the pairs still refer to the holder they were removed from; the holders of nested Lists stay in place */
+                if (change.list == holderList) {
+                    for (Pair& pair : change.removed) {
+                        pair.setListOwner(&holder);
+                    }
+                }
+                pairs.splice(change.position, change.removed);
+            }
+            changes_.pop_back();
+        }
+        marks_.pop_back();
+    }
+
+    std::size_t UndoLog::getDepth() const {
+        return marks_.size();
+    }
+
+    std::size_t UndoLog::getChangeCount() const {
+        return changes_.size();
+    }
+
+} // namespace wseml
@@ -0,0 +1,237 @@
+#include <unordered_set>
+#include "../include/associativeArray.hpp"
+#include "../include/unificationSearch.hpp"
+
+namespace wseml {
+
+    WSEML unifyValues(const WSEML& value1, const WSEML& value2, BindingStore& bindings);
+    WSEML unifyBlocks(const WSEML& block1, const WSEML& block2, BindingStore& bindings);
+
+    namespace {
+        WSEML mergedBlock(const WSEML& aa) {
+            WSEML merged = merge(aa);
+            return merged.getInnerList().empty() ? createBlock() : merged.getInnerList().front().getData();
+        }
+    } // namespace
+
+    UnificationSearch::UnificationSearch(const WSEML& aa1, const WSEML& aa2, UnifyOptions options)
+        : aa1_(aa1),
+          aa2_(aa2),
+          options_(options),
+          deadline_(std::chrono::steady_clock::now() + options.timeout) {
+        if (not isAssociativeArray(aa1_) or not isAssociativeArray(aa2_)) {
+            throw std::runtime_error("UnificationSearch: arguments must be Associative Arrays");
+        }
+    }
+
+    bool UnificationSearch::initialize() {
+        WSEML block1 = mergedBlock(aa1_);
+        WSEML block2 = mergedBlock(aa2_);
+
+        std::unordered_set<WSEML> keys1;
+        std::unordered_set<WSEML> keys2;
+        for (const Pair& assoc : block1.getInnerList()) {
+            if (isKeyValueAssociation(assoc.getData())) {
+                keys1.insert(getKeyFromAssociation(assoc.getData()));
+            }
+        }
+        for (const Pair& assoc : block2.getInnerList()) {
+            if (isKeyValueAssociation(assoc.getData())) {
+                keys2.insert(getKeyFromAssociation(assoc.getData()));
+            }
+        }
+
+        /* split each block into the entries unified by unifyBlocks and the free entries */
+        std::vector<Entry> free1;
+        std::vector<Entry> free2;
+        auto split = [](const WSEML& block, const std::unordered_set<WSEML>& otherKeys, std::vector<Entry>& freeEntries) {
+            WSEML ground = createBlock();
+            for (const Pair& assoc : block.getInnerList()) {
+                const WSEML& assocObject = assoc.getData();
+                if (not isKeyValueAssociation(assocObject)) {
+                    addFunctionalAssociationToBlock(ground, assocObject);
+                    continue;
+                }
+                const WSEML& key = getKeyFromAssociation(assocObject);
+                if (isPlaceholder(key) and not otherKeys.contains(key)) {
+                    freeEntries.push_back({key, getValueFromAssociation(assocObject)});
+                } else {
+                    addKeyValueAssociationToBlock(ground, key, getValueFromAssociation(assocObject));
+                }
+            }
+            return ground;
+        };
+        WSEML ground1 = split(block1, keys2, free1);
+        WSEML ground2 = split(block2, keys1, free2);
+
+        WSEML base = unifyBlocks(ground1, ground2, bindings_);
+        if (base == NULLOBJ) {
+            return false;
+        }
+
+        std::unordered_set<WSEML> seen;
+        for (const Pair& assoc : base.getInnerList()) {
+            const WSEML& assocObject = assoc.getData();
+            if (isFunctionalAssociation(assocObject)) {
+                baseFunctionalAssociations_.push_back(assocObject);
+                continue;
+            }
+            const WSEML& key = getKeyFromAssociation(assocObject);
+            if (not seen.insert(key).second) {
+                continue;
+            }
+            if (not keys1.contains(key)) {
+                targets1_.push_back(base_.size());
+            } else if (not keys2.contains(key)) {
+                targets2_.push_back(base_.size());
+            }
+            base_.push_back({key, getValueFromAssociation(assocObject)});
+        }
+        baseUsed_.assign(base_.size(), 0);
+
+        for (Entry& entry : free1) {
+            free_.push_back({std::move(entry), &targets1_});
+        }
+        for (Entry& entry : free2) {
+            free_.push_back({std::move(entry), &targets2_});
+        }
+        return true;
+    }
+
+    bool UnificationSearch::tryCandidate(std::size_t freeIndex, std::size_t candidate) {
+        FreeEntry& free = free_[freeIndex];
+        if (candidate == free.targets->size()) {
+            free.target = KEEP;
+            return true;
+        }
+
+        std::size_t target = (*free.targets)[candidate];
+        if (baseUsed_[target]) {
+            return false;
+        }
+        WSEML unifiedValue = NULLOBJ;
+        if (unifyValues(free.entry.key, base_[target].key, bindings_) != NULLOBJ) {
+            unifiedValue = unifyValues(free.entry.value, base_[target].value, bindings_);
+        }
+        if (unifiedValue == NULLOBJ) {
+            bindings_.undo(frames_[freeIndex].mark);
+            return false;
+        }
+        baseUsed_[target] = 1;
+        free.target = target;
+        free.unifiedValue = std::move(unifiedValue);
+        return true;
+    }
+
+    void UnificationSearch::release(std::size_t freeIndex) {
+        FreeEntry& free = free_[freeIndex];
+        if (free.target != KEEP) {
+            baseUsed_[free.target] = 0;
+            free.target = KEEP;
+        }
+        bindings_.undo(frames_[freeIndex].mark);
+    }
+
+    std::optional<std::pair<WSEML, WSEML>> UnificationSearch::next() {
+        if (done_) {
+            return std::nullopt;
+        }
+        if (not started_) {
+            started_ = true;
+            if (not initialize()) {
+                done_ = true;
+                return std::nullopt;
+            }
+            if (free_.empty()) {
+                done_ = true;
+                return emit();
+            }
+            frames_.push_back({0, bindings_.mark()});
+        } else {
+            release(frames_.size() - 1);
+        }
+
+        while (not frames_.empty()) {
+            if (options_.timeout != std::chrono::steady_clock::duration::zero() and std::chrono::steady_clock::now() >= deadline_) {
+                timedOut_ = true;
+                done_ = true;
+                return std::nullopt;
+            }
+
+            std::size_t freeIndex = frames_.size() - 1;
+            Frame& frame = frames_.back();
+            /* candidates are the targets in order, then keeping the entry separate */
+            if (frame.candidate > free_[freeIndex].targets->size()) {
+                frames_.pop_back();
+                if (not frames_.empty()) {
+                    release(frames_.size() - 1);
+                }
+                continue;
+            }
+            if (not tryCandidate(freeIndex, frame.candidate++)) {
+                continue;
+            }
+            if (frames_.size() == free_.size()) {
+                return emit();
+            }
+            frames_.push_back({0, bindings_.mark()});
+        }
+        done_ = true;
+        return std::nullopt;
+    }
+
+    std::optional<std::pair<WSEML, WSEML>> UnificationSearch::emit() {
+        solutions_++;
+        if (options_.limit != 0 and solutions_ >= options_.limit) {
+            done_ = true;
+        }
+        return buildSolution();
+    }
+
+    std::pair<WSEML, WSEML> UnificationSearch::buildSolution() {
+        std::vector<const WSEML*> values(base_.size(), nullptr);
+        for (std::size_t i = 0; i < base_.size(); i++) {
+            values[i] = &base_[i].value;
+        }
+        for (const FreeEntry& free : free_) {
+            if (free.target != KEEP) {
+                values[free.target] = &free.unifiedValue;
+            }
+        }
+
+        WSEML block = createBlock();
+        for (std::size_t i = 0; i < base_.size(); i++) {
+            addKeyValueAssociationToBlock(block, base_[i].key, *values[i]);
+        }
+        for (const FreeEntry& free : free_) {
+            if (free.target == KEEP) {
+                addKeyValueAssociationToBlock(block, free.entry.key, free.entry.value);
+            }
+        }
+        for (const WSEML& funcAssoc : baseFunctionalAssociations_) {
+            addFunctionalAssociationToBlock(block, funcAssoc);
+        }
+
+        WSEML unified = createAssociativeArray();
+        appendBlock(unified, block);
+        return {std::move(unified), bindings_.toAA()};
+    }
+
+    bool UnificationSearch::timedOut() const {
+        return timedOut_;
+    }
+
+    std::size_t UnificationSearch::getSolutionCount() const {
+        return solutions_;
+    }
+
+    std::vector<std::pair<WSEML, WSEML>> unifyAll(const WSEML& aa1, const WSEML& aa2, UnifyOptions options) {
+        UnificationSearch search(aa1, aa2, options);
+        std::vector<std::pair<WSEML, WSEML>> result;
+        while (auto unifier = search.next()) {
+            result.push_back(std::move(*unifier));
+        }
+        return result;
+    }
+
+} // namespace wseml
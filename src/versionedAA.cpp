@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include "../include/versionedAA.hpp"
+#include "../include/associativeArray.hpp"
+
+namespace wseml {
+
+    VersionedAA::ReadGuard::ReadGuard(std::atomic<std::uint64_t>* slot, const WSEML* aa, std::uint64_t version)
+        : slot_(slot)
+        , aa_(aa)
+        , version_(version) {
+    }
+
+    VersionedAA::ReadGuard::ReadGuard(ReadGuard&& other) noexcept
+        : slot_(std::exchange(other.slot_, nullptr))
+        , aa_(other.aa_)
+        , version_(other.version_) {
+    }
+
+    VersionedAA::ReadGuard::~ReadGuard() {
+        if (slot_ != nullptr) {
+            slot_->store(0, std::memory_order_release);
+        }
+    }
+
+    const WSEML& VersionedAA::ReadGuard::get() const {
+        return *aa_;
+    }
+
+    const WSEML& VersionedAA::ReadGuard::operator*() const {
+        return *aa_;
+    }
+
+    const WSEML* VersionedAA::ReadGuard::operator->() const {
+        return aa_;
+    }
+
+    std::uint64_t VersionedAA::ReadGuard::getVersion() const {
+        return version_;
+    }
+
+    VersionedAA::VersionedAA(WSEML aa, std::size_t readerSlots)
+        : slotCount_(std::max<std::size_t>(readerSlots, 1))
+        , slots_(std::make_unique<Slot[]>(slotCount_)) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("VersionedAA: aa is not an Associative Array");
+        }
+        current_.store(new Version{std::move(aa), 0}, std::memory_order_release);
+    }
+
+    VersionedAA::~VersionedAA() {
+        delete current_.load(std::memory_order_acquire);
+    }
+
+    VersionedAA::ReadGuard VersionedAA::read() const {
+        thread_local std::size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        for (std::size_t attempt = 0;; attempt++) {
+            std::uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+            std::atomic<std::uint64_t>& slot = slots_[(hint + attempt) % slotCount_].epoch;
+            std::uint64_t expected = 0;
+            /* the announcement is ordered before loading the version, so a writer that reclaims after it either sees
+               the slot or published before the load, in which case the reader gets the new version */
+            if (slot.load(std::memory_order_relaxed) == 0 and slot.compare_exchange_strong(expected, epoch, std::memory_order_seq_cst)) {
+                hint = (hint + attempt) % slotCount_;
+                const Version* version = current_.load(std::memory_order_seq_cst);
+                return ReadGuard(&slot, &version->aa, version->number);
+            }
+            if (attempt % slotCount_ == slotCount_ - 1) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void VersionedAA::update(const std::function<void(WSEML&)>& edit) {
+        std::lock_guard lock(writerMutex_);
+        WSEML next = current_.load(std::memory_order_acquire)->aa;
+        edit(next);
+        if (not isAssociativeArray(next)) {
+            throw std::runtime_error("VersionedAA::update: the edited version is not an Associative Array");
+        }
+        publishLocked(std::move(next));
+    }
+
+    void VersionedAA::publish(WSEML aa) {
+        if (not isAssociativeArray(aa)) {
+            throw std::runtime_error("VersionedAA::publish: aa is not an Associative Array");
+        }
+        std::lock_guard lock(writerMutex_);
+        publishLocked(std::move(aa));
+    }
+
+    std::size_t VersionedAA::reclaim() {
+        std::lock_guard lock(writerMutex_);
+        return reclaimLocked();
+    }
+
+    std::size_t VersionedAA::getRetiredCount() const {
+        std::lock_guard lock(writerMutex_);
+        return retired_.size();
+    }
+
+    std::uint64_t VersionedAA::getVersion() const {
+        return current_.load(std::memory_order_acquire)->number;
+    }
+
+    void VersionedAA::publishLocked(WSEML aa) {
+        const Version* previous = current_.load(std::memory_order_relaxed);
+        auto next = std::make_unique<Version>(Version{std::move(aa), previous->number + 1});
+        current_.store(next.release(), std::memory_order_seq_cst);
+        /* readers pinning the new epoch load the version after the store above */
+        std::uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        retired_.push_back(Retired{std::unique_ptr<const Version>(previous), epoch});
+        reclaimLocked();
+    }
+
+    std::size_t VersionedAA::reclaimLocked() {
+        if (retired_.empty()) {
+            return 0;
+        }
+        std::uint64_t oldestPinned = UINT64_MAX;
+        for (std::size_t i = 0; i < slotCount_; i++) {
+            std::uint64_t pinned = slots_[i].epoch.load(std::memory_order_seq_cst);
+            if (pinned != 0 and pinned < oldestPinned) {
+                oldestPinned = pinned;
+            }
+        }
+        std::size_t before = retired_.size();
+        std::erase_if(retired_, [&](const Retired& retired) { return retired.epoch <= oldestPinned; });
+        return before - retired_.size();
+    }
+
+} // namespace wseml
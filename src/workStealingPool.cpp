@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <stdexcept>
+#include "../include/workStealingPool.hpp"
+
+namespace wseml {
+
+    namespace {
+        struct CurrentWorker {
+            const WorkStealingPool* pool = nullptr;
+            std::size_t index = 0;
+        };
+
+        thread_local CurrentWorker currentWorker;
+    } // namespace
+
+    WorkStealingPool::WorkStealingPool(std::size_t threads) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        workers_.reserve(threads);
+        for (std::size_t i = 0; i < threads; i++) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+        threads_.reserve(threads);
+        for (std::size_t i = 0; i < threads; i++) {
+            threads_.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        condition_.notify_all();
+        for (std::thread& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    bool WorkStealingPool::isWorkerThread() const {
+        return currentWorker.pool == this;
+    }
+
+    std::size_t WorkStealingPool::size() const {
+        return workers_.size();
+    }
+
+    std::size_t WorkStealingPool::getStealCount() const {
+        return steals_.load(std::memory_order_relaxed);
+    }
+
+    void WorkStealingPool::runTask(Task&& task) {
+        task.injected = true;
+        {
+            std::lock_guard lock(mutex_);
+            if (stopping_) {
+                throw std::runtime_error("WorkStealingPool::run: the pool is shutting down");
+            }
+            injected_.push_back(&task);
+            queued_.fetch_add(1);
+        }
+        condition_.notify_one();
+        {
+            std::unique_lock lock(mutex_);
+            finished_.wait(lock, [&task]() { return task.done.load(std::memory_order_acquire); });
+        }
+        if (task.error) {
+            std::rethrow_exception(task.error);
+        }
+    }
+
+    void WorkStealingPool::fork(Task& task) {
+        Worker& worker = *workers_[currentWorker.index];
+        {
+            std::lock_guard lock(worker.mutex);
+            worker.tasks.push_back(&task);
+        }
+        queued_.fetch_add(1);
+        notify();
+    }
+
+    void WorkStealingPool::join(Task& task) {
+        std::size_t self = currentWorker.index;
+        Worker& worker = *workers_[self];
+        {
+            std::unique_lock lock(worker.mutex);
+            /* forks are joined in reverse order, so a task nobody stole is still at the back */
+            if (not worker.tasks.empty() and worker.tasks.back() == &task) {
+                worker.tasks.pop_back();
+                queued_.fetch_sub(1);
+                lock.unlock();
+                execute(task);
+                return;
+            }
+        }
+        while (not task.done.load(std::memory_order_acquire)) {
+            if (Task* other = steal(self)) {
+                execute(*other);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void WorkStealingPool::execute(Task& task) {
+        try {
+            task.run(task.context);
+        } catch (...) {
+            task.error = std::current_exception();
+        }
+        if (not task.injected) {
+            task.done.store(true, std::memory_order_release);
+            return;
+        }
+        /* the waiter destroys the task as soon as it sees it done, so it is not touched after the store */
+        {
+            std::lock_guard lock(mutex_);
+            task.done.store(true, std::memory_order_release);
+        }
+        finished_.notify_all();
+    }
+
+    WorkStealingPool::Task* WorkStealingPool::popOwn(std::size_t self) {
+        Worker& worker = *workers_[self];
+        std::lock_guard lock(worker.mutex);
+        if (worker.tasks.empty()) {
+            return nullptr;
+        }
+        Task* task = worker.tasks.back();
+        worker.tasks.pop_back();
+        queued_.fetch_sub(1);
+        return task;
+    }
+
+    WorkStealingPool::Task* WorkStealingPool::steal(std::size_t self) {
+        for (std::size_t offset = 1; offset < workers_.size(); offset++) {
+            Worker& victim = *workers_[(self + offset) % workers_.size()];
+            std::lock_guard lock(victim.mutex);
+            if (not victim.tasks.empty()) {
+                Task* task = victim.tasks.front();
+                victim.tasks.pop_front();
+                queued_.fetch_sub(1);
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        std::lock_guard lock(mutex_);
+        if (injected_.empty()) {
+            return nullptr;
+        }
+        Task* task = injected_.front();
+        injected_.pop_front();
+        queued_.fetch_sub(1);
+        return task;
+    }
+
+    void WorkStealingPool::notify() {
+        /* pairs with the increment of sleepers_ in workerLoop: either the sleeper sees queued_ or we see it */
+        if (sleepers_.load() != 0) {
+            {
+                std::lock_guard lock(mutex_);
+            }
+            condition_.notify_one();
+        }
+    }
+
+    void WorkStealingPool::workerLoop(std::size_t self) {
+        currentWorker = {this, self};
+        while (true) {
+            Task* task = popOwn(self);
+            if (task == nullptr) {
+                task = steal(self);
+            }
+            if (task != nullptr) {
+                execute(*task);
+                continue;
+            }
+            std::unique_lock lock(mutex_);
+            sleepers_.fetch_add(1);
+            condition_.wait(lock, [this]() { return stopping_ or queued_.load() != 0; });
+            sleepers_.fetch_sub(1);
+            if (stopping_ and queued_.load() == 0) {
+                return;
+            }
+        }
+    }
+
+} // namespace wseml
@@ -1,11 +1,15 @@
 #include <gtest/gtest.h>
 #include "../include/WSEML.hpp"
 #include "../include/associativeArray.hpp"
+#include "../include/triggerIndex.hpp"
+#include "../include/workStealingPool.hpp"
+#include <algorithm>
 #include <string>
 #include <initializer_list>
 #include <utility>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace wseml {
     const std::string TEST_LIB_PATH = "libtest_func.so";
@@ -999,6 +1003,47 @@ namespace wseml {
         ASSERT_TRUE(fas.contains(funcAssoc2));
     }
 
+    TEST_F(AssociativeArrayTest, ParallelMergeMatchesSequential) {
+        WSEML funcAssoc = createFunctionalAssociation(testType1, createFunctionReference(TEST_LIB_PATH, "add_prefix"));
+        WSEML aa = createAssociativeArray();
+        for (int block = 0; block < 8; block++) {
+            appendBlock(aa, createBlock());
+            for (int i = 0; i < 600; i++) {
+                WSEML key = S("key" + std::to_string((block * 7 + i * 3) % 1000));
+                addKeyValueAssociationToAA(aa, key, S("value" + std::to_string(block)));
+                if (i % 200 == 0) {
+                    addFunctionalAssociationToAA(aa, funcAssoc);
+                }
+            }
+        }
+        WSEML nestedKey = createAssociativeArray();
+        addKeyValueAssociationToAA(nestedKey, S("a"), S("b"));
+        addKeyValueAssociationToAA(aa, nestedKey, S("nested"));
+
+        WSEML sequential = merge(aa);
+        WorkStealingPool pool(3);
+        WSEML parallel = merge(aa, pool);
+        ASSERT_EQ(getBlocksFromAA(parallel).size(), 1);
+        const std::list<Pair>& expected = getAssociationsFromBlock(getBlocksFromAA(sequential).front().getData());
+        const std::list<Pair>& actual = getAssociationsFromBlock(getBlocksFromAA(parallel).front().getData());
+        ASSERT_EQ(actual.size(), expected.size());
+        ASSERT_TRUE(std::equal(actual.begin(), actual.end(), expected.begin()));
+        ASSERT_EQ(*findValuePtrInAA(parallel, nestedKey), S("nested"));
+        ASSERT_EQ(findFunctionalAssociationInAA(parallel, testType1) != nullptr, true);
+
+        /* the chunks are linked to the merged Block, which continues their keys */
+        WSEML& parallelBlock = parallel.getList().back();
+        std::size_t merged = actual.size();
+        ASSERT_EQ(actual.back().getKey(), List::keyAt(merged - 1));
+        ASSERT_TRUE(std::ranges::all_of(actual, [&](const Pair& pair) { return pair.getListOwner() == &parallelBlock; }));
+        ASSERT_EQ(parallelBlock.append(S("next")), List::keyAt(merged));
+
+        WSEML empty = createAssociativeArray();
+        appendBlock(empty, createBlock());
+        ASSERT_TRUE(getBlocksFromAA(merge(empty, pool)).empty());
+        ASSERT_TRUE(getBlocksFromAA(merge(empty)).empty());
+    }
+
     TEST_F(AssociativeArrayTest, FindValueViaFunctionalAssociation) {
         WSEML funcRefPrefix = createFunctionReference(TEST_LIB_PATH, "add_prefix");
         WSEML funcAssocPrefix = createFunctionalAssociation(testType1, funcRefPrefix);
@@ -1079,6 +1124,62 @@ namespace wseml {
         ASSERT_EQ(findValueInAA(aa, key), NULLOBJ) << "Should return NULLOBJ if function returns it";
     }
 
+    TEST_F(AssociativeArrayTest, ReadOnlyAccessorsDoNotCopy) {
+        WSEML aa = createAAFromBlocks({{{"a", "1"}}, {{"b", "2"}}});
+        const WSEML& assoc = getAssociationsFromBlock(getBlocksFromAA(aa).back().getData()).front().getData();
+
+        std::size_t allocations = getObjectAllocationCount();
+        const WSEML& key = getKeyFromAssociation(assoc);
+        const WSEML& value = getValueFromAssociation(assoc);
+        const WSEML* found = findValuePtrInAA(aa, key);
+        EXPECT_EQ(getObjectAllocationCount(), allocations);
+
+        EXPECT_EQ(key, S("b"));
+        EXPECT_EQ(found, &value);
+        EXPECT_EQ(*findValuePtrInAA(aa, S("a")), S("1"));
+        EXPECT_EQ(findValuePtrInAA(aa, S("missing")), nullptr);
+        EXPECT_THROW(findValuePtrInAA(S("not aa"), key), std::runtime_error);
+    }
+
+    TEST_F(AssociativeArrayTest, FindValuesMatchesFindValue) {
+        WSEML funcRefPrefix = createFunctionReference(TEST_LIB_PATH, "add_prefix");
+        WSEML aa = createAAFromBlocks({{{"a", "1"}, {"b", "2"}}, {{"b", "3"}, {"c", "4"}}});
+        addFunctionalAssociationToAA(aa, createFunctionalAssociation(testType1, funcRefPrefix));
+
+        std::vector<WSEML> keys = {S("a"), S("b"), S("c"), S("missing"), WSEML("typed", testType1), S("b")};
+        for (size_t threads : {1, 2, 4, 16}) {
+            std::vector<WSEML> values = findValuesInAA(aa, keys, threads);
+            ASSERT_EQ(values.size(), keys.size());
+            for (size_t i = 0; i < keys.size(); i++) {
+                EXPECT_EQ(values[i], findValueInAA(aa, keys[i])) << "key #" << i << ", threads " << threads;
+            }
+        }
+        EXPECT_EQ(findValuesInAA(aa, keys)[1], S("3"));
+        EXPECT_EQ(findValuesInAA(aa, keys)[4], S("PREFIX_typed"));
+
+        std::vector<WSEML> tooSmall(2);
+        EXPECT_THROW(findValuesInAA(aa, keys, tooSmall), std::runtime_error);
+        EXPECT_THROW(findValuesInAA(S("not aa"), keys), std::runtime_error);
+        EXPECT_TRUE(findValuesInAA(aa, std::span<const WSEML>()).empty());
+    }
+
+    TEST_F(AssociativeArrayTest, FindValueRefsPointIntoAA) {
+        WSEML funcRefPrefix = createFunctionReference(TEST_LIB_PATH, "add_prefix");
+        WSEML aa = createAAFromBlocks({{{"a", "1"}}, {{"a", "2"}, {"b", "3"}}});
+        addFunctionalAssociationToAA(aa, createFunctionalAssociation(testType1, funcRefPrefix));
+
+        std::vector<WSEML> keys = {S("a"), S("b"), S("missing"), WSEML("typed", testType1)};
+        std::vector<const WSEML*> refs = findValueRefsInAA(aa, keys);
+        ASSERT_EQ(refs.size(), 4);
+        ASSERT_NE(refs[0], nullptr);
+        EXPECT_EQ(*refs[0], S("2"));
+        const WSEML& storedAssoc = getAssociationsFromBlock(getBlocksFromAA(aa).back().getData()).front().getData();
+        EXPECT_EQ(refs[0], &storedAssoc.getInnerList().front().getData());
+        EXPECT_EQ(*refs[1], S("3"));
+        EXPECT_EQ(refs[2], nullptr);
+        EXPECT_EQ(refs[3], nullptr);
+    }
+
     // // --- Unification Tests ---
 
     TEST_F(AssociativeArrayTest, UnifyKVMatchesFAResultSuccess) {
@@ -1238,4 +1339,376 @@ namespace wseml {
         checkUnifyResult(unify(aa1, aa2), expectedAA, expectedPlaceholders);
     }
 
+    TEST_F(AssociativeArrayTest, ListFindMissDoesNotExposeNullObj) {
+        WSEML list = WSEML(std::list<Pair>());
+        list.append(S("1"), S("a"));
+        list.getList().find(S("missing")) = S("overwritten");
+        ASSERT_EQ(NULLOBJ, WSEML());
+        ASSERT_EQ(list.getList().find(S("missing")), NULLOBJ);
+    }
+
+    TEST_F(AssociativeArrayTest, KeyFilterSkipsBlocksWithoutTheKey) {
+        WSEML aa = createAssociativeArray();
+        for (int blockIndex = 0; blockIndex < 4; blockIndex++) {
+            WSEML block = createBlock();
+            for (int i = 0; i < 8; i++) {
+                addKeyValueAssociationToBlock(block, S("k" + std::to_string(blockIndex) + "_" + std::to_string(i)), S(std::to_string(i)));
+            }
+            enableKeyFilter(block, 8);
+            appendBlock(aa, block);
+        }
+        WSEML& first = aa.getList().front();
+        ASSERT_TRUE(hasKeyFilter(first));
+
+        for (int i = 0; i < 100; i++) {
+            ASSERT_EQ(findValuePtrInAA(aa, S("missing" + std::to_string(i))), nullptr);
+        }
+        KeyFilterStats stats = getKeyFilterStats(first);
+        EXPECT_EQ(stats.queries, 100);
+        EXPECT_EQ(stats.negatives + stats.falsePositives, 100);
+        EXPECT_GT(stats.negatives, 90);
+        EXPECT_EQ(stats.rebuilds, 1);
+
+        ASSERT_NE(findValuePtrInAA(aa, S("k0_3")), nullptr);
+        EXPECT_EQ(*findValuePtrInAA(aa, S("k0_3")), S("3"));
+
+        disableKeyFilter(first);
+        EXPECT_FALSE(hasKeyFilter(first));
+        EXPECT_EQ(getKeyFilterStats(first).queries, 0);
+        EXPECT_THROW(enableKeyFilter(aa), std::runtime_error);
+    }
+
+    TEST_F(AssociativeArrayTest, KeyFilterFollowsBlockChanges) {
+        WSEML aa = createAssociativeArray();
+        WSEML block = createBlock();
+        enableKeyFilter(block, 2);
+        appendBlock(aa, block);
+        WSEML& stored = aa.getList().back();
+
+        for (int i = 0; i < 10; i++) {
+            addKeyValueAssociationToAA(aa, S("k" + std::to_string(i)), S(std::to_string(i)));
+            ASSERT_NE(findValuePtrInAA(aa, S("k" + std::to_string(i))), nullptr);
+        }
+        ASSERT_TRUE(removeKeyValueAssociationFromBlock(stored, S("k4")));
+        EXPECT_EQ(findValuePtrInAA(aa, S("k4")), nullptr);
+        addKeyValueAssociationToBlock(stored, S("k4"), S("again"));
+        EXPECT_EQ(*findValuePtrInAA(aa, S("k4")), S("again"));
+
+        /* changes bypassing the AA functions go through the mutable pairs of the block */
+        stored.getList().get().pop_front();
+        stored.append(createKeyValueAssociation(S("raw1"), S("v")));
+        stored.append(createKeyValueAssociation(S("raw2"), S("v")));
+        EXPECT_NE(findValuePtrInAA(aa, S("raw2")), nullptr);
+
+        WSEML copy = aa;
+        EXPECT_TRUE(hasKeyFilter(copy.getList().back()));
+        EXPECT_EQ(*findValuePtrInAA(copy, S("k9")), S("9"));
+        EXPECT_EQ(copy, aa);
+    }
+
+    TEST_F(AssociativeArrayTest, KeyFilterFollowsInPlaceEdits) {
+        WSEML aa = createAssociativeArray();
+        WSEML block = createBlockFromPairs({{"a", "1"}, {"b", "2"}});
+        enableKeyFilter(block, 2);
+        appendBlock(aa, block);
+        WSEML& stored = aa.getList().back();
+        ASSERT_EQ(*findValuePtrInAA(aa, S("a")), S("1"));
+        ASSERT_EQ(findValuePtrInAA(aa, S("c")), nullptr);
+
+        /* the number of associations stays the same */
+        stored.getList().begin()->getData() = createKeyValueAssociation(S("c"), S("3"));
+        EXPECT_EQ(*findValuePtrInAA(aa, S("c")), S("3"));
+        EXPECT_EQ(findValuePtrInAA(aa, S("a")), nullptr);
+
+        /* a key replaced within its association */
+        WSEML& association = stored.getList().back();
+        association.getList().begin()->getKey() = S("d");
+        EXPECT_EQ(*findValuePtrInAA(aa, S("d")), S("2"));
+        EXPECT_EQ(findValuePtrInAA(aa, S("b")), nullptr);
+
+        /* the edits through the List accessors keep the filter in use */
+        KeyFilterStats stats = getKeyFilterStats(stored);
+        EXPECT_EQ(stats.rebuilds, 3);
+        EXPECT_EQ(stats.queries, 6);
+    }
+
+    TEST_F(AssociativeArrayTest, KeyFilterFollowsEditsThroughRetainedReferences) {
+        WSEML aa = createAssociativeArray();
+        WSEML block = createBlockFromPairs({{"k0", "0"}, {"k1", "1"}});
+        enableKeyFilter(block, 2);
+        appendBlock(aa, block);
+        WSEML& stored = aa.getList().back();
+
+        /* a reference to a key retained from before the filter was built */
+        std::string& retained = stored.getList().front().getList().begin()->getKey().getInnerString();
+        ASSERT_EQ(*findValuePtrInAA(aa, S("k1")), S("1"));
+        retained = "zz";
+        EXPECT_EQ(*findValuePtrInAA(aa, S("zz")), S("0"));
+        EXPECT_EQ(findValuePtrInAA(aa, S("k0")), nullptr);
+
+        /* a reference taken after the filter was built */
+        WSEML other = createBlockFromPairs({{"m0", "0"}});
+        enableKeyFilter(other, 1);
+        appendBlock(aa, other);
+        WSEML& top = aa.getList().back();
+        ASSERT_EQ(*findValuePtrInAA(aa, S("m0")), S("0"));
+        ASSERT_EQ(getKeyFilterStats(top).rebuilds, 1);
+        top.getList().front().getList().begin()->getKey().getInnerString() = "mm";
+        EXPECT_EQ(*findValuePtrInAA(aa, S("mm")), S("0"));
+        EXPECT_EQ(findValuePtrInAA(aa, S("m0")), nullptr);
+        EXPECT_EQ(*findValuePtrInAA(aa, S("zz")), S("0"));
+    }
+
+    TEST_F(AssociativeArrayTest, FindFunctionalAssociationFollowsLookupOrder) {
+        WSEML prefix = createFunctionalAssociation(testType1, createFunctionReference(TEST_LIB_PATH, "add_prefix"));
+        WSEML append = createFunctionalAssociation(testType1, createFunctionReference(TEST_LIB_PATH, "list_append_value"));
+        WSEML other = createFunctionalAssociation(testType2, createFunctionReference(TEST_LIB_PATH, "add_prefix"));
+
+        WSEML bottom = createBlock();
+        addFunctionalAssociationToBlock(bottom, prefix);
+        addFunctionalAssociationToBlock(bottom, other);
+        WSEML top = createBlock();
+        addFunctionalAssociationToBlock(top, append);
+        addFunctionalAssociationToBlock(top, prefix);
+
+        WSEML aa = createAssociativeArray();
+        appendBlock(aa, bottom);
+        ASSERT_EQ(*findFunctionalAssociationInAA(aa, testType1), prefix);
+        appendBlock(aa, top);
+        ASSERT_EQ(*findFunctionalAssociationInAA(aa, testType1), append);
+        ASSERT_EQ(*findFunctionalAssociationInAA(aa, testType2), other);
+        ASSERT_EQ(findFunctionalAssociationInAA(aa, S("unknown")), nullptr);
+
+        popBlock(aa);
+        ASSERT_EQ(*findFunctionalAssociationInAA(aa, testType1), prefix);
+        ASSERT_THROW(findFunctionalAssociationInAA(S("not an aa"), testType1), std::runtime_error);
+    }
+
+    TEST_F(AssociativeArrayTest, TriggerIndexFollowsChangesOfBlocksInAA) {
+        WSEML prefix = createFunctionalAssociation(testType1, createFunctionReference(TEST_LIB_PATH, "add_prefix"));
+        WSEML aa = createAssociativeArray();
+        enableTriggerIndex(aa);
+        appendBlock(aa, createBlock());
+        ASSERT_EQ(findFunctionalAssociationInAA(aa, testType1), nullptr);
+
+        WSEML& block = aa.getList().back();
+        addFunctionalAssociationToBlock(block, prefix);
+        ASSERT_EQ(*findFunctionalAssociationInAA(aa, testType1), prefix);
+        ASSERT_EQ(findValueInAA(aa, WSEML("value", testType1)), callFunctionalAssociation(prefix, WSEML("value", testType1)));
+
+        WSEML copy = aa;
+        removeFunctionalAssociationFromBlock(block, prefix);
+        ASSERT_EQ(findFunctionalAssociationInAA(aa, testType1), nullptr);
+        ASSERT_EQ(findValueInAA(aa, WSEML("value", testType1)), NULLOBJ);
+
+        /* the copy indexes its own associations */
+        ASSERT_TRUE(hasTriggerIndex(copy));
+        const WSEML* copied = findFunctionalAssociationInAA(copy, testType1);
+        ASSERT_NE(copied, nullptr);
+        ASSERT_EQ(copied->getContainingList()->getContainingList(), &copy);
+    }
+
+    TEST_F(AssociativeArrayTest, TriggerIndexFollowsRawEdits) {
+        WSEML prefix = createFunctionalAssociation(testType1, createFunctionReference(TEST_LIB_PATH, "add_prefix"));
+        WSEML aa = createAssociativeArray();
+        ASSERT_FALSE(hasTriggerIndex(aa));
+        enableTriggerIndex(aa);
+        ASSERT_TRUE(hasTriggerIndex(aa));
+        addFunctionalAssociationToAA(aa, prefix);
+        ASSERT_EQ(*findFunctionalAssociationInAA(aa, testType1), prefix);
+
+        /* key-value associations added or removed through the AA functions keep the index */
+        WSEML& block = aa.getList().back();
+        addKeyValueAssociationToAA(aa, S("k"), S("v"));
+        EXPECT_TRUE(removeKeyValueAssociationFromBlock(block, S("k")));
+        EXPECT_TRUE(aa.getList().getTriggerIndex()->isCurrent(getModificationCount()));
+        EXPECT_EQ(*findFunctionalAssociationInAA(aa, testType1), prefix);
+
+        /* the indexed association is erased through the List of its block */
+        WSEML key = block.getList().begin()->getKey();
+        ASSERT_TRUE(block.getList().erase(key));
+        EXPECT_EQ(findFunctionalAssociationInAA(aa, testType1), nullptr);
+        block.append(prefix);
+        EXPECT_EQ(*findFunctionalAssociationInAA(aa, testType1), prefix);
+
+        /* the indexed association is destroyed through the mutable pairs of its block */
+        block.getInnerList().clear();
+        EXPECT_EQ(findFunctionalAssociationInAA(aa, testType1), nullptr);
+        block.append(prefix);
+        EXPECT_EQ(*findFunctionalAssociationInAA(aa, testType1), prefix);
+
+        disableTriggerIndex(aa);
+        EXPECT_FALSE(hasTriggerIndex(aa));
+        EXPECT_EQ(*findFunctionalAssociationInAA(aa, testType1), prefix);
+        EXPECT_THROW(enableTriggerIndex(block), std::runtime_error);
+    }
+
+    TEST_F(AssociativeArrayTest, TriggerIndexFollowsEditsThroughRetainedReferences) {
+        WSEML prefix = createFunctionalAssociation(testType1, createFunctionReference(TEST_LIB_PATH, "add_prefix"));
+        WSEML aa = createAssociativeArray();
+        enableTriggerIndex(aa);
+        addFunctionalAssociationToAA(aa, prefix);
+        addFunctionalAssociationToAA(aa, createFunctionalAssociation(testType3, createFunctionReference(TEST_LIB_PATH, "add_prefix")));
+        WSEML& block = aa.getList().back();
+
+        /* a reference to a trigger type retained from before the index was built */
+        std::string& retained = block.getList().front().getList().find("trigger_type").getInnerString();
+        ASSERT_NE(findFunctionalAssociationInAA(aa, testType1), nullptr);
+        retained = "TYPE2";
+        EXPECT_EQ(findFunctionalAssociationInAA(aa, testType1), nullptr);
+        EXPECT_EQ(findFunctionalAssociationInAA(aa, testType2), &block.getList().front());
+
+        /* a reference taken after the index was built */
+        popBlock(aa);
+        addFunctionalAssociationToAA(aa, prefix);
+        WSEML& rebuilt = aa.getList().back();
+        ASSERT_EQ(findFunctionalAssociationInAA(aa, testType1), &rebuilt.getList().front());
+        ASSERT_TRUE(aa.getList().getTriggerIndex()->isUsable());
+        rebuilt.getList().front().getList().find("trigger_type").getInnerString() = "TYPE2";
+        EXPECT_EQ(findFunctionalAssociationInAA(aa, testType1), nullptr);
+        EXPECT_EQ(findFunctionalAssociationInAA(aa, testType2), &rebuilt.getList().front());
+    }
+
+    TEST_F(AssociativeArrayTest, CompactAAPreservesLookupsAndPops) {
+        WSEML prefix = createFunctionalAssociation(testType1, createFunctionReference(TEST_LIB_PATH, "add_prefix"));
+        WSEML aa = createAAFromBlocks({{{"a", "1"}, {"b", "1"}}, {{"a", "2"}, {"c", "2"}}, {{"a", "3"}}, {{"b", "top"}}});
+        addFunctionalAssociationToBlock(aa.getList().get().front().getData(), prefix);
+        WSEML original = aa;
+
+        CompactionStats stats = compactAA(aa, 1);
+        ASSERT_EQ(stats.compactions, 1);
+        ASSERT_EQ(stats.blocksRemoved, 2);
+        ASSERT_EQ(stats.associationsRemoved, 2);
+        ASSERT_GT(stats.bytesReclaimed, 0);
+        ASSERT_EQ(getBlocksFromAA(aa).size(), 2);
+        ASSERT_EQ(getShadowingRatio(aa, 1), 0.0);
+        ASSERT_EQ(aa, original);
+        ASSERT_EQ(*findValuePtrInAA(aa, S("a")), S("3"));
+        ASSERT_EQ(*findValuePtrInAA(aa, S("c")), S("2"));
+        ASSERT_EQ(*findFunctionalAssociationInAA(aa, testType1), prefix);
+
+        /* the kept top block pops as before, uncovering the compacted associations */
+        popBlock(aa);
+        popBlock(original);
+        ASSERT_EQ(*findValuePtrInAA(aa, S("b")), S("1"));
+        ASSERT_EQ(aa, original);
+    }
+
+    TEST_F(AssociativeArrayTest, CompactBlocksLeavesOtherBlocksAlone) {
+        WSEML aa = createAAFromBlocks({{{"a", "1"}}, {{"a", "2"}}, {{"a", "3"}}, {{"a", "4"}}});
+        ASSERT_DOUBLE_EQ(getShadowingRatio(aa, 0), 0.75);
+
+        CompactionStats stats = compactBlocks(aa, 1, 3);
+        ASSERT_EQ(stats.associationsRemoved, 1);
+        ASSERT_EQ(getBlocksFromAA(aa).size(), 3);
+        popBlock(aa);
+        ASSERT_EQ(*findValuePtrInAA(aa, S("a")), S("3"));
+        popBlock(aa);
+        ASSERT_EQ(*findValuePtrInAA(aa, S("a")), S("1"));
+
+        ASSERT_EQ(compactBlocks(aa, 0, 1).compactions, 0);
+        ASSERT_THROW(compactBlocks(aa, 0, 2), std::runtime_error);
+        WSEML notAA = S("not an aa");
+        ASSERT_THROW(compactAA(notAA), std::runtime_error);
+    }
+
+    TEST_F(AssociativeArrayTest, AutoCompactionFollowsShadowingRatio) {
+        WSEML aa = createAssociativeArray();
+        enableAutoCompaction(aa, {.shadowRatio = 0.5, .minBlocks = 4, .keepTop = 1});
+        ASSERT_TRUE(hasAutoCompaction(aa));
+        for (int i = 0; i < 4; i++) {
+            WSEML block = createBlock();
+            addKeyValueAssociationToBlock(block, S("k"), S(std::to_string(i)));
+            enableKeyFilter(block, 4);
+            appendBlock(aa, block);
+        }
+        ASSERT_EQ(getBlocksFromAA(aa).size(), 2);
+        ASSERT_TRUE(hasKeyFilter(getBlocksFromAA(aa).front().getData()));
+        ASSERT_EQ(*findValuePtrInAA(aa, S("k")), S("3"));
+        popBlock(aa);
+        ASSERT_EQ(*findValuePtrInAA(aa, S("k")), S("2"));
+
+        CompactionStats stats = getAutoCompactionStats(aa);
+        ASSERT_EQ(stats.compactions, 1);
+        ASSERT_EQ(stats.associationsRemoved, 2);
+
+        WSEML copy = aa;
+        ASSERT_TRUE(hasAutoCompaction(copy));
+        disableAutoCompaction(aa);
+        ASSERT_FALSE(hasAutoCompaction(aa));
+        ASSERT_THROW(getAutoCompactionStats(aa), std::runtime_error);
+        ASSERT_THROW(enableAutoCompaction(aa, {.shadowRatio = 2.0}), std::runtime_error);
+    }
+
+    TEST_F(AssociativeArrayTest, RollbackToSnapshotRevertsAllChanges) {
+        WSEML prefix = createFunctionalAssociation(testType1, createFunctionReference(TEST_LIB_PATH, "add_prefix"));
+        WSEML aa = createAAFromBlocks({{{"a", "1"}, {"b", "1"}}, {{"a", "2"}}, {{"c", "3"}}});
+        WSEML original = aa;
+        const WSEML* lowerValue = findValuePtrInAA(aa, S("b"));
+
+        AASnapshot snapshot = takeSnapshot(aa);
+        ASSERT_EQ(getOpenSnapshotCount(aa), 1);
+        WSEML& bottom = aa.getList().get().front().getData();
+        ASSERT_TRUE(removeKeyValueAssociationFromBlock(bottom, S("b")));
+        addFunctionalAssociationToBlock(bottom, prefix);
+        addKeyValueAssociationToAA(aa, S("d"), S("4"));
+        popBlock(aa);
+        appendBlock(aa, createBlockFromPairs({{"a", "5"}}));
+        compactAA(aa, 0);
+        ASSERT_EQ(findValuePtrInAA(aa, S("b")), nullptr);
+        ASSERT_EQ(*findValuePtrInAA(aa, S("a")), S("5"));
+        ASSERT_NE(findFunctionalAssociationInAA(aa, testType1), nullptr);
+
+        rollbackToSnapshot(aa, snapshot);
+        ASSERT_EQ(getOpenSnapshotCount(aa), 0);
+        ASSERT_EQ(getBlocksFromAA(aa).size(), 3);
+        ASSERT_EQ(aa, original);
+        ASSERT_EQ(findValuePtrInAA(aa, S("b")), lowerValue);
+        ASSERT_EQ(*findValuePtrInAA(aa, S("a")), S("2"));
+        ASSERT_EQ(findValuePtrInAA(aa, S("d")), nullptr);
+        ASSERT_EQ(findFunctionalAssociationInAA(aa, testType1), nullptr);
+    }
+
+    TEST_F(AssociativeArrayTest, RollbackAfterMoveLinksRestoredBlocksToTheNewHolder) {
+        WSEML aa = createAAFromBlocks({{{"a", "1"}}, {{"b", "2"}}});
+        AASnapshot snapshot = takeSnapshot(aa);
+        popBlock(aa);
+        WSEML moved = std::move(aa);
+        rollbackToSnapshot(moved, snapshot);
+
+        WSEML& restored = moved.getList().back();
+        ASSERT_EQ(restored.getContainingList(), &moved);
+        addKeyValueAssociationToBlock(restored, S("c"), S("3"));
+        EXPECT_EQ(*findValuePtrInAA(moved, S("c")), S("3"));
+        EXPECT_EQ(*findValuePtrInAA(moved, S("b")), S("2"));
+    }
+
+    TEST_F(AssociativeArrayTest, SnapshotsNest) {
+        WSEML aa = createAAFromPairs({{"a", "1"}});
+        AASnapshot outer = takeSnapshot(aa);
+        addKeyValueAssociationToAA(aa, S("b"), S("2"));
+        AASnapshot inner = takeSnapshot(aa);
+        addKeyValueAssociationToAA(aa, S("c"), S("3"));
+        ASSERT_THROW(commitSnapshot(aa, outer), std::runtime_error);
+
+        commitSnapshot(aa, inner);
+        ASSERT_EQ(*findValuePtrInAA(aa, S("c")), S("3"));
+        inner = takeSnapshot(aa);
+        popBlock(aa);
+        rollbackToSnapshot(aa, inner);
+        ASSERT_EQ(*findValuePtrInAA(aa, S("c")), S("3"));
+
+        rollbackToSnapshot(aa, outer);
+        ASSERT_EQ(aa, createAAFromPairs({{"a", "1"}}));
+        ASSERT_THROW(rollbackToSnapshot(aa, outer), std::runtime_error);
+
+        AASnapshot kept = takeSnapshot(aa);
+        addKeyValueAssociationToAA(aa, S("b"), S("2"));
+        WSEML copy = aa;
+        ASSERT_EQ(getOpenSnapshotCount(copy), 0);
+        commitSnapshot(aa, kept);
+        ASSERT_EQ(getOpenSnapshotCount(aa), 0);
+        ASSERT_EQ(*findValuePtrInAA(aa, S("b")), S("2"));
+    }
+
 } // namespace wseml
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/bindingStore.hpp"
+
+namespace wseml {
+    class BindingStoreTest: public ::testing::Test {
+    protected:
+        WSEML ph1 = createPlaceholder("ph1");
+        WSEML ph2 = createPlaceholder("ph2");
+        WSEML ph3 = createPlaceholder("ph3");
+    };
+
+    TEST_F(BindingStoreTest, InternsByName) {
+        BindingStore store;
+        auto id1 = store.intern(ph1);
+        auto id2 = store.intern(ph2);
+        EXPECT_NE(id1, id2);
+        EXPECT_EQ(store.intern(createPlaceholder("ph1")), id1);
+        EXPECT_EQ(store.size(), 2);
+        EXPECT_EQ(store.getPlaceholder(id2), ph2);
+        EXPECT_THROW(store.intern(WSEML("ph1")), std::runtime_error);
+        EXPECT_THROW(store.intern(ANPLACEHOLDER), std::runtime_error);
+    }
+
+    TEST_F(BindingStoreTest, BindsClasses) {
+        BindingStore store;
+        auto id1 = store.intern(ph1);
+        auto id2 = store.intern(ph2);
+        auto id3 = store.intern(ph3);
+        EXPECT_EQ(store.getValue(id1), nullptr);
+        EXPECT_TRUE(store.unite(id1, id2));
+        EXPECT_TRUE(store.bind(id2, WSEML("v")));
+        ASSERT_NE(store.getValue(id1), nullptr);
+        EXPECT_EQ(*store.getValue(id1), WSEML("v"));
+        EXPECT_FALSE(store.bind(id1, WSEML("w")));
+
+        EXPECT_TRUE(store.bind(id3, WSEML("w")));
+        EXPECT_FALSE(store.unite(id1, id3));
+        EXPECT_EQ(store.find(id1), store.find(id2));
+        EXPECT_NE(store.find(id1), store.find(id3));
+    }
+
+    TEST_F(BindingStoreTest, UndoRestoresMark) {
+        BindingStore store;
+        auto id1 = store.intern(ph1);
+        auto id2 = store.intern(ph2);
+        auto id3 = store.intern(ph3);
+        EXPECT_TRUE(store.bind(id1, WSEML("v")));
+        BindingStore::Mark mark = store.mark();
+
+        EXPECT_TRUE(store.unite(id2, id3));
+        EXPECT_TRUE(store.unite(id1, id3));
+        EXPECT_EQ(*store.getValue(id2), WSEML("v"));
+        store.undo(mark);
+
+        EXPECT_EQ(store.getValue(id2), nullptr);
+        EXPECT_NE(store.find(id2), store.find(id3));
+        EXPECT_EQ(*store.getValue(id1), WSEML("v"));
+        EXPECT_TRUE(store.bind(id2, WSEML("x")));
+        EXPECT_EQ(*store.getValue(id2), WSEML("x"));
+    }
+
+    TEST_F(BindingStoreTest, ConvertsToBindingsAA) {
+        BindingStore store;
+        auto id1 = store.intern(ph1);
+        auto id2 = store.intern(ph2);
+        auto id3 = store.intern(ph3);
+        store.bind(id1, WSEML("v"));
+        store.unite(id2, id3);
+
+        WSEML expected = createAssociativeArray();
+        addKeyValueAssociationToAA(expected, ph1, WSEML("v"));
+        WSEML root = store.getPlaceholder(store.find(id2));
+        addKeyValueAssociationToAA(expected, root == ph2 ? ph3 : ph2, root);
+        EXPECT_EQ(store.toAA(), expected);
+    }
+} // namespace wseml
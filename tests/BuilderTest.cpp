@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/builder.hpp"
+#include "../include/parser.hpp"
+
+namespace wseml {
+    class BuilderTest: public ::testing::Test {
+    protected:
+        static WSEML S(const std::string& str) {
+            return WSEML(str);
+        }
+
+        /* checks the back pointers of the pairs of a List and of the Lists they hold */
+        static void expectLinked(const WSEML& list) {
+            for (const Pair& pair : list.getInnerList()) {
+                EXPECT_EQ(pair.getListOwner(), &list);
+                EXPECT_EQ(pair.getData().getContainingPair(), &pair);
+                if (pair.getData().structureTypeInfo() == StructureType::List) {
+                    expectLinked(pair.getData());
+                }
+            }
+        }
+    };
+
+    TEST_F(BuilderTest, ListBuilderMatchesAppend) {
+        WSEML expected = WSEML(std::list<Pair>(), S("type"));
+        expected.append(S("a"));
+        expected.append(S("b"), S("key"), S("role"));
+        expected.append(parse("{x:y}"));
+
+        ListBuilder builder(S("type"));
+        builder.reserve(3);
+        builder.append(S("a"));
+        builder.append(S("b"), S("key"), S("role"));
+        builder.append(parse("{x:y}"));
+        ASSERT_EQ(builder.size(), 3u);
+        WSEML built = builder.finish();
+
+        ASSERT_EQ(built, expected);
+        ASSERT_EQ(builder.size(), 0u);
+        expectLinked(built);
+        /* the next generated key continues after the bulk keys */
+        ASSERT_EQ(built.append(S("c")), expected.append(S("c")));
+    }
+
+    TEST_F(BuilderTest, BlockBuilderMatchesSingleAdds) {
+        WSEML funcAssoc = createFunctionalAssociation(S("trigger"), createFunctionReference("./lib.so", "f"));
+        WSEML expected = createBlock();
+        addKeyValueAssociationToBlock(expected, S("k1"), S("v1"));
+        addFunctionalAssociationToBlock(expected, funcAssoc);
+        addKeyValueAssociationToBlock(expected, S("k2"), parse("{a:b}"));
+
+        BlockBuilder builder;
+        builder.add(S("k1"), S("v1"));
+        builder.addFunctional(funcAssoc);
+        builder.add(S("k2"), parse("{a:b}"));
+        WSEML built = builder.finish();
+
+        ASSERT_TRUE(isBlock(built));
+        ASSERT_EQ(pack(built), pack(expected));
+        expectLinked(built);
+        ASSERT_THROW(builder.addFunctional(S("not an association")), std::runtime_error);
+    }
+
+    TEST_F(BuilderTest, AABuilderDropsShadowedKeys) {
+        std::vector<std::pair<WSEML, WSEML>> unsorted = {{S("b"), S("1")}, {S("a"), S("2")}, {S("b"), S("3")}, {S("c"), S("4")}, {S("a"), S("5")}};
+        WSEML expected = createAssociativeArray();
+        for (const auto& [key, value] : unsorted) {
+            addKeyValueAssociationToAA(expected, key, value);
+        }
+
+        AABuilder unsortedBuilder;
+        unsortedBuilder.add(unsorted.begin(), unsorted.end());
+        WSEML fromUnsorted = unsortedBuilder.finish();
+        ASSERT_EQ(fromUnsorted, expected);
+        ASSERT_EQ(getAssociationsFromBlock(getBlocksFromAA(fromUnsorted).front().getData()).size(), 3u);
+        ASSERT_EQ(findValueInAA(fromUnsorted, S("b")), S("1"));
+
+        std::vector<std::pair<WSEML, WSEML>> sorted = {{S("a"), S("2")}, {S("a"), S("5")}, {S("b"), S("1")}, {S("b"), S("3")}, {S("c"), S("4")}};
+        AABuilder sortedBuilder(KeyOrder::Sorted);
+        sortedBuilder.add(std::make_move_iterator(sorted.begin()), std::make_move_iterator(sorted.end()));
+        WSEML fromSorted = sortedBuilder.finish();
+        ASSERT_EQ(getAssociationsFromBlock(getBlocksFromAA(fromSorted).front().getData()).size(), 3u);
+        ASSERT_EQ(findValueInAA(fromSorted, S("a")), S("2"));
+        ASSERT_EQ(findValueInAA(fromSorted, S("b")), S("1"));
+        ASSERT_FALSE(sorted.front().first.hasObject());
+
+        ASSERT_TRUE(getBlocksFromAA(AABuilder().finish()).empty());
+    }
+
+    TEST_F(BuilderTest, AABuilderIndexesFunctionalAssociations) {
+        WSEML funcAssoc = createFunctionalAssociation(S("trigger"), createFunctionReference("./lib.so", "f"));
+        AABuilder builder;
+        builder.add(S("k"), S("v"));
+        builder.addFunctional(funcAssoc);
+        WSEML aa = builder.finish();
+        expectLinked(aa);
+        ASSERT_EQ(findFunctionalAssociationInAA(aa, S("trigger")), &getAssociationsFromBlock(getBlocksFromAA(aa).front().getData()).back().getData());
+        ASSERT_EQ(*findValuePtrInAA(aa, S("k")), S("v"));
+    }
+} // namespace wseml
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/concurrentAA.hpp"
+
+namespace wseml {
+    class ConcurrentAATest: public ::testing::Test {
+    protected:
+        const std::string libPath = "libtest_func.so";
+        WSEML triggerType = WSEML("TYPE1");
+
+        static WSEML S(const std::string& str) {
+            return WSEML(str);
+        }
+    };
+
+    TEST_F(ConcurrentAATest, LaterBlocksShadowEarlierOnes) {
+        ConcurrentAA aa(4);
+        aa.insert(S("a"), S("1"));
+        aa.insert(S("b"), S("1"));
+        ASSERT_EQ(aa.getBlockCount(), 1);
+        ASSERT_EQ(aa.pushBlock(), 1);
+        aa.insert(S("a"), S("2"));
+        aa.insert(S("a"), S("3"));
+        ASSERT_EQ(aa.findValue(S("a")), S("3"));
+        ASSERT_EQ(*aa.findValuePtr(S("b")), S("1"));
+        ASSERT_EQ(aa.findValuePtr(S("c")), nullptr);
+        ASSERT_EQ(aa.findValue(S("c")), NULLOBJ);
+
+        std::shared_ptr<const WSEML> held = aa.findValuePtr(S("a"));
+        aa.popBlock();
+        ASSERT_EQ(aa.findValue(S("a")), S("1"));
+        ASSERT_EQ(*held, S("3"));
+        aa.popBlock();
+        aa.popBlock();
+        ASSERT_EQ(aa.getBlockCount(), 0);
+        ASSERT_EQ(aa.findValuePtr(S("b")), nullptr);
+    }
+
+    TEST_F(ConcurrentAATest, WritesToLowerBlocks) {
+        ConcurrentAA aa;
+        aa.pushBlock();
+        aa.pushBlock();
+        aa.insertIntoBlock(1, S("a"), S("top"));
+        aa.insertIntoBlock(0, S("a"), S("bottom"));
+        ASSERT_EQ(aa.findValue(S("a")), S("top"));
+        ASSERT_TRUE(aa.erase(1, S("a")));
+        ASSERT_FALSE(aa.erase(1, S("a")));
+        ASSERT_EQ(aa.findValue(S("a")), S("bottom"));
+        ASSERT_THROW(aa.insertIntoBlock(2, S("a"), S("x")), std::runtime_error);
+        ASSERT_THROW(aa.erase(2, S("a")), std::runtime_error);
+    }
+
+    TEST_F(ConcurrentAATest, MatchesAssociativeArray) {
+        WSEML prefix = createFunctionalAssociation(triggerType, createFunctionReference(libPath, "add_prefix"));
+        WSEML suffix = createFunctionalAssociation(triggerType, createFunctionReference(libPath, "add_suffix"));
+        WSEML source = createAssociativeArray();
+        addKeyValueAssociationToAA(source, S("a"), S("1"));
+        addFunctionalAssociationToAA(source, suffix);
+        WSEML top = createBlock();
+        addKeyValueAssociationToBlock(top, S("a"), S("2"));
+        addFunctionalAssociationToBlock(top, prefix);
+        addFunctionalAssociationToBlock(top, suffix);
+        appendBlock(source, top);
+
+        ConcurrentAA aa(source);
+        WSEML typedKey("key", triggerType);
+        ASSERT_EQ(aa.findValue(S("a")), findValueInAA(source, S("a")));
+        ASSERT_EQ(aa.findValue(typedKey), findValueInAA(source, typedKey));
+        ASSERT_EQ(aa.toAA(), source);
+
+        aa.popBlock();
+        popBlock(source);
+        ASSERT_EQ(aa.findValue(typedKey), findValueInAA(source, typedKey));
+        ASSERT_EQ(aa.toAA(), source);
+        ASSERT_THROW(ConcurrentAA(S("not an aa")), std::runtime_error);
+    }
+
+    TEST_F(ConcurrentAATest, ConcurrentReadersAndWriters) {
+        ConcurrentAA aa(8);
+        for (int i = 0; i < 64; i++) {
+            aa.insert(S("key" + std::to_string(i)), S("base"));
+        }
+        std::atomic<bool> stop = false;
+        std::atomic<int> inconsistent = 0;
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; t++) {
+            readers.emplace_back([&, t]() {
+                for (int i = 0; not stop; i++) {
+                    WSEML value = aa.findValue(S("key" + std::to_string((i + t) % 64)));
+                    if (value != S("base") and value != S("scoped")) {
+                        inconsistent++;
+                    }
+                }
+            });
+        }
+        std::thread writer([&]() {
+            for (int round = 0; round < 200; round++) {
+                aa.pushBlock();
+                for (int i = 0; i < 64; i += 3) {
+                    aa.insert(S("key" + std::to_string(i)), S("scoped"));
+                }
+                aa.popBlock();
+            }
+        });
+        writer.join();
+        stop = true;
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        ASSERT_EQ(inconsistent, 0);
+        ASSERT_EQ(aa.getBlockCount(), 1);
+        ASSERT_EQ(aa.findValue(S("key0")), S("base"));
+    }
+
+} // namespace wseml
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/factStore.hpp"
+
+namespace wseml {
+    class FactStoreTest: public ::testing::Test {
+    protected:
+        WSEML ph1 = createPlaceholder("ph1");
+        WSEML ph2 = createPlaceholder("ph2");
+
+        static WSEML aa(std::initializer_list<std::pair<WSEML, WSEML>> entries) {
+            WSEML result = createAssociativeArray();
+            for (const auto& [key, value] : entries) {
+                addKeyValueAssociationToAA(result, key, value);
+            }
+            return result;
+        }
+
+        static WSEML person(const std::string& name, const std::string& city) {
+            return aa({{WSEML("name"), WSEML(name)}, {WSEML("city"), WSEML(city)}});
+        }
+
+        /* the ids of facts that unify with the pattern, found by trying every fact */
+        static std::vector<FactStore::FactId> linearQuery(const FactStore& store, const std::vector<FactStore::FactId>& ids, const WSEML& pattern) {
+            std::vector<FactStore::FactId> result;
+            for (FactStore::FactId id : ids) {
+                if (store.contains(id) and unify(store.get(id), pattern).first != NULLOBJ) {
+                    result.push_back(id);
+                }
+            }
+            return result;
+        }
+
+        static std::vector<FactStore::FactId> ids(const std::vector<FactMatch>& matches) {
+            std::vector<FactStore::FactId> result;
+            for (const FactMatch& match : matches) {
+                result.push_back(match.id);
+            }
+            return result;
+        }
+    };
+
+    TEST_F(FactStoreTest, AddGetRemove) {
+        FactStore store;
+        FactStore::FactId alice = store.add(person("Alice", "Paris"));
+        FactStore::FactId bob = store.add(person("Bob", "Rome"));
+        EXPECT_NE(alice, bob);
+        EXPECT_EQ(store.size(), 2);
+        EXPECT_EQ(store.get(bob), person("Bob", "Rome"));
+
+        EXPECT_TRUE(store.remove(alice));
+        EXPECT_FALSE(store.remove(alice));
+        EXPECT_FALSE(store.contains(alice));
+        EXPECT_EQ(store.size(), 1);
+        EXPECT_THROW(store.get(alice), std::runtime_error);
+        EXPECT_THROW(store.add(WSEML("not aa")), std::runtime_error);
+    }
+
+    TEST_F(FactStoreTest, GroundEntriesPruneCandidates) {
+        FactStore store;
+        std::vector<FactStore::FactId> all;
+        for (int i = 0; i < 50; i++) {
+            all.push_back(store.add(person("person" + std::to_string(i), i % 2 == 0 ? "Paris" : "Rome")));
+        }
+
+        WSEML byName = aa({{WSEML("name"), WSEML("person7")}, {WSEML("city"), ph1}});
+        EXPECT_EQ(store.candidates(byName).size(), 1);
+        std::vector<FactMatch> matches = store.query(byName);
+        ASSERT_EQ(matches.size(), 1);
+        EXPECT_EQ(matches[0].id, all[7]);
+        EXPECT_EQ(findValueInAA(matches[0].bindings, ph1), WSEML("Rome"));
+
+        WSEML byCity = aa({{WSEML("city"), WSEML("Paris")}});
+        EXPECT_EQ(store.candidates(byCity).size(), 25);
+        EXPECT_EQ(ids(store.query(byCity)), linearQuery(store, all, byCity));
+
+        WSEML conflicting = aa({{WSEML("name"), WSEML("person7")}, {WSEML("city"), WSEML("Paris")}});
+        EXPECT_TRUE(store.candidates(conflicting).empty());
+
+        WSEML onlyPlaceholders = aa({{WSEML("name"), ph1}, {WSEML("city"), ANPLACEHOLDER}});
+        EXPECT_EQ(store.candidates(onlyPlaceholders).size(), 50);
+        EXPECT_EQ(store.query(onlyPlaceholders).size(), 50);
+    }
+
+    TEST_F(FactStoreTest, MissingKeysAndNonGroundFactsStayCandidates) {
+        FactStore store;
+        std::vector<FactStore::FactId> all;
+        all.push_back(store.add(person("Alice", "Paris")));
+        all.push_back(store.add(aa({{WSEML("name"), WSEML("Carol")}})));
+        all.push_back(store.add(aa({{WSEML("name"), ph2}, {WSEML("city"), WSEML("Rome")}})));
+        all.push_back(store.add(aa({{WSEML("name"), aa({{WSEML("first"), WSEML("Dan")}})}})));
+
+        for (const WSEML& pattern : {aa({{WSEML("city"), WSEML("Paris")}}), aa({{WSEML("name"), WSEML("Alice")}, {WSEML("city"), ph1}}),
+                                     aa({{WSEML("name"), WSEML("Carol")}, {WSEML("age"), WSEML("40")}}), aa({{WSEML("unknown"), WSEML("x")}})}) {
+            EXPECT_EQ(ids(store.query(pattern)), linearQuery(store, all, pattern)) << pattern;
+        }
+        EXPECT_EQ(store.candidates(aa({{WSEML("name"), WSEML("Alice")}})), (std::vector<FactStore::FactId>{all[0], all[2], all[3]}));
+    }
+
+    TEST_F(FactStoreTest, RemovedFactsAreNotReturned) {
+        FactStore store;
+        FactStore::FactId first = store.add(person("Alice", "Paris"));
+        FactStore::FactId second = store.add(person("Alice", "Rome"));
+        store.remove(first);
+
+        WSEML pattern = aa({{WSEML("name"), WSEML("Alice")}});
+        EXPECT_EQ(store.candidates(pattern), std::vector<FactStore::FactId>{second});
+        store.remove(second);
+        EXPECT_TRUE(store.candidates(pattern).empty());
+        EXPECT_TRUE(store.query(aa({})).empty());
+    }
+} // namespace wseml
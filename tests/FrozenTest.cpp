@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/frozen.hpp"
+#include "../include/parser.hpp"
+
+namespace wseml {
+    class FrozenTest: public ::testing::Test {
+    protected:
+        static WSEML S(const std::string& str) {
+            return WSEML(str);
+        }
+
+        static WSEML makeAA(std::size_t keys) {
+            WSEML aa = createAssociativeArray();
+            for (std::size_t i = 0; i < keys; i++) {
+                if (i % 16 == 0) {
+                    WSEML block = createBlock();
+                    enableKeyFilter(block, 16);
+                    appendBlock(aa, block);
+                }
+                addKeyValueAssociationToAA(aa, S("key" + std::to_string(i)), S("value" + std::to_string(i)));
+            }
+            return aa;
+        }
+    };
+
+    TEST_F(FrozenTest, FreezeKeepsTheValue) {
+        WSEML tree = parse("{a:{b:c, d:e}, f:g}");
+        WSEML expected = tree;
+        FrozenWSEML frozen = freeze(std::move(tree));
+        ASSERT_TRUE(isFrozen(*frozen));
+        ASSERT_TRUE(isFrozen(frozen->getList().find("a")));
+        ASSERT_EQ(*frozen, expected);
+        ASSERT_EQ(frozen.hash(), std::hash<WSEML>{}(expected));
+    }
+
+    TEST_F(FrozenTest, CopiesShareTheTree) {
+        FrozenWSEML frozen = freeze(makeAA(64));
+        FrozenWSEML copy = frozen;
+        ASSERT_TRUE(copy.sharesWith(frozen));
+        ASSERT_EQ(&copy.get(), &frozen.get());
+        ASSERT_EQ(copy, frozen);
+
+        FrozenWSEML other = freeze(makeAA(64));
+        ASSERT_FALSE(other.sharesWith(frozen));
+        ASSERT_EQ(other, frozen);
+        ASSERT_NE(freeze(makeAA(63)), frozen);
+
+        std::unordered_set<FrozenWSEML> set{frozen, copy, other};
+        ASSERT_EQ(set.size(), 1);
+    }
+
+    TEST_F(FrozenTest, ThawGivesAMutableCopy) {
+        FrozenWSEML frozen = freeze(makeAA(16));
+        WSEML thawed = frozen.thaw();
+        ASSERT_FALSE(isFrozen(thawed));
+        ASSERT_EQ(thawed, *frozen);
+        appendBlock(thawed, createBlock());
+        addKeyValueAssociationToAA(thawed, S("key0"), S("changed"));
+        ASSERT_EQ(*findValuePtrInAA(thawed, S("key0")), S("changed"));
+        ASSERT_EQ(*findValuePtrInAA(*frozen, S("key0")), S("value0"));
+    }
+
+    TEST_F(FrozenTest, ConcurrentReads) {
+        FrozenWSEML frozen = freeze(makeAA(256));
+        std::atomic<std::size_t> mismatches = 0;
+        std::vector<std::thread> readers;
+        for (std::size_t t = 0; t < 4; t++) {
+            readers.emplace_back([&, t]() {
+                FrozenWSEML local = frozen;
+                for (std::size_t i = t; i < 256; i += 4) {
+                    const WSEML* value = findValuePtrInAA(*local, S("key" + std::to_string(i)));
+                    if (value == nullptr or *value != S("value" + std::to_string(i))) {
+                        mismatches++;
+                    }
+                    if (findValuePtrInAA(*local, S("missing")) != nullptr or std::hash<WSEML>{}(*local) != local.hash()) {
+                        mismatches++;
+                    }
+                }
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        ASSERT_EQ(mismatches, 0);
+    }
+
+    TEST_F(FrozenTest, MutationAssertsInDebugBuilds) {
+        FrozenWSEML frozen = freeze(parse("{a:b}"));
+        WSEML& mutableView = const_cast<WSEML&>(*frozen);
+        EXPECT_DEBUG_DEATH(mutableView.append(S("c")), "frozen");
+        EXPECT_DEBUG_DEATH(mutableView.getList().find("a").getByteString().get() = "x", "frozen");
+    }
+
+    TEST_F(FrozenTest, LinkUpdateKeepsTheFrozenFlag) {
+        FrozenWSEML frozen = freeze(parse("{a:b}"));
+        Object* leaf = const_cast<Object*>(frozen->getList().find("a").getRawObject());
+        Pair* link = leaf->getContainingPair();
+        ASSERT_NE(link, nullptr);
+        /* the flag shares its word with the link; release builds do not assert */
+        EXPECT_DEBUG_DEATH(leaf->setContainingPair(link), "frozen");
+        EXPECT_TRUE(leaf->isFrozen());
+        EXPECT_EQ(leaf->getContainingPair(), link);
+    }
+
+} // namespace wseml
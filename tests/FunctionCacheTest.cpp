@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/functionCache.hpp"
+
+namespace wseml {
+    class FunctionCacheTest: public ::testing::Test {
+    protected:
+        const std::string libPath = "libtest_func.so";
+        WSEML triggerType = WSEML("TYPE1");
+        WSEML prefixRef = createFunctionReference(libPath, "add_prefix");
+        WSEML suffixRef = createFunctionReference(libPath, "add_suffix");
+
+        void SetUp() override {
+            getFunctionResultCache().invalidateAll();
+            getFunctionResultCache().resetStats();
+        }
+
+        WSEML typedKey(const std::string& key) const {
+            return WSEML(key, triggerType);
+        }
+    };
+
+    TEST_F(FunctionCacheTest, CallCachesResults) {
+        FunctionResultCache cache(4);
+        EXPECT_EQ(cache.call(prefixRef, WSEML("a")), WSEML("PREFIX_a"));
+        EXPECT_EQ(cache.call(prefixRef, WSEML("a")), WSEML("PREFIX_a"));
+        EXPECT_EQ(cache.call(suffixRef, WSEML("a")), WSEML("a_SUFFIX"));
+
+        FunctionCacheStats stats = cache.getStats();
+        EXPECT_EQ(stats.hits, 1);
+        EXPECT_EQ(stats.misses, 2);
+        EXPECT_EQ(cache.size(), 2);
+    }
+
+    TEST_F(FunctionCacheTest, EvictsLeastRecentlyUsedPerFunction) {
+        FunctionResultCache cache(2);
+        cache.store(prefixRef, WSEML("a"), WSEML("A"));
+        cache.store(prefixRef, WSEML("b"), WSEML("B"));
+        cache.store(suffixRef, WSEML("a"), WSEML("A_SUFFIX"));
+        ASSERT_TRUE(cache.lookup(prefixRef, WSEML("a")).has_value());
+        cache.store(prefixRef, WSEML("c"), WSEML("C"));
+
+        EXPECT_FALSE(cache.lookup(prefixRef, WSEML("b")).has_value());
+        EXPECT_EQ(cache.lookup(prefixRef, WSEML("a")), WSEML("A"));
+        EXPECT_EQ(cache.lookup(prefixRef, WSEML("c")), WSEML("C"));
+        EXPECT_EQ(cache.lookup(suffixRef, WSEML("a")), WSEML("A_SUFFIX"));
+        EXPECT_EQ(cache.getStats().evictions, 1);
+
+        cache.setCapacity(1);
+        EXPECT_EQ(cache.size(), 2);
+        EXPECT_EQ(cache.getStats().evictions, 2);
+    }
+
+    TEST_F(FunctionCacheTest, Invalidation) {
+        FunctionResultCache cache;
+        cache.store(prefixRef, WSEML("a"), WSEML("A"));
+        cache.store(prefixRef, WSEML("b"), WSEML("B"));
+        cache.store(suffixRef, WSEML("a"), WSEML("A"));
+
+        cache.invalidate(prefixRef);
+        EXPECT_FALSE(cache.lookup(prefixRef, WSEML("a")).has_value());
+        EXPECT_TRUE(cache.lookup(suffixRef, WSEML("a")).has_value());
+        EXPECT_EQ(cache.getStats().invalidations, 2);
+
+        cache.invalidateAll();
+        EXPECT_EQ(cache.size(), 0);
+        EXPECT_EQ(cache.getStats().invalidations, 3);
+    }
+
+    TEST_F(FunctionCacheTest, ZeroCapacityDisablesCaching) {
+        FunctionResultCache cache(0);
+        EXPECT_EQ(cache.call(prefixRef, WSEML("a")), WSEML("PREFIX_a"));
+        EXPECT_EQ(cache.call(prefixRef, WSEML("a")), WSEML("PREFIX_a"));
+        EXPECT_EQ(cache.size(), 0);
+        EXPECT_EQ(cache.getStats().hits, 0);
+    }
+
+    TEST_F(FunctionCacheTest, PureFlag) {
+        WSEML impure = createFunctionalAssociation(triggerType, prefixRef);
+        WSEML pure = createFunctionalAssociation(triggerType, prefixRef, true);
+        EXPECT_TRUE(isFunctionalAssociation(pure));
+        EXPECT_FALSE(isPureFunctionalAssociation(impure));
+        EXPECT_TRUE(isPureFunctionalAssociation(pure));
+        EXPECT_THROW(isPureFunctionalAssociation(WSEML("x")), std::runtime_error);
+    }
+
+    TEST_F(FunctionCacheTest, FindValueUsesCacheOnlyForPureAssociations) {
+        WSEML impureAA = createAssociativeArray();
+        addFunctionalAssociationToAA(impureAA, createFunctionalAssociation(triggerType, prefixRef));
+        EXPECT_EQ(findValueInAA(impureAA, typedKey("k")), WSEML("PREFIX_k"));
+        EXPECT_EQ(getFunctionResultCache().size(), 0);
+
+        WSEML pureAA = createAssociativeArray();
+        addFunctionalAssociationToAA(pureAA, createFunctionalAssociation(triggerType, prefixRef, true));
+        EXPECT_EQ(findValueInAA(pureAA, typedKey("k")), WSEML("PREFIX_k"));
+        EXPECT_EQ(findValueInAA(pureAA, typedKey("k")), WSEML("PREFIX_k"));
+        EXPECT_EQ(getFunctionResultCache().getStats().hits, 1);
+        EXPECT_EQ(getFunctionResultCache().getStats().misses, 1);
+    }
+
+    TEST_F(FunctionCacheTest, UnifyKeepsPureFlag) {
+        WSEML aa1 = createAssociativeArray();
+        addKeyValueAssociationToAA(aa1, typedKey("k"), createPlaceholder("x"));
+        WSEML aa2 = createAssociativeArray();
+        addFunctionalAssociationToAA(aa2, createFunctionalAssociation(triggerType, prefixRef, true));
+
+        auto [result, bindings] = unify(aa1, aa2);
+        ASSERT_NE(result, NULLOBJ);
+        EXPECT_EQ(getFunctionResultCache().getStats().misses, 1);
+        EXPECT_EQ(unify(aa1, aa2).first, result);
+        EXPECT_EQ(getFunctionResultCache().getStats().hits, 1);
+
+        bool foundPure = false;
+        for (auto&& block : getBlocksFromAA(result)) {
+            for (auto&& assoc : getAssociationsFromBlock(block.getData())) {
+                if (isFunctionalAssociation(assoc.getData())) {
+                    foundPure = isPureFunctionalAssociation(assoc.getData());
+                }
+            }
+        }
+        EXPECT_TRUE(foundPure);
+    }
+} // namespace wseml
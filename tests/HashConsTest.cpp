@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/builder.hpp"
+#include "../include/hashCons.hpp"
+#include "../include/parser.hpp"
+
+namespace wseml {
+    class HashConsTest: public ::testing::Test {
+    protected:
+        /* a pointer descriptor as repeated in every instruction of the programs in lists.hpp */
+        static constexpr const char* FRAGMENT = "{type:d, 1:$[1:$[t:r]ps, 2:$[t:k, k:data]ps]ptr}";
+    };
+
+    TEST_F(HashConsTest, EqualTreesShareOneCopy) {
+        HashConsTable table;
+        FrozenWSEML first = parse(FRAGMENT, table);
+        FrozenWSEML second = parse(FRAGMENT, table);
+        FrozenWSEML other = parse("{type:i, 1:$[1:$[t:r]ps]ptr}", table);
+        ASSERT_TRUE(first.sharesWith(second));
+        ASSERT_EQ(first, second);
+        ASSERT_NE(first, other);
+        ASSERT_EQ(*first, parse(FRAGMENT));
+        ASSERT_TRUE(isFrozen(*first));
+
+        /* the Lists of the fragment, {t:r} included, which other shares */
+        HashConsStats stats = table.stats();
+        ASSERT_EQ(stats.interned, 11u);
+        ASSERT_EQ(stats.distinct, 6u);
+        ASSERT_EQ(stats.reused, 5u);
+        ASSERT_EQ(stats.overheadBytes, 6 * sizeof(SharedNode));
+        const WSEML& operand = first->getList().find("1").getList().find("1");
+        ASSERT_EQ(operand.getSharedNode(), other->getList().find("1").getList().find("1").getSharedNode());
+        ASSERT_EQ(stats.bytesSaved, footprint(parse(FRAGMENT)) + footprint(operand.getSharedNode()->tree));
+
+        /* interning a handle the table already holds saves no copy */
+        ASSERT_TRUE(table.intern(first).sharesWith(first));
+        ASSERT_EQ(table.stats().bytesSaved, stats.bytesSaved);
+    }
+
+    TEST_F(HashConsTest, HandlesOfOtherTablesCompareByValue) {
+        HashConsTable table;
+        HashConsTable otherTable;
+        FrozenWSEML interned = parse(FRAGMENT, table);
+        ASSERT_EQ(interned, parse(FRAGMENT, otherTable));
+        ASSERT_EQ(interned, freeze(parse(FRAGMENT)));
+        ASSERT_FALSE(interned.sharesWith(parse(FRAGMENT, otherTable)));
+    }
+
+    TEST_F(HashConsTest, ThawCopiesBeforeAChange) {
+        HashConsTable table;
+        FrozenWSEML first = parse(FRAGMENT, table);
+        FrozenWSEML second = parse(FRAGMENT, table);
+        WSEML changed = first.thaw();
+        changed.append(WSEML("x"));
+        ASSERT_EQ(*second, parse(FRAGMENT));
+        /* the changed root is added; its subtrees are still those of first */
+        FrozenWSEML interned = table.intern(std::move(changed));
+        ASSERT_NE(interned, first);
+        ASSERT_EQ(interned->getList().find("1").getSharedNode(), first->getList().find("1").getSharedNode());
+        ASSERT_EQ(table.size(), 5u);
+    }
+
+    TEST_F(HashConsTest, SubtreesOfADocumentShareOneNode) {
+        HashConsTable table;
+        std::string text = std::string("{1:") + FRAGMENT + ", 2:" + FRAGMENT + ", 3:x}";
+        FrozenWSEML program = parse(text, table);
+        ASSERT_EQ(table.stats().bytesSaved, footprint(parse(FRAGMENT)));
+        const WSEML& first = program->getList().find("1");
+        const WSEML& second = program->getList().find("2");
+        ASSERT_TRUE(first.isShared());
+        ASSERT_EQ(first.getSharedNode(), second.getSharedNode());
+        ASSERT_EQ(first.getContainingPair(), &program->getInnerList().front());
+        ASSERT_TRUE(freeze(first).sharesWith(parse(FRAGMENT, table)));
+        ASSERT_EQ(*program, parse(text));
+        ASSERT_EQ(program.hash(), std::hash<WSEML>{}(parse(text)));
+
+        /* the second copy of the fragment is gone, the four nodes of the first take a SharedNode each */
+        ASSERT_EQ(footprint(*program), footprint(parse(text)) - footprint(parse(FRAGMENT)) + 4 * sizeof(SharedNode));
+
+        /* a change copies the nodes on its path only */
+        WSEML changed = program.thaw();
+        ASSERT_TRUE(changed.getList().find("1").isShared());
+        changed.getList().find("1").getList().find("type") = WSEML("changed");
+        ASSERT_FALSE(changed.getList().find("1").isShared());
+        ASSERT_FALSE(isFrozen(changed.getList().find("1")));
+        ASSERT_TRUE(changed.getList().find("1").getList().find("1").isShared());
+        ASSERT_TRUE(changed.getList().find("2").isShared());
+        ASSERT_NE(changed.getList().find("1"), changed.getList().find("2"));
+        ASSERT_EQ(first, parse(FRAGMENT));
+    }
+
+    TEST_F(HashConsTest, BuildersIntern) {
+        HashConsTable table;
+        ListBuilder listBuilder;
+        listBuilder.append(WSEML("v"), WSEML("k"));
+        FrozenWSEML list = listBuilder.finish(table);
+        ASSERT_TRUE(list.sharesWith(parse("{k:v}", table)));
+
+        AABuilder first;
+        first.add(WSEML("k"), WSEML("v"));
+        AABuilder second;
+        second.add(WSEML("k"), WSEML("v"));
+        ASSERT_TRUE(first.finish(table).sharesWith(second.finish(table)));
+
+        BlockBuilder firstBlock;
+        firstBlock.add(WSEML("k"), WSEML("v"));
+        BlockBuilder secondBlock;
+        secondBlock.add(WSEML("k"), WSEML("v"));
+        FrozenWSEML block = firstBlock.finish(table);
+        ASSERT_TRUE(block.sharesWith(secondBlock.finish(table)));
+
+        /* the Block of the AA is the same node */
+        AABuilder third;
+        third.add(WSEML("k"), WSEML("v"));
+        FrozenWSEML aa = third.finish(table);
+        ASSERT_TRUE(freeze(aa->getInnerList().front().getData()).sharesWith(block));
+        ASSERT_EQ(*findValuePtrInAA(*aa, WSEML("k")), WSEML("v"));
+    }
+
+    TEST_F(HashConsTest, PurgeDropsUnreferencedTrees) {
+        HashConsTable table;
+        FrozenWSEML kept = parse(FRAGMENT, table);
+        parse("{a:b}", table);
+        ASSERT_EQ(table.size(), 5u);
+        ASSERT_EQ(table.purge(), 1u);
+        ASSERT_EQ(table.size(), 4u);
+        ASSERT_TRUE(parse(FRAGMENT, table).sharesWith(kept));
+
+        /* the nodes below the root go with it */
+        kept = FrozenWSEML();
+        ASSERT_EQ(table.purge(), 4u);
+        ASSERT_EQ(table.size(), 0u);
+        ASSERT_EQ(table.stats().overheadBytes, 0u);
+    }
+} // namespace wseml
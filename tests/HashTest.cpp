@@ -1,9 +1,11 @@
 #include <gtest/gtest.h>
 #include "../include/WSEML.hpp"
 #include "../include/associativeArray.hpp"
+#include "../include/parallelTraversal.hpp"
 #include <string>
 #include <functional>
 #include <initializer_list>
+#include <random>
 
 namespace wseml {
     class HashTest: public ::testing::Test {
@@ -42,6 +44,37 @@ namespace wseml {
             appendBlock(aa, block); // Add the single block
             return aa;
         }
+
+        /* a tree mixing wide and narrow lists, blocks (with duplicate data) and AAs (with shadowed keys) */
+        static WSEML randomTree(std::mt19937& random, std::size_t depth) {
+            std::size_t width = std::uniform_int_distribution<std::size_t>(0, 24)(random);
+            if (depth == 0 or width < 8) {
+                return S("s" + std::to_string(width));
+            }
+            std::size_t kind = random() % 3;
+            if (kind == 0) {
+                WSEML aa = createAssociativeArray();
+                for (std::size_t i = 0; i < width; i++) {
+                    if (i % 8 == 0) {
+                        appendBlock(aa, createBlock());
+                    }
+                    addKeyValueAssociationToAA(aa, S("k" + std::to_string(random() % 16)), randomTree(random, depth - 1));
+                }
+                return aa;
+            }
+            if (kind == 1) {
+                WSEML block = createBlock();
+                for (std::size_t i = 0; i < width; i++) {
+                    addKeyValueAssociationToBlock(block, S("k" + std::to_string(i % 4)), S("v" + std::to_string(random() % 4)));
+                }
+                return block;
+            }
+            WSEML list = WSEML(std::list<Pair>());
+            for (std::size_t i = 0; i < width; i++) {
+                list.append(randomTree(random, depth - 1), S("k" + std::to_string(i)), i % 5 == 0 ? S("role") : NULLOBJ);
+            }
+            return list;
+        }
     };
 
     TEST_F(HashTest, NullTest) {
@@ -217,4 +250,56 @@ namespace wseml {
         ASSERT_EQ(std::hash<WSEML>{}(blockWithAA), std::hash<WSEML>{}(blockWithAACopy));
         ASSERT_NE(std::hash<WSEML>{}(blockWithAA), std::hash<WSEML>{}(blockWithDiffAA));
     }
-} // namespace wseml
\ No newline at end of file
+
+    TEST_F(HashTest, ParallelHashMatchesSequential) {
+        WorkStealingPool pool(4);
+        std::mt19937 random(42);
+        for (std::size_t i = 0; i < 20; i++) {
+            WSEML tree = randomTree(random, 3);
+            std::size_t expected = std::hash<WSEML>{}(tree);
+            ASSERT_EQ(parallelHashValue(tree, pool, 4), expected);
+            ASSERT_EQ(parallelHashValue(tree, pool), expected);
+        }
+        ASSERT_EQ(parallelHashValue(NULLOBJ, pool), std::hash<WSEML>{}(NULLOBJ));
+    }
+
+    TEST_F(HashTest, ParallelEqualMatchesSequential) {
+        WorkStealingPool pool(4);
+        std::mt19937 random(7);
+        for (std::size_t i = 0; i < 20; i++) {
+            WSEML tree = randomTree(random, 3);
+            WSEML copy = tree;
+            ASSERT_TRUE(parallelEqual(tree, copy, pool, 4));
+
+            WSEML other = randomTree(random, 3);
+            ASSERT_EQ(parallelEqual(tree, other, pool, 4), tree == other);
+        }
+
+        WSEML block1 = createBlock();
+        WSEML block2 = createBlock();
+        for (std::size_t i = 0; i < 64; i++) {
+            addKeyValueAssociationToBlock(block1, S("k" + std::to_string(i % 3)), S("v"));
+            addKeyValueAssociationToBlock(block2, S("k" + std::to_string((i + 1) % 3)), S("v"));
+        }
+        ASSERT_EQ(parallelEqual(block1, block2, pool, 4), block1 == block2);
+        addKeyValueAssociationToBlock(block2, S("k0"), S("v"));
+        addKeyValueAssociationToBlock(block1, S("k1"), S("v"));
+        ASSERT_EQ(parallelEqual(block1, block2, pool, 4), block1 == block2);
+    }
+
+    TEST_F(HashTest, WorkStealingPoolForkJoin) {
+        WorkStealingPool pool(3);
+        std::vector<int> values(10000, 1);
+        std::atomic<long> sum = 0;
+        pool.run([&]() {
+            pool.parallelFor(0, values.size(), 16, [&](std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; i++) {
+                    sum += values[i];
+                }
+            });
+        });
+        ASSERT_EQ(sum, 10000);
+        ASSERT_EQ(pool.run([]() { return 5; }), 5);
+        ASSERT_THROW(pool.run([&]() { pool.invoke([]() {}, []() { throw std::runtime_error("right"); }); }), std::runtime_error);
+    }
+} // namespace wseml
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/matchNetwork.hpp"
+
+namespace wseml {
+    class MatchNetworkTest: public ::testing::Test {
+    protected:
+        WSEML x = createPlaceholder("x");
+        WSEML y = createPlaceholder("y");
+
+        static WSEML aa(std::initializer_list<std::pair<WSEML, WSEML>> entries) {
+            WSEML result = createAssociativeArray();
+            for (const auto& [key, value] : entries) {
+                addKeyValueAssociationToAA(result, key, value);
+            }
+            return result;
+        }
+
+        static WSEML parent(const std::string& parentName, const std::string& childName) {
+            return aa({{WSEML("rel"), WSEML("parent")}, {WSEML("from"), WSEML(parentName)}, {WSEML("to"), WSEML(childName)}});
+        }
+
+        static std::vector<std::vector<std::size_t>> factLists(std::vector<Activation> activations) {
+            std::vector<std::vector<std::size_t>> result;
+            for (const Activation& activation : activations) {
+                result.push_back(activation.facts);
+            }
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+    };
+
+    TEST_F(MatchNetworkTest, SinglePatternActivationsUseUnifyBindings) {
+        MatchNetwork network;
+        WSEML pattern = aa({{WSEML("rel"), WSEML("parent")}, {WSEML("from"), x}});
+        MatchNetwork::RuleId rule = network.addRule({pattern});
+
+        MatchNetwork::FactId id;
+        std::vector<Activation> added = network.addFact(parent("Ann", "Bob"), &id);
+        ASSERT_EQ(added.size(), 1);
+        EXPECT_EQ(added[0].rule, rule);
+        EXPECT_EQ(added[0].facts, std::vector<std::size_t>{id});
+        EXPECT_EQ(added[0].bindings, unify(network.getFact(id), pattern).second);
+
+        EXPECT_TRUE(network.addFact(aa({{WSEML("rel"), WSEML("friend")}, {WSEML("from"), WSEML("Ann")}})).empty());
+        EXPECT_EQ(network.getActivations(rule).size(), 1);
+
+        std::vector<Activation> retracted = network.removeFact(id);
+        ASSERT_EQ(retracted.size(), 1);
+        EXPECT_EQ(retracted[0].facts, std::vector<std::size_t>{id});
+        EXPECT_TRUE(network.getActivations(rule).empty());
+        EXPECT_TRUE(network.removeFact(id).empty());
+    }
+
+    TEST_F(MatchNetworkTest, JoinsOnSharedPlaceholders) {
+        MatchNetwork network;
+        WSEML first = aa({{WSEML("rel"), WSEML("parent")}, {WSEML("from"), x}, {WSEML("to"), y}});
+        WSEML second = aa({{WSEML("rel"), WSEML("parent")}, {WSEML("from"), y}});
+        MatchNetwork::RuleId grandparent = network.addRule({first, second});
+
+        MatchNetwork::FactId annBob, bobCid, cidDan;
+        network.addFact(parent("Ann", "Bob"), &annBob);
+        std::vector<Activation> added = network.addFact(parent("Bob", "Cid"), &bobCid);
+        EXPECT_EQ(factLists(added), (std::vector<std::vector<std::size_t>>{{annBob, bobCid}}));
+        EXPECT_EQ(findValueInAA(added[0].bindings, x), WSEML("Ann"));
+        EXPECT_EQ(findValueInAA(added[0].bindings, y), WSEML("Bob"));
+
+        added = network.addFact(parent("Cid", "Dan"), &cidDan);
+        EXPECT_EQ(factLists(added), (std::vector<std::vector<std::size_t>>{{bobCid, cidDan}}));
+        EXPECT_EQ(network.getActivations(grandparent).size(), 2);
+
+        std::vector<Activation> retracted = network.removeFact(bobCid);
+        EXPECT_EQ(factLists(retracted), (std::vector<std::vector<std::size_t>>{{annBob, bobCid}, {bobCid, cidDan}}));
+        EXPECT_TRUE(network.getActivations(grandparent).empty());
+    }
+
+    TEST_F(MatchNetworkTest, FactMatchingSeveralPositionsIsJoinedOnce) {
+        MatchNetwork network;
+        WSEML any = aa({{WSEML("rel"), WSEML("parent")}});
+        MatchNetwork::RuleId pairs = network.addRule({any, any});
+
+        MatchNetwork::FactId first, second;
+        std::vector<Activation> added = network.addFact(parent("A", "B"), &first);
+        EXPECT_EQ(factLists(added), (std::vector<std::vector<std::size_t>>{{first, first}}));
+        added = network.addFact(parent("C", "D"), &second);
+        EXPECT_EQ(factLists(added), (std::vector<std::vector<std::size_t>>{{first, second}, {second, first}, {second, second}}));
+        EXPECT_EQ(network.getActivations(pairs).size(), 4);
+        EXPECT_EQ(network.getAlphaMemoryCount(), 1);
+    }
+
+    TEST_F(MatchNetworkTest, SharesAlphaTestsAndMatchesExistingFacts) {
+        MatchNetwork network;
+        MatchNetwork::FactId annBob;
+        network.addFact(parent("Ann", "Bob"), &annBob);
+        network.addFact(aa({{WSEML("rel"), WSEML("friend")}}));
+
+        MatchNetwork::RuleId byParent = network.addRule({aa({{WSEML("rel"), WSEML("parent")}, {WSEML("from"), x}})});
+        MatchNetwork::RuleId byChild = network.addRule({aa({{WSEML("rel"), WSEML("parent")}, {WSEML("to"), x}})});
+        EXPECT_EQ(network.getAlphaTestCount(), 1);
+        EXPECT_EQ(network.getAlphaMemoryCount(), 2);
+        EXPECT_EQ(factLists(network.getActivations(byParent)), (std::vector<std::vector<std::size_t>>{{annBob}}));
+        EXPECT_EQ(factLists(network.getActivations(byChild)), (std::vector<std::vector<std::size_t>>{{annBob}}));
+
+        EXPECT_THROW(network.addRule({}), std::runtime_error);
+        EXPECT_THROW(network.addRule({WSEML("x")}), std::runtime_error);
+        EXPECT_THROW(network.addFact(WSEML("x")), std::runtime_error);
+        EXPECT_THROW(network.getActivations(42), std::runtime_error);
+    }
+} // namespace wseml
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/patternMatcher.hpp"
+
+namespace wseml {
+    class PatternMatcherTest: public ::testing::Test {
+    protected:
+        WSEML ph1 = createPlaceholder("ph1");
+        WSEML ph2 = createPlaceholder("ph2");
+        WSEML testType1 = WSEML("TYPE1");
+
+        static WSEML aa(std::initializer_list<std::pair<WSEML, WSEML>> entries) {
+            WSEML result = createAssociativeArray();
+            for (const auto& [key, value] : entries) {
+                addKeyValueAssociationToAA(result, key, value);
+            }
+            return result;
+        }
+
+        static WSEML list(std::initializer_list<std::pair<std::string, WSEML>> entries, const std::string& type = "") {
+            WSEML result = WSEML(std::list<Pair>());
+            for (const auto& [key, value] : entries) {
+                result.append(value, WSEML(key));
+            }
+            if (not type.empty()) {
+                result.setSemanticType(WSEML(type));
+            }
+            return result;
+        }
+
+        static void expectSameAsMatchAndSubstitute(const WSEML& storage, const WSEML& pattern) {
+            PatternMatcher matcher(pattern);
+            WSEML expected = matchAndSubstitute(storage, pattern);
+            EXPECT_EQ(matcher.match(storage), expected) << "storage: " << storage << "\npattern: " << pattern;
+            PatternMatcher::Scratch scratch;
+            EXPECT_EQ(matcher.match(storage, scratch), expected);
+        }
+    };
+
+    TEST_F(PatternMatcherTest, BindsTopLevelSlots) {
+        WSEML storage = aa({{WSEML("name"), WSEML("Alice")}, {WSEML("age"), WSEML("30")}, {WSEML("city"), WSEML("Paris")}});
+        WSEML pattern = aa({{WSEML("name"), ph1}, {WSEML("age"), ph2}});
+
+        PatternMatcher matcher(pattern);
+        EXPECT_EQ(matcher.getSlotCount(), 2);
+        EXPECT_FALSE(matcher.alwaysFallsBack());
+        EXPECT_EQ(matcher.match(storage), aa({{WSEML("name"), WSEML("Alice")}, {WSEML("age"), WSEML("30")}}));
+        expectSameAsMatchAndSubstitute(storage, pattern);
+    }
+
+    TEST_F(PatternMatcherTest, GroundMismatchFails) {
+        WSEML storage = aa({{WSEML("name"), WSEML("Alice")}, {WSEML("age"), WSEML("30")}});
+        WSEML pattern = aa({{WSEML("name"), WSEML("Alice")}, {WSEML("age"), WSEML("31")}});
+        EXPECT_EQ(PatternMatcher(pattern).match(storage), NULLOBJ);
+        expectSameAsMatchAndSubstitute(storage, pattern);
+    }
+
+    TEST_F(PatternMatcherTest, RepeatedSlotMustAgree) {
+        WSEML pattern = aa({{WSEML("a"), ph1}, {WSEML("b"), ph1}});
+        expectSameAsMatchAndSubstitute(aa({{WSEML("a"), WSEML("1")}, {WSEML("b"), WSEML("1")}}), pattern);
+        expectSameAsMatchAndSubstitute(aa({{WSEML("a"), WSEML("1")}, {WSEML("b"), WSEML("2")}}), pattern);
+        EXPECT_EQ(PatternMatcher(pattern).match(aa({{WSEML("a"), WSEML("1")}, {WSEML("b"), WSEML("2")}})), NULLOBJ);
+    }
+
+    TEST_F(PatternMatcherTest, AnonymousAndMissingKeys) {
+        WSEML storage = aa({{WSEML("a"), WSEML("1")}});
+        expectSameAsMatchAndSubstitute(storage, aa({{WSEML("a"), ANPLACEHOLDER}, {WSEML("missing"), ph1}}));
+        expectSameAsMatchAndSubstitute(storage, aa({{WSEML("missing"), WSEML("x")}}));
+    }
+
+    TEST_F(PatternMatcherTest, NestedLists) {
+        WSEML storage = aa({{WSEML("point"), list({{"x", WSEML("1")}, {"y", WSEML("2")}}, "POINT")}});
+        expectSameAsMatchAndSubstitute(storage, aa({{WSEML("point"), list({{"x", ph1}, {"y", ph2}}, "POINT")}}));
+        expectSameAsMatchAndSubstitute(storage, aa({{WSEML("point"), list({{"x", ph1}, {"y", WSEML("3")}}, "POINT")}}));
+        expectSameAsMatchAndSubstitute(storage, aa({{WSEML("point"), list({{"x", ph1}}, "POINT")}}));
+        expectSameAsMatchAndSubstitute(storage, aa({{WSEML("point"), list({{"x", ph1}, {"y", ph2}}, "OTHER")}}));
+        expectSameAsMatchAndSubstitute(storage, aa({{WSEML("point"), list({{"x", ph1}, {"y", ph1}})}}));
+    }
+
+    TEST_F(PatternMatcherTest, ShadowedEntriesAreSubstituted) {
+        WSEML storage = aa({{WSEML("a"), WSEML("1")}, {WSEML("b"), WSEML("2")}});
+        WSEML pattern = aa({{WSEML("a"), ph2}});
+        WSEML upper = createBlock();
+        addKeyValueAssociationToBlock(upper, WSEML("a"), ph1);
+        addKeyValueAssociationToBlock(upper, WSEML("b"), ph2);
+        appendBlock(pattern, upper);
+        expectSameAsMatchAndSubstitute(storage, pattern);
+    }
+
+    TEST_F(PatternMatcherTest, FallsBackForUncompiledCases) {
+        WSEML nestedPattern = aa({{WSEML("street"), ph1}});
+        WSEML pattern = aa({{WSEML("address"), nestedPattern}});
+        EXPECT_TRUE(PatternMatcher(pattern).alwaysFallsBack());
+        expectSameAsMatchAndSubstitute(aa({{WSEML("address"), aa({{WSEML("street"), WSEML("Main")}})}}), pattern);
+
+        WSEML storageWithPlaceholder = aa({{WSEML("a"), ph2}});
+        expectSameAsMatchAndSubstitute(storageWithPlaceholder, aa({{WSEML("a"), ph1}}));
+        expectSameAsMatchAndSubstitute(storageWithPlaceholder, aa({{WSEML("a"), WSEML("1")}}));
+
+        WSEML storageWithFunction = createAssociativeArray();
+        addFunctionalAssociationToAA(storageWithFunction, createFunctionalAssociation(testType1, createFunctionReference("libtest_func.so", "add_prefix")));
+        expectSameAsMatchAndSubstitute(storageWithFunction, aa({{WSEML("k", testType1), ph1}}));
+    }
+
+    TEST_F(PatternMatcherTest, RejectsNonAA) {
+        EXPECT_THROW(PatternMatcher(WSEML("x")), std::runtime_error);
+        PatternMatcher matcher(aa({{WSEML("a"), ph1}}));
+        EXPECT_THROW(matcher.match(WSEML("x")), std::runtime_error);
+    }
+
+    TEST_F(PatternMatcherTest, MatchAllReturnsResultsInInputOrder) {
+        WSEML pattern = aa({{WSEML("a"), ph1}, {WSEML("b"), WSEML("even")}});
+        std::vector<WSEML> storages;
+        for (int i = 0; i < 100; i++) {
+            storages.push_back(aa({{WSEML("a"), WSEML(std::to_string(i))}, {WSEML("b"), WSEML(i % 2 == 0 ? "even" : "odd")}}));
+        }
+        ThreadPool pool(4);
+        std::vector<WSEML> results = matchAll(pattern, storages, pool);
+        ASSERT_EQ(results.size(), storages.size());
+        for (std::size_t i = 0; i < storages.size(); i++) {
+            EXPECT_EQ(results[i], matchAndSubstitute(storages[i], pattern));
+        }
+        EXPECT_TRUE(matchAll(pattern, {}, pool).empty());
+    }
+
+    TEST_F(PatternMatcherTest, MatchAllStreamsEveryResultOnce) {
+        WSEML pattern = aa({{WSEML("a"), ph1}});
+        std::vector<WSEML> storages;
+        for (int i = 0; i < 50; i++) {
+            storages.push_back(aa({{WSEML("a"), WSEML(std::to_string(i))}}));
+        }
+        ThreadPool pool(3);
+        std::vector<int> deliveries(storages.size(), 0);
+        matchAll(pattern, storages, pool, [&](std::size_t index, WSEML result) {
+            deliveries[index]++;
+            EXPECT_EQ(result, aa({{WSEML("a"), WSEML(std::to_string(index))}}));
+        });
+        EXPECT_EQ(deliveries, std::vector<int>(storages.size(), 1));
+    }
+
+    TEST_F(PatternMatcherTest, MovedMatcherKeepsItsCompiledPattern) {
+        WSEML storage = aa({{WSEML("point"), list({{"x", WSEML("1")}, {"y", WSEML("2")}}, "POINT")}, {WSEML("name"), WSEML("p")}});
+        WSEML pattern = aa({{WSEML("point"), list({{"x", ph1}, {"y", ph2}}, "POINT")}, {WSEML("name"), ph1}});
+        WSEML expected = matchAndSubstitute(storage, pattern);
+
+        auto source = std::make_unique<PatternMatcher>(pattern);
+        PatternMatcher moved(std::move(*source));
+        source.reset();
+        EXPECT_EQ(moved.match(storage), expected);
+
+        PatternMatcher assigned(aa({{WSEML("other"), ph1}}));
+        assigned = std::move(moved);
+        EXPECT_EQ(assigned.match(storage), expected);
+        EXPECT_EQ(assigned.getSlotCount(), 2);
+    }
+
+    TEST_F(PatternMatcherTest, MatchAllPropagatesErrors) {
+        std::vector<WSEML> storages = {aa({{WSEML("a"), WSEML("1")}}), WSEML("not an AA")};
+        ThreadPool pool(2);
+        EXPECT_THROW(matchAll(aa({{WSEML("a"), ph1}}), storages, pool), std::runtime_error);
+        EXPECT_THROW(matchAll(WSEML("x"), storages, pool), std::runtime_error);
+    }
+} // namespace wseml
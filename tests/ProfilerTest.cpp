@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "../include/WSEML.hpp"
+#include "../include/executor.hpp"
+#include "../include/profiler.hpp"
+
+namespace wseml {
+    class ProfilerTest: public ::testing::Test {
+    protected:
+        static WSEML instruction(const std::string& opcode) {
+            WSEML instr = WSEML(std::list<Pair>());
+            instr.append(WSEML(opcode), WSEML("type"));
+            instr.append(WSEML("payload"), WSEML("R"));
+            return instr;
+        }
+
+        static WSEML program(std::initializer_list<const char*> opcodes) {
+            WSEML prog = WSEML(std::list<Pair>());
+            for (const char* opcode : opcodes) {
+                prog.append(instruction(opcode));
+            }
+            return prog;
+        }
+    };
+
+    TEST_F(ProfilerTest, InactiveByDefault) {
+        ASSERT_EQ(getActiveProfiler(), nullptr);
+        WSEML prog = program({"+", "-"});
+        executeSequential(prog, NULLOBJ);
+        ASSERT_EQ(getActiveProfiler(), nullptr);
+    }
+
+    TEST_F(ProfilerTest, ScopeInstallsAndRestores) {
+        Profiler outer;
+        Profiler inner;
+        {
+            ProfilerScope outerScope(outer);
+            ASSERT_EQ(getActiveProfiler(), &outer);
+            {
+                ProfilerScope innerScope(inner);
+                ASSERT_EQ(getActiveProfiler(), &inner);
+            }
+            ASSERT_EQ(getActiveProfiler(), &outer);
+        }
+        ASSERT_EQ(getActiveProfiler(), nullptr);
+    }
+
+    TEST_F(ProfilerTest, CountsPerOpcodeAndInstruction) {
+        WSEML container = WSEML(std::list<Pair>());
+        container.append(program({"+", "+", "-"}), WSEML("prog"));
+        const WSEML& prog = container.getList().find("prog");
+
+        Profiler profiler;
+        {
+            ProfilerScope scope(profiler);
+            executeSequential(prog, NULLOBJ);
+            executeSequential(prog, NULLOBJ);
+        }
+
+        const auto& opcodes = profiler.getOpcodeStats();
+        ASSERT_EQ(opcodes.size(), 2);
+        EXPECT_EQ(opcodes.at("+").count, 4);
+        EXPECT_EQ(opcodes.at("-").count, 2);
+        EXPECT_GE(opcodes.at("+").totalTime, opcodes.at("+").maxTime);
+
+        const auto& instructions = profiler.getInstructionStats();
+        ASSERT_EQ(instructions.size(), 3);
+        EXPECT_EQ(instructions.at({"prog", "1"}).count, 2);
+        EXPECT_EQ(instructions.at({"prog", "3"}).count, 2);
+        EXPECT_EQ(instructions.at({"prog", "5"}).count, 2);
+
+        const auto& stacks = profiler.getStackStats();
+        EXPECT_TRUE(stacks.contains("prog;1:+"));
+        EXPECT_TRUE(stacks.contains("prog;5:-"));
+    }
+
+    TEST_F(ProfilerTest, NestedInstructionsReportSelfTime) {
+        Profiler profiler;
+        {
+            ProfilerScope scope(profiler);
+            ProgramFrame outerFrame(std::string("outer"));
+            InstructionTimer outerTimer("C", WSEML("1"));
+            {
+                ProgramFrame innerFrame(std::string("inner"));
+                InstructionTimer innerTimer("+", WSEML("7"));
+                WSEML allocated = WSEML("allocated");
+            }
+        }
+
+        const auto& stacks = profiler.getStackStats();
+        ASSERT_TRUE(stacks.contains("outer;1:C"));
+        ASSERT_TRUE(stacks.contains("outer;1:C;inner;7:+"));
+        EXPECT_EQ(stacks.at("outer;1:C;inner;7:+").allocations, 1);
+
+        const auto& opcodes = profiler.getOpcodeStats();
+        EXPECT_GE(opcodes.at("C").totalTime, opcodes.at("+").totalTime);
+        EXPECT_LE(stacks.at("outer;1:C").totalTime, opcodes.at("C").totalTime);
+    }
+
+    TEST_F(ProfilerTest, ExportsWSEMLAndCollapsedStacks) {
+        Profiler profiler;
+        {
+            ProfilerScope scope(profiler);
+            ProgramFrame frame(std::string("main"));
+            InstructionTimer timer("S", WSEML("3"));
+        }
+
+        WSEML report = profiler.toWSEML();
+        const WSEML& opcodes = report.getList().find("opcodes");
+        ASSERT_NE(opcodes, NULLOBJ);
+        const WSEML& setType = opcodes.getList().find("S");
+        ASSERT_NE(setType, NULLOBJ);
+        EXPECT_EQ(setType.getList().find("count"), WSEML("1"));
+
+        const WSEML& instructions = report.getList().find("instructions");
+        ASSERT_EQ(instructions.getInnerList().size(), 1);
+        const WSEML& entry = instructions.getList().front();
+        EXPECT_EQ(entry.getList().find("program"), WSEML("main"));
+        EXPECT_EQ(entry.getList().find("index"), WSEML("3"));
+
+        std::istringstream collapsed(profiler.toCollapsedStacks());
+        std::string stack;
+        long long selfTime = -1;
+        collapsed >> stack >> selfTime;
+        EXPECT_EQ(stack, "main;3:S");
+        EXPECT_GE(selfTime, 0);
+
+        profiler.reset();
+        EXPECT_TRUE(profiler.getOpcodeStats().empty());
+        EXPECT_TRUE(profiler.toCollapsedStacks().empty());
+    }
+} // namespace wseml
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/substitutionTemplate.hpp"
+
+namespace wseml {
+    class SubstitutionTemplateTest: public ::testing::Test {
+    protected:
+        WSEML ph1 = createPlaceholder("ph1");
+        WSEML ph2 = createPlaceholder("ph2");
+
+        static WSEML aa(std::initializer_list<std::pair<WSEML, WSEML>> entries) {
+            WSEML result = createAssociativeArray();
+            for (const auto& [key, value] : entries) {
+                addKeyValueAssociationToAA(result, key, value);
+            }
+            return result;
+        }
+
+        static WSEML list(std::initializer_list<std::pair<std::string, WSEML>> entries, const std::string& type = "") {
+            WSEML result = WSEML(std::list<Pair>());
+            for (const auto& [key, value] : entries) {
+                result.append(value, WSEML(key));
+            }
+            if (not type.empty()) {
+                result.setSemanticType(WSEML(type));
+            }
+            return result;
+        }
+
+        static void expectSameAsSubstitutePlaceholders(const WSEML& templateObj, const WSEML& bindings) {
+            SubstitutionTemplate compiled(templateObj);
+            EXPECT_EQ(compiled.substitute(bindings), substitutePlaceholders(bindings, templateObj)) << "template: " << templateObj
+                                                                                                     << "\nbindings: " << bindings;
+        }
+    };
+
+    TEST_F(SubstitutionTemplateTest, MatchesSubstitutePlaceholders) {
+        WSEML ground = list({{"a", WSEML("1")}, {"b", list({{"c", WSEML("2")}})}}, "GROUND");
+        WSEML templateObj = list({{"x", ph1}, {"ground", ground}, {"y", list({{"z", ph2}, {"w", ph1}}, "INNER")}}, "OUTER");
+        WSEML bindings = aa({{ph1, WSEML("v1")}, {ph2, list({{"k", WSEML("v2")}})}});
+
+        expectSameAsSubstitutePlaceholders(templateObj, bindings);
+        expectSameAsSubstitutePlaceholders(templateObj, aa({{ph1, WSEML("v1")}}));
+        expectSameAsSubstitutePlaceholders(templateObj, NULLOBJ);
+        expectSameAsSubstitutePlaceholders(ph1, bindings);
+        expectSameAsSubstitutePlaceholders(ground, bindings);
+        expectSameAsSubstitutePlaceholders(aa({{WSEML("key"), ph1}, {ph2, ANPLACEHOLDER}}), bindings);
+    }
+
+    TEST_F(SubstitutionTemplateTest, BoundValuesAreSubstitutedRecursively) {
+        WSEML templateObj = list({{"x", ph1}});
+        expectSameAsSubstitutePlaceholders(templateObj, aa({{ph1, list({{"inner", ph2}})}, {ph2, WSEML("v2")}}));
+    }
+
+    TEST_F(SubstitutionTemplateTest, RecordsHoles) {
+        SubstitutionTemplate compiled(list({{"x", ph1}, {"y", ph2}, {"z", ph1}, {"w", WSEML("ground")}}));
+        EXPECT_EQ(compiled.getHoleCount(), 2);
+        ASSERT_TRUE(compiled.findHole(ph2).has_value());
+        EXPECT_EQ(compiled.getHole(*compiled.findHole(ph2)), ph2);
+        EXPECT_FALSE(compiled.findHole(createPlaceholder("ph3")).has_value());
+
+        WSEML value = WSEML("v");
+        std::vector<const WSEML*> values(compiled.getHoleCount(), nullptr);
+        values[*compiled.findHole(ph1)] = &value;
+        EXPECT_EQ(compiled.instantiate(values), list({{"x", value}, {"y", ph2}, {"z", value}, {"w", WSEML("ground")}}));
+        EXPECT_THROW(compiled.instantiate({}), std::runtime_error);
+    }
+
+    TEST_F(SubstitutionTemplateTest, SurvivesMoves) {
+        SubstitutionTemplate compiled(ph1);
+        SubstitutionTemplate moved = std::move(compiled);
+        EXPECT_EQ(moved.substitute(aa({{ph1, WSEML("v")}})), WSEML("v"));
+        EXPECT_EQ(moved.substitute(NULLOBJ), ph1);
+    }
+
+    TEST_F(SubstitutionTemplateTest, RejectsInvalidBindings) {
+        SubstitutionTemplate compiled(ph1);
+        EXPECT_THROW(compiled.substitute(WSEML("x")), std::runtime_error);
+        EXPECT_THROW(compiled.substitute(aa({{WSEML("notPlaceholder"), WSEML("v")}})), std::runtime_error);
+    }
+} // namespace wseml
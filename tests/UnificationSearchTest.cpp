@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <unordered_set>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/unificationSearch.hpp"
+
+namespace wseml {
+    class UnificationSearchTest: public ::testing::Test {
+    protected:
+        WSEML k1 = createPlaceholder("k1");
+        WSEML k2 = createPlaceholder("k2");
+        WSEML x = createPlaceholder("x");
+
+        static WSEML aa(std::initializer_list<std::pair<WSEML, WSEML>> entries) {
+            WSEML result = createAssociativeArray();
+            for (const auto& [key, value] : entries) {
+                addKeyValueAssociationToAA(result, key, value);
+            }
+            return result;
+        }
+    };
+
+    TEST_F(UnificationSearchTest, GroundKeysHaveTheUnifyResultOnly) {
+        WSEML storage = aa({{WSEML("a"), WSEML("1")}, {WSEML("b"), WSEML("2")}});
+        WSEML pattern = aa({{WSEML("a"), x}});
+        auto unifiers = unifyAll(storage, pattern);
+        ASSERT_EQ(unifiers.size(), 1);
+        EXPECT_EQ(unifiers[0], unify(storage, pattern));
+
+        EXPECT_TRUE(unifyAll(storage, aa({{WSEML("a"), WSEML("3")}})).empty());
+        EXPECT_THROW(unifyAll(storage, WSEML("a")), std::runtime_error);
+    }
+
+    TEST_F(UnificationSearchTest, PlaceholderKeyMatchesEveryCompatibleEntry) {
+        WSEML storage = aa({{WSEML("a"), WSEML("v")}, {WSEML("b"), WSEML("w")}, {WSEML("c"), WSEML("v")}});
+        WSEML pattern = aa({{k1, WSEML("v")}});
+        auto unifiers = unifyAll(storage, pattern);
+        ASSERT_EQ(unifiers.size(), 3);
+        EXPECT_EQ(unifiers[0].first, storage);
+        EXPECT_EQ(unifiers[1].first, storage);
+        std::unordered_set<WSEML> boundKeys = {findValueInAA(unifiers[0].second, k1), findValueInAA(unifiers[1].second, k1)};
+        EXPECT_EQ(boundKeys, (std::unordered_set<WSEML>{WSEML("a"), WSEML("c")}));
+        EXPECT_EQ(unifiers[2], unify(storage, pattern));
+    }
+
+    TEST_F(UnificationSearchTest, FreeEntriesMatchDistinctEntriesConsistently) {
+        WSEML storage = aa({{WSEML("a"), WSEML("1")}, {WSEML("b"), WSEML("1")}, {WSEML("c"), WSEML("2")}});
+        WSEML pattern = aa({{k1, x}, {k2, x}});
+        auto unifiers = unifyAll(storage, pattern);
+        std::size_t complete = 0;
+        for (const auto& [unified, bindings] : unifiers) {
+            WSEML first = findValueInAA(bindings, k1);
+            WSEML second = findValueInAA(bindings, k2);
+            if (first != NULLOBJ and second != NULLOBJ) {
+                complete++;
+                EXPECT_NE(first, second);
+                EXPECT_EQ(findValueInAA(storage, first), findValueInAA(storage, second));
+            }
+        }
+        /* (a, b) and (b, a) */
+        EXPECT_EQ(complete, 2);
+        EXPECT_EQ(unifiers.back(), unify(storage, pattern));
+    }
+
+    TEST_F(UnificationSearchTest, LimitAndTimeoutBoundTheSearch) {
+        WSEML storage = aa({{WSEML("a"), WSEML("1")}, {WSEML("b"), WSEML("1")}, {WSEML("c"), WSEML("1")}});
+        WSEML pattern = aa({{k1, x}, {k2, x}});
+        EXPECT_EQ(unifyAll(storage, pattern, {.limit = 2}).size(), 2);
+
+        UnificationSearch search(storage, pattern, {.timeout = std::chrono::nanoseconds(1)});
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        EXPECT_FALSE(search.next().has_value());
+        EXPECT_TRUE(search.timedOut());
+        EXPECT_EQ(search.getSolutionCount(), 0);
+    }
+} // namespace wseml
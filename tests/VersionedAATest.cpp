@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/versionedAA.hpp"
+
+namespace wseml {
+    class VersionedAATest: public ::testing::Test {
+    protected:
+        static WSEML S(const std::string& str) {
+            return WSEML(str);
+        }
+
+        static WSEML makeAA(const std::string& value) {
+            WSEML aa = createAssociativeArray();
+            addKeyValueAssociationToAA(aa, S("a"), S(value));
+            addKeyValueAssociationToAA(aa, S("b"), S(value));
+            return aa;
+        }
+    };
+
+    TEST_F(VersionedAATest, ReadersKeepTheirVersion) {
+        VersionedAA versioned(makeAA("0"));
+        VersionedAA::ReadGuard before = versioned.read();
+        ASSERT_EQ(before.getVersion(), 0);
+
+        versioned.update([](WSEML& aa) {
+            appendBlock(aa, createBlock());
+            addKeyValueAssociationToAA(aa, S("a"), S("1"));
+        });
+        ASSERT_EQ(versioned.getVersion(), 1);
+        ASSERT_EQ(*findValuePtrInAA(*before, S("a")), S("0"));
+        {
+            VersionedAA::ReadGuard after = versioned.read();
+            ASSERT_EQ(after.getVersion(), 1);
+            ASSERT_EQ(findValueInAA(after.get(), S("a")), S("1"));
+        }
+
+        /* the first version is pinned by the guard taken before the update */
+        ASSERT_EQ(versioned.getRetiredCount(), 1);
+        ASSERT_EQ(versioned.reclaim(), 0);
+        { VersionedAA::ReadGuard released = std::move(before); }
+        ASSERT_EQ(versioned.reclaim(), 1);
+        ASSERT_EQ(versioned.getRetiredCount(), 0);
+    }
+
+    TEST_F(VersionedAATest, PublishValidatesVersions) {
+        ASSERT_THROW(VersionedAA(S("not an aa")), std::runtime_error);
+        VersionedAA versioned(makeAA("0"));
+        ASSERT_THROW(versioned.publish(S("not an aa")), std::runtime_error);
+        ASSERT_THROW(versioned.update([](WSEML& aa) { aa = S("not an aa"); }), std::runtime_error);
+        ASSERT_EQ(versioned.getVersion(), 0);
+
+        versioned.publish(makeAA("1"));
+        ASSERT_EQ(versioned.getRetiredCount(), 0);
+        ASSERT_EQ(*findValuePtrInAA(versioned.read().get(), S("b")), S("1"));
+    }
+
+    TEST_F(VersionedAATest, ConcurrentReadersSeeConsistentVersions) {
+        VersionedAA versioned(makeAA("0"), 4);
+        std::atomic<bool> stop = false;
+        std::atomic<int> torn = 0;
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 8; t++) {
+            readers.emplace_back([&]() {
+                while (not stop) {
+                    VersionedAA::ReadGuard guard = versioned.read();
+                    if (*findValuePtrInAA(*guard, S("a")) != *findValuePtrInAA(*guard, S("b"))) {
+                        torn++;
+                    }
+                }
+            });
+        }
+        for (int i = 1; i <= 100; i++) {
+            versioned.update([i](WSEML& aa) {
+                appendBlock(aa, createBlock());
+                addKeyValueAssociationToAA(aa, S("a"), S(std::to_string(i)));
+                addKeyValueAssociationToAA(aa, S("b"), S(std::to_string(i)));
+            });
+        }
+        stop = true;
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        ASSERT_EQ(torn, 0);
+        versioned.reclaim();
+        ASSERT_EQ(versioned.getRetiredCount(), 0);
+        ASSERT_EQ(versioned.getVersion(), 100);
+    }
+
+} // namespace wseml
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "../include/WSEML.hpp"
+#include "../include/associativeArray.hpp"
+#include "../include/parser.hpp"
+
+namespace wseml {
+    class WSEMLTest: public ::testing::Test {
+    protected:
+        /* far deeper than the call stack allows for a recursive traversal */
+        static constexpr std::size_t DEEP = 100000;
+
+        static WSEML makeChain(std::size_t depth, const WSEML& leaf) {
+            WSEML chain = leaf;
+            for (std::size_t i = 0; i < depth; i++) {
+                WSEML link = WSEML(std::list<Pair>());
+                link.append(std::move(chain), WSEML("next"));
+                chain = std::move(link);
+            }
+            return chain;
+        }
+
+        static const WSEML& innermost(const WSEML& chain) {
+            const WSEML* node = &chain;
+            while (node->structureTypeInfo() == StructureType::List) {
+                const Pair& pair = node->getInnerList().front();
+                EXPECT_EQ(pair.getListOwner(), node);
+                EXPECT_EQ(pair.getData().getContainingPair(), &pair);
+                node = &pair.getData();
+            }
+            return *node;
+        }
+    };
+
+    TEST_F(WSEMLTest, DeepChainTraversals) {
+        WSEML chain = makeChain(DEEP, createPlaceholder("X"));
+        WSEML copy = chain;
+        ASSERT_EQ(innermost(copy), createPlaceholder("X"));
+        ASSERT_TRUE(equal(chain, copy));
+        ASSERT_EQ(hash_value(chain), hash_value(copy));
+
+        WSEML different = makeChain(DEEP, createPlaceholder("Y"));
+        ASSERT_FALSE(equal(chain, different));
+        ASSERT_NE(hash_value(chain), hash_value(different));
+
+        std::string packed = pack(chain);
+        std::string link = "{next:}";
+        ASSERT_EQ(packed.size(), (DEEP - 1) * link.size() + pack(makeChain(1, createPlaceholder("X"))).size());
+
+        WSEML bindings = createAssociativeArray();
+        addKeyValueAssociationToAA(bindings, createPlaceholder("X"), WSEML("bound"));
+        WSEML substituted = substitutePlaceholders(bindings, chain);
+        ASSERT_EQ(innermost(substituted), WSEML("bound"));
+        ASSERT_TRUE(equal(substituted, makeChain(DEEP, WSEML("bound"))));
+    }
+
+    TEST_F(WSEMLTest, MovesKeepLinksOfNestedObjects) {
+        WSEML inner = parse("{a:{b:c}}");
+        WSEML outer = WSEML(std::list<Pair>());
+        outer.append(std::move(inner), WSEML("x"));
+        WSEML moved = std::move(outer);
+
+        const Pair& x = moved.getInnerList().front();
+        const WSEML& a = x.getData();
+        const Pair& b = a.getInnerList().front().getData().getInnerList().front();
+        ASSERT_EQ(x.getListOwner(), &moved);
+        ASSERT_EQ(a.getInnerList().front().getListOwner(), &a);
+        ASSERT_EQ(b.getData().getContainingPair(), &b);
+        ASSERT_EQ(b.getData(), WSEML("c"));
+    }
+
+    TEST_F(WSEMLTest, PairsKeepRolesOnlyWhileSet) {
+        WSEML list = parse("{a:b, r[k]:v}");
+        Pair& plain = list.getInnerList().front();
+        Pair& withRole = list.getInnerList().back();
+        ASSERT_FALSE(plain.hasRoles());
+        ASSERT_EQ(plain.getKeyRole(), NULLOBJ);
+        ASSERT_TRUE(withRole.hasRoles());
+        ASSERT_EQ(withRole.getKeyRole(), WSEML("r"));
+        ASSERT_EQ(withRole.getKeyRole().getContainingPair(), &withRole);
+
+        WSEML copy = list;
+        const Pair& copiedRole = copy.getInnerList().back();
+        ASSERT_EQ(copiedRole.getKeyRole(), WSEML("r"));
+        ASSERT_EQ(copiedRole.getKeyRole().getContainingPair(), &copiedRole);
+        ASSERT_FALSE(copy.getInnerList().front().hasRoles());
+
+        plain.setDataRole(WSEML("d"));
+        ASSERT_TRUE(plain.hasRoles());
+        ASSERT_EQ(plain.getDataRole().getContainingPair(), &plain);
+        ASSERT_EQ(pack(list), "{a:d[b]$, r[k]:v}");
+        withRole.setKeyRole(NULLOBJ);
+        ASSERT_FALSE(withRole.hasRoles());
+        ASSERT_NE(list, copy);
+    }
+
+    TEST_F(WSEMLTest, ShortStringsLiveInTheHandle) {
+        std::size_t allocations = getObjectAllocationCount();
+        WSEML list = parse("{k:1234567, long:12345678}");
+        /* the List and the ByteString of the 8-byte string, copied once into its pair */
+        ASSERT_EQ(getObjectAllocationCount() - allocations, 3u);
+
+        Pair& pair = list.getInnerList().front();
+        ASSERT_TRUE(pair.getKey().isInline());
+        ASSERT_TRUE(pair.getData().isInline());
+        ASSERT_FALSE(list.getInnerList().back().getData().isInline());
+        ASSERT_EQ(pair.getData().getContainingPair(), &pair);
+        ASSERT_EQ(pair.getKey().getContainingList(), &list);
+        ASSERT_EQ(pair.getData().getSemanticType(), NULLOBJ);
+
+        WSEML copy = list;
+        const Pair& copied = copy.getInnerList().front();
+        ASSERT_TRUE(copied.getData().isInline());
+        ASSERT_EQ(copied.getData().getContainingPair(), &copied);
+        ASSERT_EQ(hash_value(copy), hash_value(list));
+
+        /* asking for the object promotes the string in place, linked to its pair */
+        WSEML& data = pair.getData();
+        std::size_t promoted = getObjectAllocationCount();
+        ASSERT_EQ(data.getByteString().get(), "1234567");
+        ASSERT_EQ(getObjectAllocationCount(), promoted + 1);
+        ASSERT_FALSE(data.isInline());
+        ASSERT_EQ(data.getRawObject()->getContainingPair(), &pair);
+        ASSERT_EQ(list, copy);
+        ASSERT_EQ(hash_value(list), hash_value(copy));
+
+        /* typing promotes too */
+        WSEML typed = WSEML("ab");
+        typed.setSemanticType(WSEML("t"));
+        ASSERT_FALSE(typed.isInline());
+        ASSERT_NE(typed, WSEML("ab"));
+
+        /* an assigned string keeps the link of the handle */
+        copy.getInnerList().front().getData() = WSEML("x");
+        ASSERT_EQ(copied.getData().getContainingPair(), &copied);
+        ASSERT_EQ(pack(copy), "{k:x, long:12345678}");
+
+        std::string buffer;
+        ASSERT_EQ(copied.getData().getStringView(buffer), "x");
+        ASSERT_TRUE(copied.getData().isInline());
+        ASSERT_THROW(list.getStringView(buffer), std::runtime_error);
+    }
+
+    TEST_F(WSEMLTest, PackWritesRolesAndTypes) {
+        for (const std::string text : {"{a:b, c:{d:e, f:$}}", "{k:r[x:y]t}", "{r[k]t:v, $:$}"}) {
+            ASSERT_EQ(pack(parse(text)), text);
+        }
+    }
+} // namespace wseml